@@ -0,0 +1,354 @@
+/*******************************************************************************************
+*
+*   WordGrid
+*   Simple Word Puzzle Game
+*   (C) Harald Scheirich 2024
+*   WordGrid is is licensed under an unmodified zlib/libpng license see LICENSE
+*
+*   Frame times of the whole game on a hidden window with scripted input
+*   usage: wordgrid_frame_bench [--frames n] [--seed n] [--csv file] [--json file] [--visible]
+*
+*   Runs the real frame loop from the logo through the title into move attack games, the
+*   ending and back to the title until the frames are done. A scripted player clicks the
+*   Move Attack button, drags tiles from the well onto free cells and confirms the ending
+*   with enter. Its input is fed as raylib automation events into the polled input state,
+*   the same path recorded sessions are played back on, so raygui and the input queue see
+*   it like a mouse. The seed makes the games repeat, the timings are wall clock seconds of
+*   the main thread for the update, the draw and EndDrawing() of every frame.
+*
+*   The game keeps its save and the high scores in the working directory, the bench runs in
+*   a temporary directory with a copy of the resources so the player's files stay untouched
+*
+*   The window still needs a display, on a machine without one run it under xvfb-run
+*
+********************************************************************************************/
+
+#include "raylib.h"
+#include "game_app.h"
+#include "screens.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <string>
+#include <system_error>
+#include <vector>
+
+// Values of AutomationEventType, raylib keeps the enum inside rcore.c
+static const unsigned int EVENT_KEY_UP = 1;
+static const unsigned int EVENT_KEY_DOWN = 2;
+static const unsigned int EVENT_MOUSE_BUTTON_UP = 5;
+static const unsigned int EVENT_MOUSE_BUTTON_DOWN = 6;
+static const unsigned int EVENT_MOUSE_POSITION = 7;
+
+// Same places as draw_title_screen() and the layout of the gameplay screen, in design units
+static const float TILE_SIZE = 69.0f;
+static const Vector2 BOARD_POS = { 20, 20 };
+static const Vector2 WELL_POS = { 400, 20 };
+
+static const int SETTLE_FRAMES = 45;    // A fade between two screens takes 40 frames
+static const int MOVE_FRAMES = 12;      // From pressing a tile to dropping it
+static const int AFTER_MOVE_FRAMES = 20;
+
+static const char* _screen_names[] = { "logo", "title", "options", "gameplay", "ending" };
+
+struct FrameSample {
+    int screen;
+    FrameTiming timing;
+};
+
+struct Script {
+    GameScreen screen = UNKNOWN;
+    int wait = 0;
+    int step = 0;
+    int cell = 0;       // Next cell to try, walks the board so refused drops move on
+    int games = 0;
+    int moves = 0;
+};
+
+static void play(unsigned int type, int a, int b = 0)
+{
+    AutomationEvent event = { 0 };
+    event.type = type;
+    event.params[0] = a;
+    event.params[1] = b;
+    PlayAutomationEvent(event);
+}
+
+// Automation events are in window coordinates
+static void play_mouse(Vector2 design)
+{
+    float scale = screen_layout_current()->scale;
+    play(EVENT_MOUSE_POSITION, (int)(design.x * scale), (int)(design.y * scale));
+}
+
+static Vector2 tile_center(Vector2 origin, int x, int y)
+{
+    return Vector2{ origin.x + (x + 0.5f) * TILE_SIZE, origin.y + (y + 0.5f) * TILE_SIZE };
+}
+
+static bool script_gameplay(Script* script)
+{
+    int well = -1;
+    for (int i = 0; i < GAME_WELL_SIZE && well < 0; ++i) {
+        if (g_game.well[i] >= 0) well = i;
+    }
+    int cells = g_game.rows * g_game.columns;
+    int cell = -1;
+    for (int i = 0; i < cells && cell < 0; ++i) {
+        int candidate = (script->cell + i) % cells;
+        if (game_get_letter(&g_game, candidate / g_game.rows, candidate % g_game.rows) == GAME_EMPTY) cell = candidate;
+    }
+    if (well < 0 || cell < 0) return false;
+
+    if (script->step == 0) {
+        play_mouse(tile_center(WELL_POS, 0, well));
+        play(EVENT_MOUSE_BUTTON_DOWN, MOUSE_BUTTON_LEFT);
+    }
+    else if (script->step < MOVE_FRAMES) {
+        // Drags over a few frames, the tile follows the pointer
+        Vector2 from = tile_center(WELL_POS, 0, well);
+        Vector2 to = tile_center(BOARD_POS, cell / g_game.rows, cell % g_game.rows);
+        float t = (float)script->step / (float)(MOVE_FRAMES - 1);
+        play_mouse(Vector2{ from.x + (to.x - from.x) * t, from.y + (to.y - from.y) * t });
+    }
+    else {
+        play(EVENT_MOUSE_BUTTON_UP, MOUSE_BUTTON_LEFT);
+        script->cell = cell + 1;
+        script->moves++;
+        script->wait = AFTER_MOVE_FRAMES;
+        script->step = 0;
+        return true;
+    }
+    script->step++;
+    return true;
+}
+
+// Plays the input of the next frame
+static void script_frame(Script* script)
+{
+    if (g_currentScreen != script->screen) {
+        script->screen = g_currentScreen;
+        script->wait = SETTLE_FRAMES;
+        script->step = 0;
+    }
+    if (script->wait > 0) {
+        script->wait--;
+        return;
+    }
+
+    switch (g_currentScreen) {
+    case TITLE:
+    {
+        Vector2 size = screen_layout_size();
+        play_mouse(Vector2{ size.x / 6.0f * 3.0f, size.y / 2.0f + 30.0f });    // Move Attack
+        play(script->step == 0 ? EVENT_MOUSE_BUTTON_DOWN : EVENT_MOUSE_BUTTON_UP, MOUSE_BUTTON_LEFT);
+        script->step++;
+        if (script->step == 2) script->wait = SETTLE_FRAMES;
+        break;
+    }
+    case GAMEPLAY:
+        if (!script_gameplay(script)) script->wait = AFTER_MOVE_FRAMES;
+        break;
+    case ENDING:
+        play(script->step == 0 ? EVENT_KEY_DOWN : EVENT_KEY_UP, KEY_ENTER);
+        script->step++;
+        if (script->step == 2) {
+            script->games++;
+            script->wait = SETTLE_FRAMES;
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+struct Stats {
+    double mean;
+    double p50;
+    double p95;
+    double p99;
+    double max;
+};
+
+// Milliseconds
+static Stats stats(std::vector<double> values)
+{
+    Stats result = { 0 };
+    if (values.empty()) return result;
+    std::sort(values.begin(), values.end());
+    double sum = 0.0;
+    for (double value : values) sum += value;
+    auto at = [&](double fraction) { return 1e3 * values[(size_t)(fraction * (double)(values.size() - 1))]; };
+    result.mean = 1e3 * sum / (double)values.size();
+    result.p50 = at(0.5);
+    result.p95 = at(0.95);
+    result.p99 = at(0.99);
+    result.max = 1e3 * values.back();
+    return result;
+}
+
+static void print_stats(FILE* file, const char* name, const Stats& s, bool last)
+{
+    fprintf(file, "      \"%s\": { \"mean\": %.4f, \"p50\": %.4f, \"p95\": %.4f, \"p99\": %.4f, \"max\": %.4f }%s\n",
+        name, s.mean, s.p50, s.p95, s.p99, s.max, last ? "" : ",");
+}
+
+// All frames with `screen` -1
+static void report(FILE* json, const std::vector<FrameSample>& samples, int screen, const char* name, bool last)
+{
+    std::vector<double> parts[4];
+    for (const FrameSample& sample : samples) {
+        if (screen >= 0 && sample.screen != screen) continue;
+        parts[0].push_back(sample.timing.update);
+        parts[1].push_back(sample.timing.draw);
+        parts[2].push_back(sample.timing.present);
+        parts[3].push_back(sample.timing.update + sample.timing.draw + sample.timing.present);
+    }
+    if (parts[0].empty()) return;
+
+    Stats update = stats(parts[0]);
+    Stats draw = stats(parts[1]);
+    Stats present = stats(parts[2]);
+    Stats frame = stats(parts[3]);
+    printf("%-9s %7d  %8.3f %8.3f  %8.3f %8.3f  %8.3f %8.3f  %8.3f %8.3f\n", name, (int)parts[0].size(),
+        update.mean, update.p99, draw.mean, draw.p99, present.mean, present.p99, frame.mean, frame.p99);
+
+    if (json == nullptr) return;
+    fprintf(json, "    \"%s\": {\n      \"frames\": %d,\n", name, (int)parts[0].size());
+    print_stats(json, "update_ms", update, false);
+    print_stats(json, "draw_ms", draw, false);
+    print_stats(json, "present_ms", present, false);
+    print_stats(json, "frame_ms", frame, true);
+    fprintf(json, "    }%s\n", last ? "" : ",");
+}
+
+// Empty directory in the temp directory with the resources next to the executable copied into it
+static std::filesystem::path make_scratch_directory()
+{
+    std::error_code error;
+    std::filesystem::path resources = std::filesystem::path(GetApplicationDirectory()) / "resources";
+    long long stamp = (long long)std::chrono::steady_clock::now().time_since_epoch().count();
+    for (int i = 0; i < 100; ++i) {
+        std::filesystem::path path = std::filesystem::temp_directory_path(error) /
+            ("wordgrid_frame_bench_" + std::to_string(stamp + i));
+        if (error) return {};
+        if (!std::filesystem::create_directory(path, error)) {
+            if (error) return {};
+            continue;
+        }
+        std::filesystem::copy(resources, path / "resources", std::filesystem::copy_options::recursive, error);
+        if (error) {
+            printf("could not copy %s: %s\n", resources.string().c_str(), error.message().c_str());
+            std::filesystem::remove_all(path, error);
+            return {};
+        }
+        return path;
+    }
+    return {};
+}
+
+int main(int argc, char** argv)
+{
+    int frame_count = 5000;
+    unsigned int seed = 1;
+    const char* csv_file = nullptr;
+    const char* json_file = nullptr;
+    unsigned int flags = FLAG_WINDOW_HIDDEN;
+    for (int i = 1; i < argc; ++i) {
+        bool has_value = i + 1 < argc;
+        if (strcmp(argv[i], "--frames") == 0 && has_value) frame_count = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--seed") == 0 && has_value) seed = (unsigned int)atoi(argv[++i]);
+        else if (strcmp(argv[i], "--csv") == 0 && has_value) csv_file = argv[++i];
+        else if (strcmp(argv[i], "--json") == 0 && has_value) json_file = argv[++i];
+        else if (strcmp(argv[i], "--visible") == 0) flags = 0;
+        else {
+            printf("usage: wordgrid_frame_bench [--frames n] [--seed n] [--csv file] [--json file] [--visible]\n");
+            return 1;
+        }
+    }
+    if (frame_count < 1) frame_count = 1;
+
+    // The output files stay relative to where the bench was started
+    std::error_code error;
+    std::string csv_path = csv_file ? std::filesystem::absolute(csv_file, error).string() : std::string();
+    std::string json_path = json_file ? std::filesystem::absolute(json_file, error).string() : std::string();
+    if (csv_file != nullptr) csv_file = csv_path.c_str();
+    if (json_file != nullptr) json_file = json_path.c_str();
+
+    std::filesystem::path start_directory = std::filesystem::current_path(error);
+    std::filesystem::path scratch = make_scratch_directory();
+    if (scratch.empty()) {
+        printf("could not set up a temporary working directory\n");
+        return 1;
+    }
+    std::filesystem::current_path(scratch, error);
+
+    SetTraceLogLevel(LOG_WARNING);
+    // No frame limit and no vsync, the frames run back to back
+    game_app_init(flags);
+    if (!IsWindowReady()) {
+        printf("no window, a display is needed (xvfb-run on machines without one)\n");
+        std::filesystem::current_path(start_directory, error);
+        std::filesystem::remove_all(scratch, error);
+        return 1;
+    }
+    SetRandomSeed(seed);
+
+    std::vector<FrameSample> samples;
+    samples.reserve(frame_count);
+    Script script;
+    for (int frame = 0; frame < frame_count && !WindowShouldClose(); ++frame) {
+        script_frame(&script);
+        FrameSample sample = { g_currentScreen, { 0 } };
+        game_app_frame(&sample.timing);
+        samples.push_back(sample);
+    }
+
+    game_app_shutdown();
+    std::filesystem::current_path(start_directory, error);
+    std::filesystem::remove_all(scratch, error);
+
+    if (csv_file != nullptr) {
+        FILE* csv = fopen(csv_file, "w");
+        if (csv == nullptr) {
+            printf("could not write %s\n", csv_file);
+            return 1;
+        }
+        fprintf(csv, "frame,screen,update_ms,draw_ms,present_ms\n");
+        for (size_t i = 0; i < samples.size(); ++i) {
+            const FrameSample& sample = samples[i];
+            fprintf(csv, "%d,%s,%.4f,%.4f,%.4f\n", (int)i, _screen_names[sample.screen],
+                1e3 * sample.timing.update, 1e3 * sample.timing.draw, 1e3 * sample.timing.present);
+        }
+        fclose(csv);
+    }
+
+    FILE* json = nullptr;
+    if (json_file != nullptr) {
+        json = fopen(json_file, "w");
+        if (json == nullptr) {
+            printf("could not write %s\n", json_file);
+            return 1;
+        }
+        fprintf(json, "{\n  \"frames\": %d,\n  \"seed\": %u,\n  \"games\": %d,\n  \"moves\": %d,\n  \"screens\": {\n",
+            (int)samples.size(), seed, script.games, script.moves);
+    }
+
+    printf("%d frames, %d games, %d moves\n", (int)samples.size(), script.games, script.moves);
+    printf("%-9s %7s  %17s  %17s  %17s  %17s\n", "ms", "frames", "update mean p99", "draw mean p99", "present mean p99", "frame mean p99");
+    for (int screen = LOGO; screen <= ENDING; ++screen) {
+        report(json, samples, screen, _screen_names[screen], false);
+    }
+    report(json, samples, -1, "all", true);
+
+    if (json != nullptr) {
+        fprintf(json, "  }\n}\n");
+        fclose(json);
+    }
+    return 0;
+}
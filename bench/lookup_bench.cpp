@@ -0,0 +1,143 @@
+/*******************************************************************************************
+*
+*   WordGrid
+*   Simple Word Puzzle Game
+*   (C) Harald Scheirich 2024
+*   WordGrid is is licensed under an unmodified zlib/libpng license see LICENSE
+*
+*   Throughput of single dictionary lookups against word_set_contains()
+*   usage: wordgrid_lookup_bench [--dictionary file] [--candidates n] [--rounds n]
+*
+*   The candidates are the rows a solver would test, a quarter of them real words and
+*   the rest random letters. Both ways have to agree on every candidate
+*
+********************************************************************************************/
+
+#include "raylib.h"
+#include "dictionary.h"
+#include "word_set.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <chrono>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+static const int WORD_LENGTH = 5;
+static const int TRIALS = 5;
+
+static uint64_t _random_state = 0x2545F4914F6CDD1Dull;
+
+static uint32_t next_random()
+{
+    _random_state ^= _random_state << 13;
+    _random_state ^= _random_state >> 7;
+    _random_state ^= _random_state << 17;
+    return (uint32_t)(_random_state >> 32);
+}
+
+static double seconds_since(Clock::time_point start)
+{
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+int main(int argc, char** argv)
+{
+    const char* dictionary_file = "resources/text/en/words.txt";
+    int candidate_count = 4096;
+    int rounds = 200;
+    for (int i = 1; i < argc; ++i) {
+        bool has_value = i + 1 < argc;
+        if (strcmp(argv[i], "--dictionary") == 0 && has_value) dictionary_file = argv[++i];
+        else if (strcmp(argv[i], "--candidates") == 0 && has_value) candidate_count = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--rounds") == 0 && has_value) rounds = atoi(argv[++i]);
+        else {
+            printf("usage: wordgrid_lookup_bench [--dictionary file] [--candidates n] [--rounds n]\n");
+            return 1;
+        }
+    }
+    if (candidate_count < 1) candidate_count = 1;
+
+    SetTraceLogLevel(LOG_WARNING);
+    Dictionary dictionary = dictionary_load(dictionary_file);
+    if (dictionary.word_count == 0) return 1;
+    dictionary_build_index(&dictionary);
+
+    WordSet set;
+    word_set_build(&set, &dictionary);
+
+    // Offsets of the words that fill a row
+    std::vector<int> words;
+    for (int offset = 0, start = 0; offset < dictionary.words_size; ++offset) {
+        if (dictionary.words[offset] != 0) continue;
+        if (offset - start == WORD_LENGTH) words.push_back(start);
+        start = offset + 1;
+    }
+    if (words.empty()) {
+        printf("%s has no words of %d letters\n", dictionary_file, WORD_LENGTH);
+        return 1;
+    }
+
+    std::vector<int> letters(candidate_count * (WORD_LENGTH + 1), 0);
+    std::vector<uint32_t> keys(candidate_count);
+    for (int i = 0; i < candidate_count; ++i) {
+        int* word = &letters[i * (WORD_LENGTH + 1)];
+        int start = words[next_random() % words.size()];
+        bool real = next_random() % 4 == 0;
+        for (int j = 0; j < WORD_LENGTH; ++j) {
+            word[j] = real ? dictionary.words[start + j] : 1 + (int)(next_random() % dictionary.alphabet.count);
+        }
+        word_cache_pack(word, WORD_LENGTH + 1, &keys[i]);
+    }
+
+    std::vector<uint64_t> found((candidate_count + 63) / 64);
+    std::vector<uint64_t> expected((candidate_count + 63) / 64);
+    int hits = 0;
+
+    // Best of a few trials, a single one is easily disturbed by other processes
+    double single = 0.0;
+    double batch = 0.0;
+    for (int trial = 0; trial < TRIALS; ++trial) {
+        Clock::time_point start = Clock::now();
+        for (int round = 0; round < rounds; ++round) {
+            for (int i = 0; i < candidate_count; ++i) {
+                if (dictionary_exists(&dictionary, &letters[i * (WORD_LENGTH + 1)], WORD_LENGTH + 1)) {
+                    expected[i / 64] |= 1ull << (i % 64);
+                }
+            }
+        }
+        double seconds = seconds_since(start);
+        if (trial == 0 || seconds < single) single = seconds;
+
+        start = Clock::now();
+        for (int round = 0; round < rounds; ++round) {
+            hits = word_set_contains(&set, keys.data(), candidate_count, found.data());
+        }
+        seconds = seconds_since(start);
+        if (trial == 0 || seconds < batch) batch = seconds;
+    }
+
+    bool same = memcmp(found.data(), expected.data(), found.size() * sizeof(uint64_t)) == 0;
+    double lookups = (double)candidate_count * rounds;
+#if defined(WORD_SET_AVX2)
+    const char* path = "avx2";
+#elif defined(WORD_SET_SSE2)
+    const char* path = "sse2";
+#elif defined(WORD_SET_WASM)
+    const char* path = "wasm simd";
+#else
+    const char* path = "scalar";
+#endif
+    printf("dictionary  %d words, %d in the set\n", dictionary.word_count, set.word_count);
+    printf("candidates  %d, %d words\n", candidate_count, hits);
+    printf("single      %6.1f ns per lookup\n", 1e9 * single / lookups);
+    printf("batch       %6.1f ns per lookup (%s), %.1fx\n", 1e9 * batch / lookups, path, single / batch);
+    if (!same) printf("MISMATCH between single and batch lookups\n");
+
+    word_set_unload(&set);
+    dictionary_unload(&dictionary);
+    return same ? 0 : 1;
+}
@@ -0,0 +1,238 @@
+/*******************************************************************************************
+*
+*   WordGrid
+*   Simple Word Puzzle Game
+*   (C) Harald Scheirich 2024
+*   WordGrid is is licensed under an unmodified zlib/libpng license see LICENSE
+*
+*   Deterministic workload of the engine code, for timing and for training PGO builds
+*   usage: wordgrid_train_bench [--dictionary file] [--games n] [--trials n]
+*
+*   Loads the word list with all its indices, tests candidate rows against every lookup
+*   and plays scripted games: each move tries all moves of the well, keeps the one that
+*   makes the most words, updates the heatmap and hints and lets the computer opponent
+*   search now and then. The same seeds always play the same games, the checksum of the
+*   words made has to match between builds
+*
+********************************************************************************************/
+
+#include "raylib.h"
+#include "dictionary.h"
+#include "dictionary_snapshot.h"
+#include "game.h"
+#include "word_cache.h"
+#include "word_set.h"
+#include "anagram_index.h"
+#include "heatmap.h"
+#include "ai_search.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <chrono>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+static const int TRIALS = 3;
+static const int LOADS = 3;
+static const int CANDIDATES = 4096;
+static const int LOOKUP_ROUNDS = 20;
+static const int GAME_MOVES = 60;
+static const int SEARCH_EVERY = 4;      // Moves between searches of the computer opponent
+
+static uint64_t _random_state = 0x2545F4914F6CDD1Dull;
+
+static uint32_t next_random()
+{
+    _random_state ^= _random_state << 13;
+    _random_state ^= _random_state >> 7;
+    _random_state ^= _random_state << 17;
+    return (uint32_t)(_random_state >> 32);
+}
+
+static double seconds_since(Clock::time_point start)
+{
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+static DictionarySnapshot* load(const char* dictionary_file, const char* distribution_file, WordSet* set, PatternIndex* patterns)
+{
+    Dictionary dictionary = dictionary_load(dictionary_file);
+    dictionary_load_distribution(&dictionary, distribution_file);
+    DictionarySnapshot* snapshot = dictionary_snapshot_create(&dictionary);
+    word_set_build(set, &snapshot->dictionary);
+    pattern_index_build(patterns, &snapshot->dictionary);
+    return snapshot;
+}
+
+// Every lookup of the engine on rows a solver would test, a quarter of them words
+static int lookups(const Dictionary* dictionary, const WordSet* set)
+{
+    std::vector<int> words;
+    for (int offset = 0, start = 0; offset < dictionary->words_size; ++offset) {
+        if (dictionary->words[offset] != 0) continue;
+        if (offset - start == GAME_MAX_SIZE) words.push_back(start);
+        start = offset + 1;
+    }
+    if (words.empty()) return 0;
+
+    _random_state = 0x2545F4914F6CDD1Dull;
+    std::vector<int> letters(CANDIDATES * (GAME_MAX_SIZE + 1), 0);
+    std::vector<uint32_t> keys(CANDIDATES);
+    for (int i = 0; i < CANDIDATES; ++i) {
+        int* word = &letters[i * (GAME_MAX_SIZE + 1)];
+        int start = words[next_random() % words.size()];
+        bool real = next_random() % 4 == 0;
+        for (int j = 0; j < GAME_MAX_SIZE; ++j) {
+            word[j] = real ? dictionary->words[start + j] : 1 + (int)(next_random() % dictionary->alphabet.count);
+        }
+        word_cache_pack(word, GAME_MAX_SIZE + 1, &keys[i]);
+    }
+
+    int result = 0;
+    std::vector<uint64_t> found((CANDIDATES + 63) / 64);
+    WordCache* cache = word_cache_local();
+    for (int round = 0; round < LOOKUP_ROUNDS; ++round) {
+        for (int i = 0; i < CANDIDATES; ++i) {
+            const int* word = &letters[i * (GAME_MAX_SIZE + 1)];
+            result += dictionary_exists(dictionary, word, GAME_MAX_SIZE + 1) ? 1 : 0;
+            result += word_cache_exists(cache, dictionary, word, GAME_MAX_SIZE + 1) ? 1 : 0;
+        }
+        result += word_set_contains(set, keys.data(), CANDIDATES, found.data());
+    }
+    return result;
+}
+
+// Same as the hints of the game screen, every line against the well
+static int hint_words(const Game* game, const AnagramIndex* index)
+{
+    int result = 0;
+    int line[GAME_MAX_SIZE];
+    uint32_t used = 0;
+    for (int y = 0; y < game->rows; ++y) {
+        for (int x = 0; x < game->columns; ++x) line[x] = (game_get_letter(game, x, y) > 0) ? game_get_letter(game, x, y) : 0;
+        result += anagram_fill_line(index, line, game->columns, game->well, GAME_WELL_SIZE, &used);
+    }
+    for (int x = 0; x < game->columns; ++x) {
+        for (int y = 0; y < game->rows; ++y) line[y] = (game_get_letter(game, x, y) > 0) ? game_get_letter(game, x, y) : 0;
+        result += anagram_fill_line(index, line, game->rows, game->well, GAME_WELL_SIZE, &used);
+    }
+    return result;
+}
+
+static int play_game(uint64_t seed, const DictionarySnapshot* snapshot, Heatmap* heatmap, AiSearch* search)
+{
+    const Dictionary* dictionary = &snapshot->dictionary;
+    Game game;
+    game_init(&game, MODE_MOVEATTACK, GAME_MAX_SIZE, GAME_MAX_SIZE, seed, dictionary);
+    heatmap->valid = false;
+    int result = 0;
+
+    for (int move = 0; move < GAME_MOVES; ++move) {
+        heatmap_update(heatmap, &game, dictionary, ~0ull);
+        result += heatmap->max_cell;
+        heatmap_update(heatmap, &game, dictionary, heatmap_well_letters(&game));
+        result += heatmap->max_cell + hint_words(&game, &snapshot->anagrams);
+
+        uint8_t moves[AI_MAX_MOVES];
+        int count = ai_generate_moves(&game, moves);
+        if (count == 0) break;
+
+        // No deadline, the search always reaches its depth and plays the same move
+        int chosen = moves[game_random_int(&game, 0, count - 1)];
+        if (move % SEARCH_EVERY == 0) {
+            AiResult best;
+            search->seed = seed;
+            ai_search(search, &game, 2, 1e6, &best);
+            chosen = best.well_index * GAME_MAX_CELLS + best.x * game.rows + best.y;
+        }
+        else {
+            int most = 0;
+            for (int i = 0; i < count; ++i) {
+                Game child = game;
+                int before = child.word_count;
+                if (!game_play(&child, dictionary, ai_move_well(moves[i]), ai_move_cell(moves[i]) / game.rows, ai_move_cell(moves[i]) % game.rows, nullptr)) continue;
+                if (child.word_count - before > most) {
+                    most = child.word_count - before;
+                    chosen = moves[i];
+                }
+            }
+        }
+        game_play(&game, dictionary, ai_move_well(chosen), ai_move_cell(chosen) / game.rows, ai_move_cell(chosen) % game.rows, nullptr);
+    }
+    return result + game.word_count * 1000;
+}
+
+int main(int argc, char** argv)
+{
+    const char* dictionary_file = "resources/text/en/words.txt";
+    const char* distribution_file = "resources/text/en/distribution.txt";
+    int game_count = 40;
+    int trials = TRIALS;
+    for (int i = 1; i < argc; ++i) {
+        bool has_value = i + 1 < argc;
+        if (strcmp(argv[i], "--dictionary") == 0 && has_value) dictionary_file = argv[++i];
+        else if (strcmp(argv[i], "--games") == 0 && has_value) game_count = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--trials") == 0 && has_value) trials = atoi(argv[++i]);
+        else {
+            printf("usage: wordgrid_train_bench [--dictionary file] [--games n] [--trials n]\n");
+            return 1;
+        }
+    }
+    if (trials < 1) trials = 1;
+
+    SetTraceLogLevel(LOG_WARNING);
+
+    // Best of a few trials, the checksum is the same in all of them
+    double best[3] = { 0.0, 0.0, 0.0 };
+    int64_t checksum = 0;
+    int word_count = 0;
+    for (int trial = 0; trial < trials; ++trial) {
+        WordSet set;
+        PatternIndex patterns;
+        DictionarySnapshot* snapshot = nullptr;
+        Clock::time_point start = Clock::now();
+        for (int i = 0; i < LOADS; ++i) {
+            dictionary_snapshot_release(snapshot);
+            snapshot = load(dictionary_file, distribution_file, &set, &patterns);
+        }
+        double load_time = seconds_since(start);
+        word_count = snapshot->dictionary.word_count;
+        if (word_count == 0) return 1;
+
+        word_cache_clear(word_cache_local());
+        start = Clock::now();
+        int64_t sum = lookups(&snapshot->dictionary, &set);
+        double lookup_time = seconds_since(start);
+
+        Heatmap heatmap;
+        AiSearch search;
+        ai_search_init(&search, 1 << 16);
+        search.dictionary = &snapshot->dictionary;
+        start = Clock::now();
+        for (int i = 0; i < game_count; ++i) sum += play_game(1000 + i, snapshot, &heatmap, &search);
+        double game_time = seconds_since(start);
+
+        double times[3] = { load_time, lookup_time, game_time };
+        for (int i = 0; i < 3; ++i) {
+            if (trial == 0 || times[i] < best[i]) best[i] = times[i];
+        }
+        checksum = sum;
+
+        ai_search_unload(&search);
+        heatmap_unload(&heatmap);
+        pattern_index_unload(&patterns);
+        word_set_unload(&set);
+        dictionary_snapshot_release(snapshot);
+    }
+
+    printf("dictionary  %d words\n", word_count);
+    printf("load        %8.2f ms (%d times)\n", 1e3 * best[0], LOADS);
+    printf("lookups     %8.2f ms (%d candidates, %d rounds)\n", 1e3 * best[1], CANDIDATES, LOOKUP_ROUNDS);
+    printf("games       %8.2f ms (%d games)\n", 1e3 * best[2], game_count);
+    printf("total       %8.2f ms\n", 1e3 * (best[0] + best[1] + best[2]));
+    printf("checksum    %lld\n", (long long)checksum);
+    return 0;
+}
@@ -0,0 +1,158 @@
+# Release build of WordGrid with profile guided and link time optimization
+# usage: cmake [-DBUILD_DIR=dir] [-DGENERATOR=name] [-DGAMES=n] [-DFRAMES=n] -P cmake/PGOBuild.cmake
+#
+# 1. A plain release build in BUILD_DIR/base, the benches give the times before
+# 2. An instrumented build in BUILD_DIR/pgo, the benches record the profile
+# 3. The same directory is configured to use the profile with LTO and everything is built,
+#    GCC finds the profile of an object by its path so it can not move
+# 4. The benches of the optimized build give the times after, both runs of
+#    wordgrid_train_bench have to play the same games
+#
+# wordgrid_frame_bench plays the game with the objects the game links (wordgrid_game_objects),
+# so the profile of the game comes from it, with GCC as well as with Clang. It opens a window,
+# without a display it runs under xvfb-run. wordgrid_train_bench adds the engine workload of
+# its own objects, for Clang it also trains the engine functions the game inlines
+#
+# The optimized game is in BUILD_DIR/pgo/WordGrid
+
+get_filename_component(SOURCE_DIR "${CMAKE_CURRENT_LIST_DIR}/.." ABSOLUTE)
+if (NOT BUILD_DIR)
+    set(BUILD_DIR "${SOURCE_DIR}/build-pgo")
+endif()
+get_filename_component(BUILD_DIR "${BUILD_DIR}" ABSOLUTE)
+if (NOT GAMES)
+    set(GAMES 40)
+endif()
+if (NOT FRAMES)
+    set(FRAMES 3000)
+endif()
+set(PROFILE_DIR "${BUILD_DIR}/pgo/profile")
+
+set(GENERATOR_ARGS "")
+if (GENERATOR)
+    set(GENERATOR_ARGS -G "${GENERATOR}")
+endif()
+
+# The frame bench needs a display
+set(DISPLAY_COMMAND "")
+if (UNIX AND NOT APPLE AND NOT DEFINED ENV{DISPLAY} AND NOT DEFINED ENV{WAYLAND_DISPLAY})
+    find_program(XVFB_RUN NAMES xvfb-run)
+    if (NOT XVFB_RUN)
+        message(FATAL_ERROR "PGO: wordgrid_frame_bench needs a display or xvfb-run")
+    endif()
+    set(DISPLAY_COMMAND "${XVFB_RUN}" -a)
+endif()
+
+function(run)
+    execute_process(COMMAND ${ARGN} RESULT_VARIABLE result)
+    if (NOT result EQUAL 0)
+        message(FATAL_ERROR "PGO: '${ARGN}' failed")
+    endif()
+endfunction()
+
+function(configure dir)
+    run(${CMAKE_COMMAND} -S "${SOURCE_DIR}" -B "${dir}" ${GENERATOR_ARGS}
+        -DCMAKE_BUILD_TYPE=Release -DWORDGRID_PGO_DIR=${PROFILE_DIR} ${ARGN})
+endfunction()
+
+function(build dir)
+    run(${CMAKE_COMMAND} --build "${dir}" --config Release --parallel ${ARGN})
+endfunction()
+
+function(bench_dir dir out)
+    set(bench_dir "${dir}/Bench")
+    if (EXISTS "${bench_dir}/Release")
+        set(bench_dir "${bench_dir}/Release")
+    endif()
+    set(${out} "${bench_dir}" PARENT_SCOPE)
+endfunction()
+
+# Prints the report of the bench and returns its total in hundredths of a millisecond
+function(train dir label out_total out_checksum)
+    bench_dir("${dir}" bench_dir)
+    execute_process(COMMAND "${bench_dir}/wordgrid_train_bench" --games ${GAMES}
+        WORKING_DIRECTORY "${bench_dir}" RESULT_VARIABLE result OUTPUT_VARIABLE output)
+    if (NOT result EQUAL 0)
+        message(FATAL_ERROR "PGO: wordgrid_train_bench failed in ${dir}")
+    endif()
+    message(STATUS "PGO: ${label}\n${output}")
+    string(REGEX MATCH "total +([0-9]+)\\.([0-9][0-9])" total "${output}")
+    math(EXPR hundredths "${CMAKE_MATCH_1} * 100 + ${CMAKE_MATCH_2}")
+    string(REGEX MATCH "checksum +(-?[0-9]+)" checksum "${output}")
+    set(${out_total} ${hundredths} PARENT_SCOPE)
+    set(${out_checksum} ${CMAKE_MATCH_1} PARENT_SCOPE)
+endfunction()
+
+# Prints the report of the frame bench and returns the mean of update and draw of all frames
+# in microseconds, the part of a frame that runs the game's code
+function(play dir label out_time)
+    bench_dir("${dir}" bench_dir)
+    execute_process(COMMAND ${DISPLAY_COMMAND} "${bench_dir}/wordgrid_frame_bench" --frames ${FRAMES}
+        WORKING_DIRECTORY "${bench_dir}" RESULT_VARIABLE result OUTPUT_VARIABLE output)
+    if (NOT result EQUAL 0)
+        message(FATAL_ERROR "PGO: wordgrid_frame_bench failed in ${dir}\n${output}")
+    endif()
+    message(STATUS "PGO: ${label}\n${output}")
+    set(number "([0-9]+)\\.([0-9][0-9][0-9])")
+    string(REGEX MATCH "all +[0-9]+ +${number} +[0-9.]+ +${number}" line "${output}")
+    if (NOT line)
+        message(FATAL_ERROR "PGO: No frame times in the output of wordgrid_frame_bench")
+    endif()
+    math(EXPR micros "${CMAKE_MATCH_1} * 1000 + ${CMAKE_MATCH_2} + ${CMAKE_MATCH_3} * 1000 + ${CMAKE_MATCH_4}")
+    set(${out_time} ${micros} PARENT_SCOPE)
+endfunction()
+
+function(format_ms hundredths out)
+    math(EXPR whole "${hundredths} / 100")
+    math(EXPR fraction "${hundredths} % 100")
+    if (fraction LESS 10)
+        set(fraction "0${fraction}")
+    endif()
+    set(${out} "${whole}.${fraction} ms" PARENT_SCOPE)
+endfunction()
+
+function(report label before after before_text after_text)
+    math(EXPR gain "(${before} - ${after}) * 1000 / ${before}")
+    set(direction "faster")
+    if (gain LESS 0)
+        math(EXPR gain "-${gain}")
+        set(direction "slower")
+    endif()
+    math(EXPR gain_whole "${gain} / 10")
+    math(EXPR gain_tenth "${gain} % 10")
+    message(STATUS "PGO: ${label}, ${before_text} before, ${after_text} after, ${gain_whole}.${gain_tenth}% ${direction}")
+endfunction()
+
+configure("${BUILD_DIR}/base" -DWORDGRID_PGO=OFF -DWORDGRID_LTO=OFF)
+build("${BUILD_DIR}/base" --target wordgrid_train_bench wordgrid_frame_bench)
+train("${BUILD_DIR}/base" "release build" before before_checksum)
+play("${BUILD_DIR}/base" "release build of the game" frame_before)
+
+file(REMOVE_RECURSE "${PROFILE_DIR}")
+configure("${BUILD_DIR}/pgo" -DWORDGRID_PGO=GENERATE -DWORDGRID_LTO=OFF)
+build("${BUILD_DIR}/pgo" --target wordgrid_train_bench wordgrid_frame_bench)
+train("${BUILD_DIR}/pgo" "instrumented build, recording the profile" ignored ignored_checksum)
+play("${BUILD_DIR}/pgo" "instrumented game, recording the profile" ignored_frame)
+
+# Clang writes one raw profile per process that have to be merged
+file(GLOB raw_profiles "${PROFILE_DIR}/*.profraw")
+if (raw_profiles)
+    find_program(LLVM_PROFDATA NAMES llvm-profdata)
+    if (NOT LLVM_PROFDATA)
+        message(FATAL_ERROR "PGO: llvm-profdata is needed to merge the profiles of clang")
+    endif()
+    run("${LLVM_PROFDATA}" merge "-output=${PROFILE_DIR}/wordgrid.profdata" ${raw_profiles})
+endif()
+
+configure("${BUILD_DIR}/pgo" -DWORDGRID_PGO=USE -DWORDGRID_LTO=ON)
+build("${BUILD_DIR}/pgo")
+train("${BUILD_DIR}/pgo" "optimized build" after after_checksum)
+play("${BUILD_DIR}/pgo" "optimized game" frame_after)
+
+if (NOT before_checksum STREQUAL after_checksum)
+    message(FATAL_ERROR "PGO: The optimized build played different games, checksum ${after_checksum} instead of ${before_checksum}")
+endif()
+format_ms(${before} before_text)
+format_ms(${after} after_text)
+report("wordgrid_train_bench" ${before} ${after} "${before_text}" "${after_text}")
+report("Game update and draw per frame" ${frame_before} ${frame_after} "${frame_before} us" "${frame_after} us")
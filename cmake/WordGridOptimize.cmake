@@ -0,0 +1,66 @@
+# Optional optimized builds of the game, the server and the benchmarks
+#
+# WORDGRID_LTO turns on link time optimization. WORDGRID_PGO is OFF, GENERATE or USE:
+# GENERATE instruments the targets so that running wordgrid_train_bench and wordgrid_frame_bench
+# writes a profile into WORDGRID_PGO_DIR, USE builds with that profile. cmake/PGOBuild.cmake runs
+# all the steps and compares the result with a plain release build. raylib is built as usual
+
+option(WORDGRID_LTO "Build with link time optimization" OFF)
+set(WORDGRID_PGO "OFF" CACHE STRING "Profile guided optimization, OFF, GENERATE or USE")
+set_property(CACHE WORDGRID_PGO PROPERTY STRINGS OFF GENERATE USE)
+set(WORDGRID_PGO_DIR "${CMAKE_BINARY_DIR}/pgo" CACHE PATH "Directory of the profile of WORDGRID_PGO")
+
+if (NOT WORDGRID_PGO STREQUAL "OFF" AND NOT WORDGRID_PGO MATCHES "^(GENERATE|USE)$")
+    message(FATAL_ERROR "WORDGRID_PGO has to be OFF, GENERATE or USE, not ${WORDGRID_PGO}")
+endif()
+
+set(_wordgrid_lto OFF)
+if (WORDGRID_LTO)
+    include(CheckIPOSupported)
+    check_ipo_supported(RESULT _wordgrid_lto OUTPUT _wordgrid_lto_error LANGUAGES CXX)
+    if (NOT _wordgrid_lto)
+        message(WARNING "WORDGRID_LTO: Link time optimization is not supported, ${_wordgrid_lto_error}")
+    endif()
+endif()
+
+set(_wordgrid_pgo_compile "")
+set(_wordgrid_pgo_link "")
+if (WORDGRID_PGO STREQUAL "OFF")
+elseif ("${PLATFORM}" STREQUAL "Web")
+    message(WARNING "WORDGRID_PGO: Profiles can not be recorded in the browser, ignored")
+elseif (CMAKE_CXX_COMPILER_ID MATCHES "Clang")
+    # Every process writes its own raw profile, PGOBuild.cmake merges them with llvm-profdata
+    if (WORDGRID_PGO STREQUAL "GENERATE")
+        set(_wordgrid_pgo_compile "-fprofile-instr-generate=${WORDGRID_PGO_DIR}/wordgrid-%p.profraw")
+        set(_wordgrid_pgo_link ${_wordgrid_pgo_compile})
+    elseif (WORDGRID_PGO STREQUAL "USE")
+        set(_wordgrid_pgo_compile "-fprofile-instr-use=${WORDGRID_PGO_DIR}/wordgrid.profdata"
+            -Wno-profile-instr-unprofiled -Wno-profile-instr-out-of-date)
+    endif()
+elseif (CMAKE_CXX_COMPILER_ID STREQUAL "GNU")
+    # Profiles are found by the path of the object file, GENERATE and USE have to share
+    # the build directory. Only objects that ran in the training get a profile, the game's
+    # come from wordgrid_frame_bench that links the same objects. The game and the server
+    # count from several threads
+    if (WORDGRID_PGO STREQUAL "GENERATE")
+        set(_wordgrid_pgo_compile "-fprofile-generate=${WORDGRID_PGO_DIR}" -fprofile-update=atomic)
+        set(_wordgrid_pgo_link "-fprofile-generate=${WORDGRID_PGO_DIR}")
+    elseif (WORDGRID_PGO STREQUAL "USE")
+        set(_wordgrid_pgo_compile "-fprofile-use=${WORDGRID_PGO_DIR}" -fprofile-correction -Wno-missing-profile)
+    endif()
+else()
+    message(WARNING "WORDGRID_PGO: Only GCC and Clang are supported, ignored")
+endif()
+
+# Applies the optimizations that are turned on to `target`
+function(wordgrid_optimize target)
+    if (_wordgrid_lto)
+        set_property(TARGET ${target} PROPERTY INTERPROCEDURAL_OPTIMIZATION ON)
+    endif()
+    if (_wordgrid_pgo_compile)
+        target_compile_options(${target} PRIVATE ${_wordgrid_pgo_compile})
+    endif()
+    if (_wordgrid_pgo_link)
+        target_link_options(${target} PRIVATE ${_wordgrid_pgo_link})
+    endif()
+endfunction()
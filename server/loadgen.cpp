@@ -0,0 +1,260 @@
+/*******************************************************************************************
+*
+*   WordGrid
+*   Simple Word Puzzle Game
+*   (C) Harald Scheirich 2024
+*   WordGrid is is licensed under an unmodified zlib/libpng license see LICENSE
+*
+*   Load generator for wordgrid_server
+*   usage: wordgrid_loadgen [--host name] [--port n | --unix path] [--clients n]
+*                           [--moves n] [--threads n]
+*
+*   Every client is a connection that plays random legal moves, one request in flight at
+*   a time, starting a new game when the board is stuck. The time from sending a move to
+*   receiving its complete answer is recorded and the percentiles are printed at the end
+*
+********************************************************************************************/
+
+#include "protocol.h"
+#include "net.h"
+
+#include <stdlib.h>
+#include <sys/epoll.h>
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+static const int MAX_EVENTS = 256;
+static const int WAIT_TIMEOUT_MS = 5000;
+
+struct Client {
+    int fd = -1;
+    int moves_left = 0;
+    bool measuring = false;             // The request in flight is a move
+    Clock::time_point sent;
+    StateMessage state;
+    uint8_t input[2 * PROTOCOL_MAX_FRAME];
+    size_t input_size = 0;
+};
+
+struct LoadThread {
+    int client_count = 0;
+    int failed = 0;
+    uint64_t random_state = 0;
+    std::vector<int64_t> latencies;     // Nanoseconds per move
+    std::thread thread;
+};
+
+static Endpoint _endpoint;
+static int _moves_per_client = 100;
+
+static int random_int(LoadThread* load, int count)
+{
+    // xorshift64, only picks moves
+    load->random_state ^= load->random_state << 13;
+    load->random_state ^= load->random_state >> 7;
+    load->random_state ^= load->random_state << 17;
+    return (int)(load->random_state % (uint64_t)count);
+}
+
+static bool client_send(Client* client, const uint8_t* frame, size_t size, bool measuring)
+{
+    client->measuring = measuring;
+    client->sent = Clock::now();
+    while (size > 0) {
+        ssize_t written = send(client->fd, frame, size, MSG_NOSIGNAL);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            // Frames are tiny and only one is in flight, the socket buffer never fills
+            return false;
+        }
+        frame += written;
+        size -= (size_t)written;
+    }
+    return true;
+}
+
+static bool client_new_game(LoadThread* load, Client* client)
+{
+    uint8_t frame[PROTOCOL_MAX_FRAME];
+    GameMode mode = (GameMode)random_int(load, MODE_COUNT);
+    return client_send(client, frame, protocol_write_new_game(frame, mode, GAME_MAX_SIZE, GAME_MAX_SIZE, 0), false);
+}
+
+// Picks a random well tile and a cell it can go to, refreshes or restarts when stuck
+static bool client_next(LoadThread* load, Client* client)
+{
+    const StateMessage* state = &client->state;
+    int cells = state->rows * state->columns;
+    int empty[GAME_MAX_CELLS];
+    int empty_count = 0;
+    for (int i = 0; i < cells; ++i) {
+        if (state->letters[i] == GAME_EMPTY) empty[empty_count++] = i;
+    }
+
+    int start = random_int(load, GAME_WELL_SIZE);
+    for (int n = 0; n < GAME_WELL_SIZE; ++n) {
+        int well_index = (start + n) % GAME_WELL_SIZE;
+        int tile = state->well[well_index];
+        int cell = -1;
+        if (is_special(tile)) cell = random_int(load, cells);
+        else if (tile != GAME_EMPTY && empty_count > 0) cell = empty[random_int(load, empty_count)];
+        if (cell < 0) continue;
+
+        uint8_t frame[PROTOCOL_MAX_FRAME];
+        size_t size = protocol_write_play(frame, well_index, cell / state->rows, cell % state->rows);
+        return client_send(client, frame, size, true);
+    }
+
+    if (state->refresh_count > 0) {
+        uint8_t frame[PROTOCOL_MAX_FRAME];
+        return client_send(client, frame, protocol_write_refresh(frame), false);
+    }
+    return client_new_game(load, client);
+}
+
+// Returns false when the client is done or failed
+static bool client_receive(LoadThread* load, Client* client)
+{
+    while (true) {
+        ssize_t count = recv(client->fd, client->input + client->input_size,
+            sizeof(client->input) - client->input_size, 0);
+        if (count == 0) return false;
+        if (count < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) return true;
+            return false;
+        }
+        client->input_size += (size_t)count;
+
+        if (client->input_size < PROTOCOL_LENGTH_SIZE) continue;
+        uint32_t size = protocol_get_u32(client->input);
+        if (client->input_size < PROTOCOL_LENGTH_SIZE + size) continue;
+        if (!protocol_read_state(client->input + PROTOCOL_LENGTH_SIZE, size, &client->state) ||
+            client->input_size != PROTOCOL_LENGTH_SIZE + size || client->state.status == STATUS_BAD_MESSAGE ||
+            client->state.status == STATUS_NO_GAME) {
+            load->failed++;
+            return false;
+        }
+        client->input_size = 0;
+
+        if (client->measuring) {
+            load->latencies.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - client->sent).count());
+            if (--client->moves_left <= 0) return false;
+        }
+        return client_next(load, client);
+    }
+}
+
+static void load_run(LoadThread* load)
+{
+    int epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    std::vector<Client> clients(load->client_count);
+    load->latencies.reserve((size_t)load->client_count * _moves_per_client);
+
+    int active = 0;
+    for (Client& client : clients) {
+        client.fd = net_connect(&_endpoint);
+        client.moves_left = _moves_per_client;
+        if (client.fd < 0) {
+            load->failed++;
+            continue;
+        }
+        epoll_event event;
+        event.events = EPOLLIN | EPOLLET;
+        event.data.ptr = &client;
+        epoll_ctl(epoll_fd, EPOLL_CTL_ADD, client.fd, &event);
+        if (!client_new_game(load, &client)) {
+            load->failed++;
+            close(client.fd);
+            continue;
+        }
+        active++;
+    }
+
+    epoll_event events[MAX_EVENTS];
+    while (active > 0) {
+        int count = epoll_wait(epoll_fd, events, MAX_EVENTS, WAIT_TIMEOUT_MS);
+        if (count == 0) {
+            fprintf(stderr, "%d clients did not get an answer in time\n", active);
+            load->failed += active;
+            break;
+        }
+        for (int i = 0; i < count; ++i) {
+            Client* client = (Client*)events[i].data.ptr;
+            if (!client_receive(load, client)) {
+                epoll_ctl(epoll_fd, EPOLL_CTL_DEL, client->fd, nullptr);
+                close(client->fd);
+                client->fd = -1;
+                active--;
+            }
+        }
+    }
+    for (Client& client : clients) {
+        if (client.fd >= 0) close(client.fd);
+    }
+    close(epoll_fd);
+}
+
+static double percentile_us(const std::vector<int64_t>& sorted, double p)
+{
+    if (sorted.empty()) return 0.0;
+    size_t index = (size_t)(p / 100.0 * (double)(sorted.size() - 1) + 0.5);
+    return (double)sorted[index] / 1000.0;
+}
+
+static void print_usage()
+{
+    printf("usage: wordgrid_loadgen [--host name] [--port n | --unix path] [--clients n]\n"
+        "                        [--moves n] [--threads n]\n");
+}
+
+int main(int argc, char** argv)
+{
+    int client_count = 1000;
+    int thread_count = 4;
+    for (int i = 1; i < argc; ++i) {
+        bool has_value = i + 1 < argc;
+        if (strcmp(argv[i], "--host") == 0 && has_value) _endpoint.host = argv[++i];
+        else if (strcmp(argv[i], "--port") == 0 && has_value) _endpoint.port = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--unix") == 0 && has_value) _endpoint.unix_path = argv[++i];
+        else if (strcmp(argv[i], "--clients") == 0 && has_value) client_count = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--moves") == 0 && has_value) _moves_per_client = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--threads") == 0 && has_value) thread_count = atoi(argv[++i]);
+        else {
+            print_usage();
+            return 1;
+        }
+    }
+    if (thread_count < 1) thread_count = 1;
+    if (thread_count > client_count) thread_count = client_count;
+
+    std::vector<LoadThread> loads(thread_count);
+    for (int i = 0; i < thread_count; ++i) {
+        loads[i].client_count = client_count / thread_count + (i < client_count % thread_count ? 1 : 0);
+        loads[i].random_state = 0x2545F4914F6CDD1Dull * (uint64_t)(i + 1);
+    }
+
+    Clock::time_point start = Clock::now();
+    for (LoadThread& load : loads) load.thread = std::thread(load_run, &load);
+    for (LoadThread& load : loads) load.thread.join();
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    std::vector<int64_t> latencies;
+    int failed = 0;
+    for (LoadThread& load : loads) {
+        latencies.insert(latencies.end(), load.latencies.begin(), load.latencies.end());
+        failed += load.failed;
+    }
+    std::sort(latencies.begin(), latencies.end());
+
+    printf("clients  %d (%d failed)\n", client_count, failed);
+    printf("moves    %zu in %.2f s, %.0f moves/s\n", latencies.size(), seconds, (double)latencies.size() / seconds);
+    printf("latency  p50 %.1f us  p99 %.1f us  max %.1f us\n",
+        percentile_us(latencies, 50.0), percentile_us(latencies, 99.0), percentile_us(latencies, 100.0));
+    return failed == 0 ? 0 : 1;
+}
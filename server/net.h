@@ -0,0 +1,131 @@
+/*******************************************************************************************
+*
+*   WordGrid
+*   Simple Word Puzzle Game
+*   (C) Harald Scheirich 2024
+*   WordGrid is is licensed under an unmodified zlib/libpng license see LICENSE
+*
+*   Socket helpers shared by the server and the load generator, an endpoint is either a
+*   TCP port or the path of a Unix domain socket
+*
+********************************************************************************************/
+
+#pragma once
+
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <netdb.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+static const int NET_DEFAULT_PORT = 7450;
+
+struct Endpoint {
+    const char* host = "127.0.0.1";
+    int port = NET_DEFAULT_PORT;
+    const char* unix_path = nullptr;    // Takes precedence over host and port
+};
+
+inline bool net_set_nonblocking(int fd)
+{
+    int flags = fcntl(fd, F_GETFL, 0);
+    return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+// Small frames go out right away instead of waiting for more data
+inline void net_set_nodelay(int fd)
+{
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+}
+
+inline bool net_unix_address(const char* path, sockaddr_un* address)
+{
+    memset(address, 0, sizeof(sockaddr_un));
+    address->sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(address->sun_path)) return false;
+    strcpy(address->sun_path, path);
+    return true;
+}
+
+// Non blocking listening socket, -1 on failure
+inline int net_listen(const Endpoint* endpoint)
+{
+    int fd = -1;
+    if (endpoint->unix_path != nullptr) {
+        sockaddr_un address;
+        if (!net_unix_address(endpoint->unix_path, &address)) return -1;
+        unlink(endpoint->unix_path);
+        fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd < 0) return -1;
+        if (bind(fd, (sockaddr*)&address, sizeof(address)) != 0) {
+            close(fd);
+            return -1;
+        }
+    }
+    else {
+        sockaddr_in address;
+        memset(&address, 0, sizeof(address));
+        address.sin_family = AF_INET;
+        address.sin_port = htons((uint16_t)endpoint->port);
+        address.sin_addr.s_addr = htonl(INADDR_ANY);
+        fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd < 0) return -1;
+        int one = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        if (bind(fd, (sockaddr*)&address, sizeof(address)) != 0) {
+            close(fd);
+            return -1;
+        }
+    }
+    if (listen(fd, SOMAXCONN) != 0 || !net_set_nonblocking(fd)) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// Blocking connect, the socket is non blocking afterwards. -1 on failure
+inline int net_connect(const Endpoint* endpoint)
+{
+    int fd = -1;
+    if (endpoint->unix_path != nullptr) {
+        sockaddr_un address;
+        if (!net_unix_address(endpoint->unix_path, &address)) return -1;
+        fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd < 0) return -1;
+        if (connect(fd, (sockaddr*)&address, sizeof(address)) != 0) {
+            close(fd);
+            return -1;
+        }
+    }
+    else {
+        addrinfo hints;
+        memset(&hints, 0, sizeof(hints));
+        hints.ai_family = AF_INET;
+        hints.ai_socktype = SOCK_STREAM;
+        addrinfo* result = nullptr;
+        char port[16];
+        snprintf(port, sizeof(port), "%d", endpoint->port);
+        if (getaddrinfo(endpoint->host, port, &hints, &result) != 0) return -1;
+        fd = socket(result->ai_family, result->ai_socktype | SOCK_CLOEXEC, result->ai_protocol);
+        if (fd >= 0 && connect(fd, result->ai_addr, result->ai_addrlen) != 0) {
+            close(fd);
+            fd = -1;
+        }
+        freeaddrinfo(result);
+        if (fd < 0) return -1;
+        net_set_nodelay(fd);
+    }
+    if (!net_set_nonblocking(fd)) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
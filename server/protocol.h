@@ -0,0 +1,147 @@
+/*******************************************************************************************
+*
+*   WordGrid
+*   Simple Word Puzzle Game
+*   (C) Harald Scheirich 2024
+*   WordGrid is is licensed under an unmodified zlib/libpng license see LICENSE
+*
+*   Wire protocol between wordgrid_server and its clients
+*
+*   Every message is a frame: a little endian uint32 with the size of the rest of the
+*   frame, one byte message type and the payload. The server answers every request with
+*   exactly one MSG_STATE, in the order the requests arrived
+*
+*   MSG_NEW_GAME  uint8 mode, uint8 rows, uint8 columns, uint64 seed (0 lets the server pick)
+*   MSG_PLAY      uint8 well index, uint8 x, uint8 y
+*   MSG_REFRESH   no payload
+*   MSG_STATE     uint8 status, uint8 check result, uint8 rows, uint8 columns,
+*                 int32 word count, int32 move count, int32 refresh count,
+*                 int8 well[GAME_WELL_SIZE], int8 letters[GAME_MAX_CELLS] column major
+*
+********************************************************************************************/
+
+#pragma once
+
+#include "game.h"
+
+#include <stdint.h>
+#include <stddef.h>
+
+static const uint32_t PROTOCOL_MAX_FRAME = 256;
+static const int PROTOCOL_LENGTH_SIZE = 4;
+
+enum MessageType : uint8_t {
+    MSG_NEW_GAME = 1,
+    MSG_PLAY = 2,
+    MSG_REFRESH = 3,
+    MSG_STATE = 128,
+};
+
+enum MessageStatus : uint8_t {
+    STATUS_OK = 0,
+    STATUS_REJECTED,        // Move or refresh is not allowed in this state
+    STATUS_NO_GAME,         // MSG_NEW_GAME was not sent yet
+    STATUS_BAD_MESSAGE,
+};
+
+static const uint32_t PROTOCOL_NEW_GAME_SIZE = 1 + 3 + 8;
+static const uint32_t PROTOCOL_PLAY_SIZE = 1 + 3;
+static const uint32_t PROTOCOL_REFRESH_SIZE = 1;
+static const uint32_t PROTOCOL_STATE_SIZE = 1 + 4 + 12 + GAME_WELL_SIZE + GAME_MAX_CELLS;
+
+struct StateMessage {
+    MessageStatus status;
+    CheckResult check;
+    int rows;
+    int columns;
+    int word_count;
+    int move_count;
+    int refresh_count;
+    int well[GAME_WELL_SIZE];
+    int letters[GAME_MAX_CELLS];
+};
+
+inline void protocol_put_u32(uint8_t* out, uint32_t value)
+{
+    for (int i = 0; i < 4; ++i) out[i] = (uint8_t)(value >> (8 * i));
+}
+
+inline uint32_t protocol_get_u32(const uint8_t* in)
+{
+    return (uint32_t)in[0] | ((uint32_t)in[1] << 8) | ((uint32_t)in[2] << 16) | ((uint32_t)in[3] << 24);
+}
+
+inline void protocol_put_u64(uint8_t* out, uint64_t value)
+{
+    protocol_put_u32(out, (uint32_t)value);
+    protocol_put_u32(out + 4, (uint32_t)(value >> 32));
+}
+
+inline uint64_t protocol_get_u64(const uint8_t* in)
+{
+    return (uint64_t)protocol_get_u32(in) | ((uint64_t)protocol_get_u32(in + 4) << 32);
+}
+
+// The write functions return the size of the whole frame, `out` needs PROTOCOL_MAX_FRAME bytes
+inline size_t protocol_write_new_game(uint8_t* out, GameMode mode, int rows, int columns, uint64_t seed)
+{
+    protocol_put_u32(out, PROTOCOL_NEW_GAME_SIZE);
+    out[4] = MSG_NEW_GAME;
+    out[5] = (uint8_t)mode;
+    out[6] = (uint8_t)rows;
+    out[7] = (uint8_t)columns;
+    protocol_put_u64(out + 8, seed);
+    return PROTOCOL_LENGTH_SIZE + PROTOCOL_NEW_GAME_SIZE;
+}
+
+inline size_t protocol_write_play(uint8_t* out, int well_index, int x, int y)
+{
+    protocol_put_u32(out, PROTOCOL_PLAY_SIZE);
+    out[4] = MSG_PLAY;
+    out[5] = (uint8_t)well_index;
+    out[6] = (uint8_t)x;
+    out[7] = (uint8_t)y;
+    return PROTOCOL_LENGTH_SIZE + PROTOCOL_PLAY_SIZE;
+}
+
+inline size_t protocol_write_refresh(uint8_t* out)
+{
+    protocol_put_u32(out, PROTOCOL_REFRESH_SIZE);
+    out[4] = MSG_REFRESH;
+    return PROTOCOL_LENGTH_SIZE + PROTOCOL_REFRESH_SIZE;
+}
+
+// Without a game only the status is meaningful
+inline size_t protocol_write_state(uint8_t* out, MessageStatus status, CheckResult check, const Game* game)
+{
+    protocol_put_u32(out, PROTOCOL_STATE_SIZE);
+    out[4] = MSG_STATE;
+    out[5] = status;
+    out[6] = (uint8_t)check;
+    out[7] = (uint8_t)game->rows;
+    out[8] = (uint8_t)game->columns;
+    protocol_put_u32(out + 9, (uint32_t)game->word_count);
+    protocol_put_u32(out + 13, (uint32_t)game->move_count);
+    protocol_put_u32(out + 17, (uint32_t)game->refresh_count);
+    uint8_t* tiles = out + 21;
+    for (int i = 0; i < GAME_WELL_SIZE; ++i) *tiles++ = (uint8_t)(int8_t)game->well[i];
+    for (int i = 0; i < GAME_MAX_CELLS; ++i) *tiles++ = (uint8_t)(int8_t)game->letters[i];
+    return PROTOCOL_LENGTH_SIZE + PROTOCOL_STATE_SIZE;
+}
+
+// `frame` starts after the length, returns false if it is not a complete MSG_STATE
+inline bool protocol_read_state(const uint8_t* frame, uint32_t size, StateMessage* state)
+{
+    if (size != PROTOCOL_STATE_SIZE || frame[0] != MSG_STATE) return false;
+    state->status = (MessageStatus)frame[1];
+    state->check = (CheckResult)frame[2];
+    state->rows = frame[3];
+    state->columns = frame[4];
+    state->word_count = (int)protocol_get_u32(frame + 5);
+    state->move_count = (int)protocol_get_u32(frame + 9);
+    state->refresh_count = (int)protocol_get_u32(frame + 13);
+    const uint8_t* tiles = frame + 17;
+    for (int i = 0; i < GAME_WELL_SIZE; ++i) state->well[i] = (int8_t)*tiles++;
+    for (int i = 0; i < GAME_MAX_CELLS; ++i) state->letters[i] = (int8_t)*tiles++;
+    return true;
+}
@@ -0,0 +1,432 @@
+/*******************************************************************************************
+*
+*   WordGrid
+*   Simple Word Puzzle Game
+*   (C) Harald Scheirich 2024
+*   WordGrid is is licensed under an unmodified zlib/libpng license see LICENSE
+*
+*   Headless game server, the authority on moves for remote clients
+*   usage: wordgrid_server [--port n | --unix path] [--threads n] [--max-sessions n]
+*                          [--dictionary file] [--distribution file]
+*
+*   Every connection is one session with its own Game, the random state is part of Game
+*   so sessions never share a generator. Each worker thread runs its own epoll loop, all
+*   of them wait on the listening socket and a connection stays with the worker that
+*   accepted it, sessions are never locked. Workers share one dictionary snapshot, each
+*   batch of events holds a reference to the snapshot that was current when it started
+*
+*   Sessions are fixed size and come from a pool in the arena of their worker, the memory
+*   of the server is allocated at start and workers never contend on the heap
+*
+*   Frames are only handled while their replies fit into the output buffer, a client that
+*   sends faster than it reads is paused until the socket takes the replies. Clients that
+*   take none for OUTPUT_STALL_SECONDS are dropped
+*
+*   Only the rules of game.h are enforced, the clocks and move limits of the modes are
+*   left to the client
+*
+********************************************************************************************/
+
+#include "raylib.h"
+#include "game.h"
+#include "dictionary_snapshot.h"
+#include "arena.h"
+#include "protocol.h"
+#include "net.h"
+
+#include <stdlib.h>
+#include <signal.h>
+#include <time.h>
+#include <sys/epoll.h>
+
+#include <atomic>
+#include <new>
+#include <thread>
+#include <vector>
+
+static const int MAX_EVENTS = 256;
+static const size_t INPUT_CAPACITY = 4 * PROTOCOL_MAX_FRAME;
+static const size_t OUTPUT_CAPACITY = 2048;
+static const size_t REPLY_SIZE = PROTOCOL_LENGTH_SIZE + PROTOCOL_STATE_SIZE;
+static const double OUTPUT_STALL_SECONDS = 10.0;
+static const int WAIT_TIMEOUT_MS = 250;            // How quickly workers notice a shutdown and stalled clients
+
+struct Session {
+    int fd = -1;
+    bool has_game = false;
+    bool wants_output = false;          // EPOLLOUT is registered and the session is in Worker::waiting
+    double output_since = 0;            // When the client last took replies while output was pending
+    Session* prev_waiting = nullptr;
+    Session* next_waiting = nullptr;
+    Game game;
+    uint8_t input[INPUT_CAPACITY];
+    size_t input_size = 0;
+    uint8_t output[OUTPUT_CAPACITY];
+    size_t output_size = 0;
+    size_t output_sent = 0;
+};
+
+struct Worker {
+    int epoll_fd = -1;
+    uint64_t random_state = 0;          // Seeds for games that did not ask for one
+    int64_t requests = 0;
+    WordCacheStats word_cache;          // Of the thread, copied when it exits
+    Arena arena;
+    Pool sessions;
+    int max_sessions = 0;
+    const Dictionary* dictionary = nullptr;     // Of the current batch
+    Session* waiting = nullptr;                 // Sessions with replies the socket did not take yet
+    std::thread thread;
+};
+
+static DictionaryStore _dictionaries;
+static int _listen_fd = -1;
+static std::atomic<bool> _stop{ false };
+
+static void on_signal(int)
+{
+    _stop = true;
+}
+
+static uint64_t worker_next_seed(Worker* worker)
+{
+    // splitmix64, the same mixer Game uses
+    uint64_t z = (worker->random_state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+static double now_seconds()
+{
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + 1e-9 * (double)now.tv_nsec;
+}
+
+static void waiting_add(Worker* worker, Session* session)
+{
+    session->prev_waiting = nullptr;
+    session->next_waiting = worker->waiting;
+    if (worker->waiting != nullptr) worker->waiting->prev_waiting = session;
+    worker->waiting = session;
+}
+
+static void waiting_remove(Worker* worker, Session* session)
+{
+    if (session->prev_waiting != nullptr) session->prev_waiting->next_waiting = session->next_waiting;
+    else worker->waiting = session->next_waiting;
+    if (session->next_waiting != nullptr) session->next_waiting->prev_waiting = session->prev_waiting;
+    session->prev_waiting = nullptr;
+    session->next_waiting = nullptr;
+}
+
+static void session_close(Worker* worker, Session* session)
+{
+    if (session->wants_output) waiting_remove(worker, session);
+    epoll_ctl(worker->epoll_fd, EPOLL_CTL_DEL, session->fd, nullptr);
+    close(session->fd);
+    session->~Session();
+    pool_free(&worker->sessions, session);
+}
+
+static bool session_can_reply(const Session* session)
+{
+    return session->output_size + REPLY_SIZE <= OUTPUT_CAPACITY;
+}
+
+// Every frame gets exactly one reply, session_process() makes sure it fits
+static void session_reply(Session* session, MessageStatus status, CheckResult check)
+{
+    session->output_size += protocol_write_state(session->output + session->output_size, status, check, &session->game);
+}
+
+static void session_new_game(Worker* worker, Session* session, const uint8_t* payload)
+{
+    int mode = payload[0];
+    int rows = payload[1];
+    int columns = payload[2];
+    uint64_t seed = protocol_get_u64(payload + 3);
+    bool valid = mode > MODE_NONE && mode < MODE_COUNT &&
+        rows > 0 && rows <= GAME_MAX_SIZE && columns > 0 && columns <= GAME_MAX_SIZE &&
+        rows * columns <= GAME_MAX_CELLS;
+    if (!valid) {
+        session_reply(session, STATUS_BAD_MESSAGE, CHECK_RESULT_NONE);
+        return;
+    }
+    if (seed == 0) seed = worker_next_seed(worker);
+    game_init(&session->game, (GameMode)mode, rows, columns, seed, worker->dictionary);
+    session->has_game = true;
+    session_reply(session, STATUS_OK, CHECK_RESULT_NONE);
+}
+
+// `frame` starts with the message type
+static void session_handle(Worker* worker, Session* session, const uint8_t* frame, uint32_t size)
+{
+    worker->requests++;
+    uint8_t type = frame[0];
+    if (type == MSG_NEW_GAME && size == PROTOCOL_NEW_GAME_SIZE) {
+        session_new_game(worker, session, frame + 1);
+    }
+    else if ((type == MSG_PLAY && size == PROTOCOL_PLAY_SIZE) || (type == MSG_REFRESH && size == PROTOCOL_REFRESH_SIZE)) {
+        if (!session->has_game) {
+            session_reply(session, STATUS_NO_GAME, CHECK_RESULT_NONE);
+            return;
+        }
+        CheckResult check = CHECK_RESULT_NONE;
+        bool ok = (type == MSG_PLAY) ?
+            game_play(&session->game, worker->dictionary, frame[1], frame[2], frame[3], &check) :
+            game_refresh_well(&session->game, worker->dictionary);
+        session_reply(session, ok ? STATUS_OK : STATUS_REJECTED, check);
+    }
+    else {
+        session_reply(session, STATUS_BAD_MESSAGE, CHECK_RESULT_NONE);
+    }
+}
+
+// Handles the complete frames in the input buffer while their replies fit, false if the stream is corrupt
+static bool session_process(Worker* worker, Session* session)
+{
+    size_t offset = 0;
+    while (session->input_size - offset >= PROTOCOL_LENGTH_SIZE && session_can_reply(session)) {
+        uint32_t size = protocol_get_u32(session->input + offset);
+        if (size == 0 || size > PROTOCOL_MAX_FRAME) return false;
+        if (session->input_size - offset < PROTOCOL_LENGTH_SIZE + size) break;
+        session_handle(worker, session, session->input + offset + PROTOCOL_LENGTH_SIZE, size);
+        offset += PROTOCOL_LENGTH_SIZE + size;
+    }
+    memmove(session->input, session->input + offset, session->input_size - offset);
+    session->input_size -= offset;
+    return true;
+}
+
+// Writes as much as the socket takes, EPOLLOUT is only registered while output is pending
+static bool session_flush(Worker* worker, Session* session)
+{
+    bool progress = false;
+    while (session->output_sent < session->output_size) {
+        ssize_t written = send(session->fd, session->output + session->output_sent,
+            session->output_size - session->output_sent, MSG_NOSIGNAL);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+            return false;
+        }
+        session->output_sent += (size_t)written;
+        progress = progress || written > 0;
+    }
+    if (session->output_sent == session->output_size) {
+        session->output_size = 0;
+        session->output_sent = 0;
+    }
+    else if (session->output_sent > 0) {
+        memmove(session->output, session->output + session->output_sent, session->output_size - session->output_sent);
+        session->output_size -= session->output_sent;
+        session->output_sent = 0;
+    }
+
+    bool wants_output = session->output_size > 0;
+    if (wants_output && (progress || !session->wants_output)) session->output_since = now_seconds();
+    if (wants_output != session->wants_output) {
+        epoll_event event;
+        event.events = EPOLLIN | EPOLLRDHUP | EPOLLET | (wants_output ? (uint32_t)EPOLLOUT : 0u);
+        event.data.ptr = session;
+        epoll_ctl(worker->epoll_fd, EPOLL_CTL_MOD, session->fd, &event);
+        session->wants_output = wants_output;
+        if (wants_output) waiting_add(worker, session);
+        else waiting_remove(worker, session);
+    }
+    return true;
+}
+
+// Edge triggered, reads until the socket is drained or the input buffer is full. Sets `blocked`
+// when the output buffer has no room for another reply, frames wait until it is sent
+static bool session_read(Worker* worker, Session* session, bool* blocked)
+{
+    if (!session_process(worker, session)) return false;
+    while (session->input_size < INPUT_CAPACITY) {
+        ssize_t count = recv(session->fd, session->input + session->input_size,
+            INPUT_CAPACITY - session->input_size, 0);
+        if (count == 0) return false;
+        if (count < 0) {
+            if (errno == EINTR) continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK) return false;
+            break;
+        }
+        session->input_size += (size_t)count;
+        if (!session_process(worker, session)) return false;
+    }
+    *blocked = !session_can_reply(session);
+    return true;
+}
+
+// Reads, handles and replies until the socket has no more input or takes no more replies
+static bool session_pump(Worker* worker, Session* session)
+{
+    while (true) {
+        bool blocked = false;
+        if (!session_read(worker, session, &blocked)) return false;
+        if (!session_flush(worker, session)) return false;
+        if (!blocked || session->output_size > 0) return true;
+    }
+}
+
+static void worker_accept(Worker* worker)
+{
+    while (true) {
+        int fd = accept4(_listen_fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK) TraceLog(LOG_WARNING, "SERVER: accept failed (%s)", strerror(errno));
+            return;
+        }
+        // A full worker turns the connection away instead of growing
+        void* memory = (worker->sessions.live < worker->max_sessions) ? pool_alloc(&worker->sessions) : nullptr;
+        if (memory == nullptr) {
+            close(fd);
+            continue;
+        }
+        net_set_nodelay(fd);    // Fails harmlessly on Unix sockets
+
+        Session* session = new (memory) Session();
+        session->fd = fd;
+        epoll_event event;
+        event.events = EPOLLIN | EPOLLRDHUP | EPOLLET;
+        event.data.ptr = session;
+        if (epoll_ctl(worker->epoll_fd, EPOLL_CTL_ADD, fd, &event) != 0) {
+            close(fd);
+            session->~Session();
+            pool_free(&worker->sessions, session);
+        }
+    }
+}
+
+static void worker_run(Worker* worker)
+{
+    epoll_event events[MAX_EVENTS];
+    while (!_stop) {
+        int count = epoll_wait(worker->epoll_fd, events, MAX_EVENTS, WAIT_TIMEOUT_MS);
+        DictionarySnapshot* snapshot = dictionary_store_acquire(&_dictionaries);
+        worker->dictionary = &snapshot->dictionary;
+        for (int i = 0; i < count; ++i) {
+            if (events[i].data.ptr == nullptr) {
+                worker_accept(worker);
+                continue;
+            }
+            Session* session = (Session*)events[i].data.ptr;
+            bool ok = (events[i].events & EPOLLERR) == 0;
+            if (ok) ok = session_pump(worker, session);
+            if (ok && (events[i].events & (EPOLLRDHUP | EPOLLHUP)) != 0 && session->output_size == 0) ok = false;
+            if (!ok) session_close(worker, session);
+        }
+
+        double now = now_seconds();
+        for (Session* session = worker->waiting; session != nullptr;) {
+            Session* next = session->next_waiting;
+            if (now - session->output_since > OUTPUT_STALL_SECONDS) session_close(worker, session);
+            session = next;
+        }
+        worker->dictionary = nullptr;
+        dictionary_snapshot_release(snapshot);
+    }
+    worker->word_cache = word_cache_local()->stats;
+}
+
+static void print_usage()
+{
+    printf("usage: wordgrid_server [--port n | --unix path] [--threads n] [--max-sessions n]\n"
+        "                       [--dictionary file] [--distribution file]\n");
+}
+
+int main(int argc, char** argv)
+{
+    Endpoint endpoint;
+    int thread_count = (int)std::thread::hardware_concurrency();
+    if (thread_count < 1) thread_count = 1;
+    if (thread_count > 4) thread_count = 4;
+    const char* dictionary_file = "resources/text/en/words.txt";
+    const char* distribution_file = "resources/text/en/distribution.txt";
+    int max_sessions = 16384;
+
+    for (int i = 1; i < argc; ++i) {
+        bool has_value = i + 1 < argc;
+        if (strcmp(argv[i], "--port") == 0 && has_value) endpoint.port = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--unix") == 0 && has_value) endpoint.unix_path = argv[++i];
+        else if (strcmp(argv[i], "--threads") == 0 && has_value) thread_count = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--max-sessions") == 0 && has_value) max_sessions = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--dictionary") == 0 && has_value) dictionary_file = argv[++i];
+        else if (strcmp(argv[i], "--distribution") == 0 && has_value) distribution_file = argv[++i];
+        else {
+            print_usage();
+            return 1;
+        }
+    }
+    if (thread_count < 1) thread_count = 1;
+    if (max_sessions < thread_count) max_sessions = thread_count;
+
+    SetTraceLogLevel(LOG_WARNING);
+    Dictionary dictionary = dictionary_load(dictionary_file);
+    dictionary_load_distribution(&dictionary, distribution_file);
+    if (dictionary.words_size == 0 || dictionary.distribution_sum == 0) {
+        TraceLog(LOG_ERROR, "SERVER: Could not load %s and %s", dictionary_file, distribution_file);
+        return 1;
+    }
+    dictionary_store_publish(&_dictionaries, dictionary_snapshot_create(&dictionary));
+
+    _listen_fd = net_listen(&endpoint);
+    if (_listen_fd < 0) {
+        TraceLog(LOG_ERROR, "SERVER: Could not listen (%s)", strerror(errno));
+        return 1;
+    }
+
+    signal(SIGINT, on_signal);
+    signal(SIGTERM, on_signal);
+    signal(SIGPIPE, SIG_IGN);
+
+    std::vector<Worker> workers(thread_count);
+    uint64_t seed = (uint64_t)time(nullptr) ^ ((uint64_t)getpid() << 32);
+    size_t session_size = (sizeof(Session) + alignof(max_align_t) - 1) & ~(alignof(max_align_t) - 1);
+    for (int i = 0; i < thread_count; ++i) {
+        Worker* worker = &workers[i];
+        worker->random_state = seed + (uint64_t)i * 0x9E3779B97F4A7C15ull;
+        // Sessions are split evenly, a worker with a full pool turns connections away
+        worker->max_sessions = max_sessions / thread_count;
+        arena_init(&worker->arena, session_size * (size_t)worker->max_sessions, "sessions");
+        pool_init(&worker->sessions, &worker->arena, sizeof(Session));
+        worker->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+        // Only one of the waiting workers is woken for a new connection
+        epoll_event event;
+        event.events = EPOLLIN | EPOLLEXCLUSIVE;
+        event.data.ptr = nullptr;
+        if (worker->epoll_fd < 0 || epoll_ctl(worker->epoll_fd, EPOLL_CTL_ADD, _listen_fd, &event) != 0) {
+            TraceLog(LOG_ERROR, "SERVER: Could not set up epoll (%s)", strerror(errno));
+            return 1;
+        }
+    }
+
+    printf("%d sessions of %zu bytes, %zu KB\n", max_sessions / thread_count * thread_count, session_size,
+        session_size * (size_t)(max_sessions / thread_count * thread_count) / 1024);
+    if (endpoint.unix_path != nullptr) printf("Listening on %s with %d threads\n", endpoint.unix_path, thread_count);
+    else printf("Listening on port %d with %d threads\n", endpoint.port, thread_count);
+    fflush(stdout);
+
+    for (Worker& worker : workers) worker.thread = std::thread(worker_run, &worker);
+    for (Worker& worker : workers) worker.thread.join();
+
+    int64_t requests = 0;
+    WordCacheStats word_cache;
+    for (Worker& worker : workers) {
+        requests += worker.requests;
+        word_cache_add_stats(&word_cache, &worker.word_cache);
+        close(worker.epoll_fd);
+        arena_unload(&worker.arena);
+    }
+    printf("Handled %lld requests\n", (long long)requests);
+    printf("Word cache %lld hits, %lld misses, %lld skipped, %.1f%% hit rate\n", (long long)word_cache.hits,
+        (long long)word_cache.misses, (long long)word_cache.skipped, 100.0 * word_cache_hit_rate(&word_cache));
+
+    close(_listen_fd);
+    if (endpoint.unix_path != nullptr) unlink(endpoint.unix_path);
+    dictionary_store_clear(&_dictionaries);
+    return 0;
+}
@@ -0,0 +1,218 @@
+/*******************************************************************************************
+*
+*   WordGrid
+*   Simple Word Puzzle Game
+*   (C) Harald Scheirich 2024
+*   WordGrid is is licensed under an unmodified zlib/libpng license see LICENSE
+*
+********************************************************************************************/
+
+#include "ai_player.h"
+
+#if !defined(PLATFORM_WEB)
+    #include <condition_variable>
+    #include <mutex>
+    #include <thread>
+    #define AI_USE_THREAD
+#endif
+
+static const int _table_entries = 1 << 17;     // 16 bytes each
+static const double _web_slice = 0.004;         // Seconds of search per frame on the web
+
+struct AiJob {
+    Game game;
+    DictionarySnapshot* snapshot = nullptr;     // Retained for the job
+    int max_depth = 1;
+    double budget = 0;
+    uint64_t id = 0;
+};
+
+// Only touched by whoever runs the search, the worker thread on the desktop
+static AiSearch _search;
+static uint32_t _table_dictionary = 0;
+
+static uint64_t _job_id = 0;
+static bool _thinking = false;
+
+// The table is kept from move to move, positions repeat a lot between two turns
+static void ai_player_prepare(const AiJob* job)
+{
+    if (_search.table == nullptr) ai_search_init(&_search, _table_entries);
+    if (_table_dictionary != job->snapshot->dictionary.id) {
+        ai_search_clear(&_search);
+        _table_dictionary = job->snapshot->dictionary.id;
+    }
+    _search.dictionary = &job->snapshot->dictionary;
+    _search.seed = job->game.random_state;
+}
+
+static AiJob ai_player_make_job(const Game* game, DictionarySnapshot* snapshot, AiDifficulty difficulty, int moves_left)
+{
+    AiJob job;
+    job.game = *game;
+    job.snapshot = snapshot;
+    job.max_depth = AI_LEVELS[difficulty].max_depth;
+    if (moves_left < job.max_depth) job.max_depth = (moves_left > 1) ? moves_left : 1;
+    job.budget = AI_LEVELS[difficulty].budget;
+    job.id = ++_job_id;
+    dictionary_snapshot_retain(snapshot);
+    return job;
+}
+
+#if defined(AI_USE_THREAD)
+
+static std::mutex _mutex;           // Guards everything below and _job_id
+static std::condition_variable _signal;
+static std::thread _worker;
+static std::atomic<bool> _cancel{ false };
+static AiJob _job;
+static bool _job_pending = false;
+static AiResult _result;
+static bool _ready = false;
+static bool _stop = false;
+
+static void ai_player_worker()
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (true) {
+        _signal.wait(lock, [] { return _job_pending || _stop; });
+        if (_stop) break;
+
+        AiJob job = _job;
+        _job_pending = false;
+        _cancel.store(false);
+        lock.unlock();
+
+        ai_player_prepare(&job);
+        _search.cancel = &_cancel;
+        AiResult result;
+        ai_search(&_search, &job.game, job.max_depth, job.budget, &result);
+        _search.dictionary = nullptr;
+        dictionary_snapshot_release(job.snapshot);
+
+        lock.lock();
+        if (job.id == _job_id) {
+            _result = result;
+            _ready = true;
+        }
+    }
+}
+
+// Caller holds the lock
+static void ai_player_drop_job()
+{
+    if (_job_pending) dictionary_snapshot_release(_job.snapshot);
+    _job_pending = false;
+    _ready = false;
+    _thinking = false;
+    _cancel.store(true);
+    ++_job_id;
+}
+
+void ai_player_start(const Game* game, DictionarySnapshot* snapshot, AiDifficulty difficulty, int moves_left)
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        ai_player_drop_job();
+        _job = ai_player_make_job(game, snapshot, difficulty, moves_left);
+        _job_pending = true;
+        _thinking = true;
+        if (!_worker.joinable()) {
+            _stop = false;
+            _worker = std::thread(ai_player_worker);
+        }
+    }
+    _signal.notify_one();
+}
+
+bool ai_player_poll(AiResult* result)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (!_ready) return false;
+    *result = _result;
+    _ready = false;
+    _thinking = false;
+    return true;
+}
+
+bool ai_player_thinking()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _thinking;
+}
+
+void ai_player_cancel()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    ai_player_drop_job();
+}
+
+void ai_player_shutdown()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        ai_player_drop_job();
+        _stop = true;
+    }
+    _signal.notify_one();
+    if (_worker.joinable()) _worker.join();
+    ai_search_unload(&_search);
+}
+
+#else
+
+static AiJob _job;
+static AiResult _result;
+static double _started = 0;
+
+static void ai_player_drop_job()
+{
+    if (_thinking) dictionary_snapshot_release(_job.snapshot);
+    _thinking = false;
+    ++_job_id;
+}
+
+void ai_player_start(const Game* game, DictionarySnapshot* snapshot, AiDifficulty difficulty, int moves_left)
+{
+    ai_player_drop_job();
+    _job = ai_player_make_job(game, snapshot, difficulty, moves_left);
+    _result = AiResult{};
+    _started = GetTime();
+    _thinking = true;
+}
+
+// Each poll deepens for one slice, finished depths are kept and the pass that did not finish
+// in a slice is repeated in the next one from the transposition table. The budget is wall
+// clock time since the start like on the desktop, the computer takes as long to move but
+// searches only for the slices of the frames in between
+bool ai_player_poll(AiResult* result)
+{
+    if (!_thinking) return false;
+
+    ai_player_prepare(&_job);
+    double left = _job.budget - (GetTime() - _started);
+    bool done = left <= 0 || ai_search(&_search, &_job.game, _job.max_depth, (left < _web_slice) ? left : _web_slice, &_result);
+    if (!done && GetTime() - _started < _job.budget) return false;
+
+    *result = _result;
+    ai_player_drop_job();
+    return true;
+}
+
+bool ai_player_thinking()
+{
+    return _thinking;
+}
+
+void ai_player_cancel()
+{
+    ai_player_drop_job();
+}
+
+void ai_player_shutdown()
+{
+    ai_player_drop_job();
+    ai_search_unload(&_search);
+}
+
+#endif
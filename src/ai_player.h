@@ -0,0 +1,37 @@
+/*******************************************************************************************
+*
+*   WordGrid
+*   Simple Word Puzzle Game
+*   (C) Harald Scheirich 2024
+*   WordGrid is is licensed under an unmodified zlib/libpng license see LICENSE
+*
+*   Computer opponent that thinks without holding up the frame
+*
+*   ai_player_start() hands a copy of the game to a background thread that runs
+*   ai_search() until the time budget of the difficulty is used up, the game screen polls
+*   for the move every frame. On the web there are no threads, every poll searches for a
+*   short slice of the frame instead and the move is ready once the budget is spent
+*
+********************************************************************************************/
+
+#pragma once
+
+#include "ai_search.h"
+#include "dictionary_snapshot.h"
+#include "game.h"
+
+// Thinks about the move of the side to move in `game`, looking no further than
+// `moves_left` moves. Keeps a reference to `snapshot` until the search ends, a search
+// that is still running is cancelled
+void ai_player_start(const Game* game, DictionarySnapshot* snapshot, AiDifficulty difficulty, int moves_left);
+
+// True once the move of the last start is ready, `result->depth` is 0 if there is none
+bool ai_player_poll(AiResult* result);
+
+bool ai_player_thinking();
+
+// Drops the running search, its move is never returned
+void ai_player_cancel();
+
+// Stops the background thread and frees the transposition table
+void ai_player_shutdown();
@@ -0,0 +1,311 @@
+/*******************************************************************************************
+*
+*   WordGrid
+*   Simple Word Puzzle Game
+*   (C) Harald Scheirich 2024
+*   WordGrid is is licensed under an unmodified zlib/libpng license see LICENSE
+*
+*   Move search for the computer opponent of the versus mode
+*
+*   Both sides play from the same board and well, so the value of a position is the same
+*   for whoever is to move: the words that side can still win minus the words the other
+*   side wins after it. ai_search() runs a negamax with alpha-beta over these gains and
+*   deepens one move at a time until the depth or time budget is used up, the best move of
+*   the deepest finished pass is the answer at any time
+*
+*   Tiles that refill the well are drawn from the random state of Game, the search does
+*   not peek at them, a slot that was played stays empty further down. Positions are
+*   hashed with Zobrist keys of the board and the well into a fixed size transposition
+*   table that outlives a search, a later call continues where the last one stopped
+*
+********************************************************************************************/
+
+#pragma once
+
+#include "raylib.h"
+#include "dictionary.h"
+#include "game.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <atomic>
+#include <chrono>
+
+enum AiDifficulty {
+    AI_EASY,
+    AI_NORMAL,
+    AI_HARD,
+    AI_DIFFICULTY_COUNT
+};
+
+// Levels only differ in how long and how deep the computer looks ahead
+struct AiLevel {
+    const char* name;
+    double budget;          // Seconds per move
+    int max_depth;          // In moves of both sides
+};
+
+static const AiLevel AI_LEVELS[AI_DIFFICULTY_COUNT] = {
+    { "Easy", 0.05, 1 },
+    { "Normal", 0.3, 2 },
+    { "Hard", 1.5, 4 },
+};
+
+static const int AI_TILE_KEYS = SPECIAL_END + 1;    // GAME_EMPTY and every tile
+static const int AI_MAX_MOVES = GAME_WELL_SIZE * GAME_MAX_CELLS;
+static const int AI_NO_MOVE = 0xFF;
+static const int AI_INFINITY = 1 << 14;
+
+enum AiBound : uint8_t {
+    AI_BOUND_EXACT,
+    AI_BOUND_LOWER,         // The value is at least this
+    AI_BOUND_UPPER,         // The value is at most this
+};
+
+struct AiEntry {
+    uint64_t key;
+    int16_t value;
+    int8_t depth;
+    AiBound bound;
+    uint8_t move;           // Best move found, AI_NO_MOVE if none
+};
+
+struct AiZobrist {
+    uint64_t cells[GAME_MAX_CELLS][AI_TILE_KEYS];
+    uint64_t well[GAME_WELL_SIZE][AI_TILE_KEYS];
+};
+
+struct AiSearch {
+    AiEntry* table = nullptr;
+    uint32_t table_mask = 0;
+    const Dictionary* dictionary = nullptr;
+    std::chrono::steady_clock::time_point deadline;
+    const std::atomic<bool>* cancel = nullptr;  // Optional, stops the search when set
+    uint64_t seed = 0;                          // Orders equal moves differently per search
+    int64_t nodes = 0;
+    bool aborted = false;
+};
+
+// Best move of the deepest finished pass, `depth` is 0 before the first one
+struct AiResult {
+    int well_index = -1;
+    int x = -1;
+    int y = -1;
+    int value = 0;
+    int depth = 0;
+    int64_t nodes = 0;
+};
+
+inline uint64_t ai_mix(uint64_t* state)
+{
+    // splitmix64, the same mixer Game uses
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+inline const AiZobrist* ai_zobrist()
+{
+    static const AiZobrist* keys = []() {
+        static AiZobrist result;
+        uint64_t state = 0x5745524447524944ull;
+        for (int i = 0; i < GAME_MAX_CELLS; ++i) {
+            for (int tile = 0; tile < AI_TILE_KEYS; ++tile) result.cells[i][tile] = ai_mix(&state);
+        }
+        for (int i = 0; i < GAME_WELL_SIZE; ++i) {
+            for (int tile = 0; tile < AI_TILE_KEYS; ++tile) result.well[i][tile] = ai_mix(&state);
+        }
+        return &result;
+    }();
+    return keys;
+}
+
+inline uint64_t ai_hash(const Game* game)
+{
+    const AiZobrist* keys = ai_zobrist();
+    uint64_t result = 0;
+    for (int i = 0; i < game->rows * game->columns; ++i) result ^= keys->cells[i][game->letters[i] + 1];
+    for (int i = 0; i < GAME_WELL_SIZE; ++i) result ^= keys->well[i][game->well[i] + 1];
+    return result;
+}
+
+// `entries` is rounded down to a power of two
+inline void ai_search_init(AiSearch* search, int entries)
+{
+    uint32_t size = 1;
+    while (size * 2 <= (uint32_t)entries) size *= 2;
+    *search = AiSearch{};
+    search->table = (AiEntry*)RL_CALLOC(size, sizeof(AiEntry));
+    search->table_mask = size - 1;
+}
+
+inline void ai_search_unload(AiSearch* search)
+{
+    RL_FREE(search->table);
+    *search = AiSearch{};
+}
+
+inline void ai_search_clear(AiSearch* search)
+{
+    memset(search->table, 0, (search->table_mask + 1) * sizeof(AiEntry));
+}
+
+inline int ai_move_well(int move) { return move / GAME_MAX_CELLS; }
+inline int ai_move_cell(int move) { return move % GAME_MAX_CELLS; }
+
+// Legal moves, a tile that is in the well twice is only tried once
+inline int ai_generate_moves(const Game* game, uint8_t* moves)
+{
+    int count = 0;
+    for (int w = 0; w < GAME_WELL_SIZE; ++w) {
+        int tile = game->well[w];
+        if (tile == GAME_EMPTY) continue;
+        bool repeated = false;
+        for (int v = 0; v < w && !repeated; ++v) repeated = game->well[v] == tile;
+        if (repeated) continue;
+        for (int cell = 0; cell < game->rows * game->columns; ++cell) {
+            if (is_special(tile) || game->letters[cell] == GAME_EMPTY) moves[count++] = (uint8_t)(w * GAME_MAX_CELLS + cell);
+        }
+    }
+    return count;
+}
+
+// Plays `move` on `child`, returns the words it made or -1 if it is not legal
+inline int ai_play(const AiSearch* search, Game* child, int move)
+{
+    int well_index = ai_move_well(move);
+    int cell = ai_move_cell(move);
+    CheckResult result = CHECK_RESULT_NONE;
+    if (!game_play(child, search->dictionary, well_index, cell / child->rows, cell % child->rows, &result)) return -1;
+    child->well[well_index] = GAME_EMPTY;
+    return ((result & CHECK_RESULT_HORIZONTAL) != 0 ? 1 : 0) + ((result & CHECK_RESULT_VERTICAL) != 0 ? 1 : 0);
+}
+
+inline bool ai_out_of_time(AiSearch* search)
+{
+    if ((++search->nodes & 255) == 0) {
+        bool cancelled = search->cancel != nullptr && search->cancel->load(std::memory_order_relaxed);
+        if (cancelled || std::chrono::steady_clock::now() > search->deadline) search->aborted = true;
+    }
+    return search->aborted;
+}
+
+// Words the side to move wins from `game` within `depth` moves, minus what the other side wins
+inline int ai_negamax(AiSearch* search, const Game* game, int depth, int alpha, int beta)
+{
+    if (depth == 0 || ai_out_of_time(search)) return 0;
+
+    uint64_t key = ai_hash(game);
+    AiEntry* entry = &search->table[key & search->table_mask];
+    int hint = AI_NO_MOVE;
+    if (entry->key == key) {
+        hint = entry->move;
+        if (entry->depth >= depth) {
+            if (entry->bound == AI_BOUND_EXACT) return entry->value;
+            if (entry->bound == AI_BOUND_LOWER && entry->value >= beta) return entry->value;
+            if (entry->bound == AI_BOUND_UPPER && entry->value <= alpha) return entry->value;
+        }
+    }
+
+    uint8_t moves[AI_MAX_MOVES];
+    int count = ai_generate_moves(game, moves);
+    for (int i = 0; i < count; ++i) {
+        if (moves[i] == hint) {
+            moves[i] = moves[0];
+            moves[0] = (uint8_t)hint;
+            break;
+        }
+    }
+
+    int original_alpha = alpha;
+    int best = (count > 0) ? -AI_INFINITY : 0;
+    int best_move = AI_NO_MOVE;
+    for (int i = 0; i < count; ++i) {
+        Game child = *game;
+        int words = ai_play(search, &child, moves[i]);
+        if (words < 0) continue;
+        int value = words - ai_negamax(search, &child, depth - 1, words - beta, words - alpha);
+        if (search->aborted) return 0;
+        if (value > best) {
+            best = value;
+            best_move = moves[i];
+        }
+        if (value > alpha) alpha = value;
+        if (alpha >= beta) break;
+    }
+    if (best == -AI_INFINITY) best = 0;
+
+    // Deeper results replace shallower ones, any result replaces another position
+    if (entry->key != key || entry->depth <= depth) {
+        entry->key = key;
+        entry->value = (int16_t)best;
+        entry->depth = (int8_t)depth;
+        entry->move = (uint8_t)best_move;
+        entry->bound = (best <= original_alpha) ? AI_BOUND_UPPER : (best >= beta) ? AI_BOUND_LOWER : AI_BOUND_EXACT;
+    }
+    return best;
+}
+
+// Deepens from `result->depth + 1` up to `max_depth` until `budget` seconds are used, a
+// first pass never looks at the clock. Returns true when `max_depth` was reached or there are no
+// moves, later calls with the same `result` continue the search
+inline bool ai_search(AiSearch* search, const Game* game, int max_depth, double budget, AiResult* result)
+{
+    search->deadline = std::chrono::steady_clock::now() +
+        std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(budget));
+
+    uint8_t moves[AI_MAX_MOVES];
+    int count = ai_generate_moves(game, moves);
+    if (count == 0) return true;
+
+    // Equal moves are tried in a different order every game
+    uint64_t state = search->seed ^ ai_hash(game);
+    for (int i = count - 1; i > 0; --i) {
+        int j = (int)(ai_mix(&state) % (uint64_t)(i + 1));
+        uint8_t swap = moves[i];
+        moves[i] = moves[j];
+        moves[j] = swap;
+    }
+
+    for (int depth = result->depth + 1; depth <= max_depth; ++depth) {
+        search->aborted = false;
+
+        int best = -AI_INFINITY;
+        int best_move = AI_NO_MOVE;
+        int alpha = -AI_INFINITY;
+        for (int i = 0; i < count; ++i) {
+            Game child = *game;
+            int words = ai_play(search, &child, moves[i]);
+            if (words < 0) continue;
+            int value = words - ai_negamax(search, &child, depth - 1, -AI_INFINITY, words - alpha);
+            if (search->aborted) break;
+            if (value > best) {
+                best = value;
+                best_move = moves[i];
+            }
+            if (value > alpha) alpha = value;
+        }
+        if (search->aborted) return false;
+        if (best_move == AI_NO_MOVE) return true;
+
+        // The best move goes first in the next pass
+        for (int i = 0; i < count; ++i) {
+            if (moves[i] == best_move) {
+                moves[i] = moves[0];
+                moves[0] = (uint8_t)best_move;
+                break;
+            }
+        }
+        int cell = ai_move_cell(best_move);
+        result->well_index = ai_move_well(best_move);
+        result->x = cell / game->rows;
+        result->y = cell % game->rows;
+        result->value = best;
+        result->depth = depth;
+        result->nodes = search->nodes;
+    }
+    return true;
+}
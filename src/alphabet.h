@@ -0,0 +1,98 @@
+/*******************************************************************************************
+*
+*   WordGrid
+*   Simple Word Puzzle Game
+*   (C) Harald Scheirich 2024
+*   WordGrid is is licensed under an unmodified zlib/libpng license see LICENSE
+*
+********************************************************************************************/
+
+#pragma once
+
+#include "raylib.h"
+
+#include <stdlib.h>
+
+// Letters are stored as dense indices into the alphabet of the loaded language,
+// index 0 is reserved as the word terminator so valid letters run from 1 to count
+static const int ALPHABET_MAX_LETTERS = 63;
+
+struct Alphabet {
+    int count = 0;  // Number of letters, indices are 1 .. count
+    int bits = 0;   // Bits needed to store one letter index
+    int codepoints[ALPHABET_MAX_LETTERS + 1] = { 0 }; // Sorted, codepoints[0] is unused
+};
+
+static int alphabet_compare_codepoints(const void* a, const void* b)
+{
+    return *(const int*)a - *(const int*)b;
+}
+
+// Collects all distinct codepoints from `codepoints` into a sorted alphabet, linebreaks and 0 are skipped
+inline bool alphabet_build(Alphabet* alphabet, const int* codepoints, int codepoint_count)
+{
+    *alphabet = Alphabet{};
+    for (int i = 0; i < codepoint_count; ++i) {
+        int c = codepoints[i];
+        if (c == 0 || c == '\r' || c == '\n') continue;
+
+        bool found = false;
+        for (int j = 1; j <= alphabet->count && !found; ++j) {
+            found = alphabet->codepoints[j] == c;
+        }
+        if (found) continue;
+
+        if (alphabet->count == ALPHABET_MAX_LETTERS) {
+            TraceLog(LOG_ERROR, "Alphabet has more than %i letters, ignoring codepoint %i", ALPHABET_MAX_LETTERS, c);
+            return false;
+        }
+        alphabet->codepoints[++alphabet->count] = c;
+    }
+
+    qsort(&alphabet->codepoints[1], alphabet->count, sizeof(int), alphabet_compare_codepoints);
+
+    alphabet->bits = 1;
+    while ((1 << alphabet->bits) <= alphabet->count) alphabet->bits++;
+
+    TraceLog(LOG_INFO, "Alphabet with %i letters, %i bits per letter", alphabet->count, alphabet->bits);
+    return true;
+}
+
+// Returns the dense index for `codepoint` or 0 if it is not part of the alphabet
+inline int alphabet_get_index(const Alphabet* alphabet, int codepoint)
+{
+    int low = 1;
+    int high = alphabet->count;
+    while (low <= high) {
+        int mid = (low + high) / 2;
+        if (alphabet->codepoints[mid] == codepoint) return mid;
+        if (alphabet->codepoints[mid] < codepoint) low = mid + 1;
+        else high = mid - 1;
+    }
+    return 0;
+}
+
+inline int alphabet_get_codepoint(const Alphabet* alphabet, int index)
+{
+    if (index < 1 || index > alphabet->count) return 0;
+    return alphabet->codepoints[index];
+}
+
+// Converts utf8 `text` into 0 terminated letter indices, returns the number of letters
+// or -1 if a codepoint is not in the alphabet or `letters` is too small
+inline int alphabet_encode(const Alphabet* alphabet, const char* text, int* letters, int max_letters)
+{
+    int count = 0;
+    while (*text != 0) {
+        if (count >= max_letters - 1) return -1;
+
+        int size = 0;
+        int index = alphabet_get_index(alphabet, GetCodepointNext(text, &size));
+        if (index == 0) return -1;
+
+        letters[count++] = index;
+        text += size;
+    }
+    letters[count] = 0;
+    return count;
+}
@@ -0,0 +1,198 @@
+/*******************************************************************************************
+*
+*   WordGrid
+*   Simple Word Puzzle Game
+*   (C) Harald Scheirich 2024
+*   WordGrid is is licensed under an unmodified zlib/libpng license see LICENSE
+*
+*   Words by their letters, for finding what can be made from the well
+*
+*   The signature of a word is its letters sorted and packed like word_cache_pack(), all
+*   anagrams share it. The short words are kept sorted by signature and a hash table maps
+*   each signature to its run of words. A line of the board is completed by some subset of
+*   the well, anagram_fill_line() tries every subset of the right size together with the
+*   letters already on the line and keeps the words that match them in place
+*
+********************************************************************************************/
+
+#pragma once
+
+#include "raylib.h"
+#include "dictionary.h"
+#include "word_cache.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <bit>
+
+static const int ANAGRAM_MAX_WELL = 8;      // Subsets are enumerated as bitmasks
+
+struct AnagramSlot {
+    uint32_t signature;     // 0 for free slots
+    int first;
+    int count;
+};
+
+struct AnagramIndex {
+    uint32_t* words = nullptr;      // Packed words, grouped by signature
+    int word_count = 0;
+    AnagramSlot* slots = nullptr;
+    uint32_t mask = 0;
+};
+
+inline uint32_t anagram_signature(const int* letters, int count)
+{
+    int sorted[WORD_CACHE_MAX_LETTERS];
+    for (int i = 0; i < count; ++i) {
+        int j = i;
+        for (; j > 0 && sorted[j - 1] > letters[i]; --j) sorted[j] = sorted[j - 1];
+        sorted[j] = letters[i];
+    }
+    uint32_t result = 0;
+    for (int i = 0; i < count; ++i) result |= (uint32_t)sorted[i] << (i * WORD_CACHE_LETTER_BITS);
+    return result;
+}
+
+inline int anagram_unpack(uint32_t word, int* letters)
+{
+    int count = 0;
+    while (count < WORD_CACHE_MAX_LETTERS && (word & 63u) != 0) {
+        letters[count++] = (int)(word & 63u);
+        word >>= WORD_CACHE_LETTER_BITS;
+    }
+    return count;
+}
+
+inline uint32_t anagram_slot_index(uint32_t signature, uint32_t mask)
+{
+    return ((signature * 0x9E3779B1u) >> 7) & mask;
+}
+
+inline void anagram_index_unload(AnagramIndex* index)
+{
+    RL_FREE(index->words);
+    RL_FREE(index->slots);
+    *index = AnagramIndex{};
+}
+
+static int anagram_compare_entries(const void* a, const void* b)
+{
+    const uint64_t left = *(const uint64_t*)a;
+    const uint64_t right = *(const uint64_t*)b;
+    return (left > right) - (left < right);
+}
+
+// Takes the words of up to WORD_CACHE_MAX_LETTERS letters, longer ones are never on the board
+inline void anagram_index_build(AnagramIndex* index, const Dictionary* dictionary)
+{
+    anagram_index_unload(index);
+
+    // Signature in the upper half, the word in the lower, sorting groups the anagrams
+    uint64_t* entries = (uint64_t*)RL_MALLOC((dictionary->word_count > 0 ? dictionary->word_count : 1) * sizeof(uint64_t));
+    int count = 0;
+    int letters[WORD_CACHE_MAX_LETTERS + 1];
+    for (int offset = 0; offset < dictionary->words_size;) {
+        int length = 0;
+        while (offset < dictionary->words_size && dictionary->words[offset] != 0) {
+            if (length < WORD_CACHE_MAX_LETTERS) letters[length] = dictionary->words[offset];
+            length++;
+            offset++;
+        }
+        offset++;
+        uint32_t word = 0;
+        if (length == 0 || length > WORD_CACHE_MAX_LETTERS) continue;
+        letters[length] = 0;
+        if (count < dictionary->word_count && word_cache_pack(letters, length + 1, &word)) {
+            entries[count++] = ((uint64_t)anagram_signature(letters, length) << 32) | word;
+        }
+    }
+    qsort(entries, count, sizeof(uint64_t), anagram_compare_entries);
+
+    uint32_t capacity = 16;
+    while (capacity < (uint32_t)count * 2) capacity *= 2;
+    index->slots = (AnagramSlot*)RL_CALLOC(capacity, sizeof(AnagramSlot));
+    index->mask = capacity - 1;
+    index->words = (uint32_t*)RL_MALLOC((count > 0 ? count : 1) * sizeof(uint32_t));
+
+    for (int i = 0; i < count; ++i) {
+        if (i > 0 && entries[i] == entries[i - 1]) continue;    // Listed twice
+        uint32_t signature = (uint32_t)(entries[i] >> 32);
+        uint32_t slot = anagram_slot_index(signature, index->mask);
+        while (index->slots[slot].signature != 0 && index->slots[slot].signature != signature) slot = (slot + 1) & index->mask;
+        if (index->slots[slot].signature == 0) index->slots[slot] = AnagramSlot{ signature, index->word_count, 0 };
+        index->slots[slot].count++;
+        index->words[index->word_count++] = (uint32_t)entries[i];
+    }
+    RL_FREE(entries);
+}
+
+// Words with exactly these letters in any order
+inline int anagram_find(const AnagramIndex* index, const int* letters, int count, const uint32_t** words)
+{
+    *words = nullptr;
+    if (index->slots == nullptr || count <= 0 || count > WORD_CACHE_MAX_LETTERS) return 0;
+    uint32_t signature = anagram_signature(letters, count);
+    for (uint32_t slot = anagram_slot_index(signature, index->mask); index->slots[slot].signature != 0; slot = (slot + 1) & index->mask) {
+        if (index->slots[slot].signature == signature) {
+            *words = index->words + index->slots[slot].first;
+            return index->slots[slot].count;
+        }
+    }
+    return 0;
+}
+
+// Counts the words that complete `line` with tiles from `well`. Empty cells of the line are
+// 0, well entries that are not letters are skipped. Bit i of `used` is set for every well
+// tile i that is part of one of the words
+inline int anagram_fill_line(const AnagramIndex* index, const int* line, int length, const int* well, int well_count, uint32_t* used)
+{
+    *used = 0;
+    if (length <= 0 || length > WORD_CACHE_MAX_LETTERS || well_count > ANAGRAM_MAX_WELL) return 0;
+
+    int letters[WORD_CACHE_MAX_LETTERS];
+    int fixed = 0;
+    for (int i = 0; i < length; ++i) {
+        if (line[i] != 0) letters[fixed++] = line[i];
+    }
+    int missing = length - fixed;
+    if (missing == 0) return 0;
+
+    uint32_t playable = 0;
+    for (int i = 0; i < well_count; ++i) {
+        if (well[i] > 0 && well[i] <= ALPHABET_MAX_LETTERS) playable |= 1u << i;
+    }
+
+    // Subsets with the same letters find the same words, they are counted once
+    uint32_t seen[1 << ANAGRAM_MAX_WELL];
+    int seen_count = 0;
+    int result = 0;
+    for (uint32_t subset = playable; subset != 0; subset = (subset - 1) & playable) {
+        if (std::popcount(subset) != missing) continue;
+        int count = fixed;
+        for (int i = 0; i < well_count; ++i) {
+            if ((subset & (1u << i)) != 0) letters[count++] = well[i];
+        }
+        uint32_t signature = anagram_signature(letters, length);
+        bool repeated = false;
+        for (int i = 0; i < seen_count && !repeated; ++i) repeated = seen[i] == signature;
+
+        const uint32_t* words = nullptr;
+        int found = anagram_find(index, letters, length, &words);
+        int matches = 0;
+        for (int w = 0; w < found; ++w) {
+            int word[WORD_CACHE_MAX_LETTERS];
+            if (anagram_unpack(words[w], word) != length) continue;
+            bool fits = true;
+            for (int i = 0; i < length && fits; ++i) fits = line[i] == 0 || line[i] == word[i];
+            matches += fits ? 1 : 0;
+        }
+        if (matches > 0) *used |= subset;
+        if (!repeated) {
+            seen[seen_count++] = signature;
+            result += matches;
+        }
+    }
+    return result;
+}
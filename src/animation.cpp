@@ -0,0 +1,168 @@
+/*******************************************************************************************
+*
+*   WordGrid
+*   Simple Word Puzzle Game
+*   (C) Harald Scheirich 2024
+*   WordGrid is is licensed under an unmodified zlib/libpng license see LICENSE
+*
+********************************************************************************************/
+
+#include "animation.h"
+
+float ease(Easing easing, float t)
+{
+    switch (easing) {
+    case EASE_OUT_CUBIC: {
+        float val = 1.0f - t;
+        return 1.0f - val * val * val;
+    }
+    case EASE_IN_CUBIC:
+        return t * t * t;
+    case EASE_OUT_BACK: {
+        const float c1 = 1.70158f;
+        const float c3 = c1 + 1.0f;
+        float val = t - 1.0f;
+        return 1.0f + c3 * val * val * val + c1 * val * val;
+    }
+    default:
+        return t;
+    }
+}
+
+void animation_pool_clear(AnimationPool* pool)
+{
+    pool->count = 0;
+}
+
+static void animation_pool_set(AnimationPool* pool, int i, const AnimationDesc& desc)
+{
+    pool->tile[i] = desc.tile;
+    pool->key[i] = desc.key;
+    pool->source[i] = desc.source;
+    pool->start[i] = desc.start;
+    pool->end[i] = desc.end;
+    pool->position[i] = desc.start;
+    pool->start_scale[i] = desc.start_scale;
+    pool->end_scale[i] = desc.end_scale;
+    pool->scale[i] = desc.start_scale;
+    pool->start_alpha[i] = desc.start_alpha;
+    pool->end_alpha[i] = desc.end_alpha;
+    pool->alpha[i] = desc.start_alpha;
+    pool->time[i] = -desc.delay;
+    pool->duration[i] = (desc.duration > 0.0f) ? desc.duration : 0.001f;
+    pool->easing[i] = (unsigned char)desc.easing;
+    pool->on_done[i] = desc.on_done;
+}
+
+static void animation_pool_move(AnimationPool* pool, int from, int to)
+{
+    pool->tile[to] = pool->tile[from];
+    pool->key[to] = pool->key[from];
+    pool->source[to] = pool->source[from];
+    pool->start[to] = pool->start[from];
+    pool->end[to] = pool->end[from];
+    pool->position[to] = pool->position[from];
+    pool->start_scale[to] = pool->start_scale[from];
+    pool->end_scale[to] = pool->end_scale[from];
+    pool->scale[to] = pool->scale[from];
+    pool->start_alpha[to] = pool->start_alpha[from];
+    pool->end_alpha[to] = pool->end_alpha[from];
+    pool->alpha[to] = pool->alpha[from];
+    pool->time[to] = pool->time[from];
+    pool->duration[to] = pool->duration[from];
+    pool->easing[to] = pool->easing[from];
+    pool->on_done[to] = pool->on_done[from];
+}
+
+bool animation_pool_add(AnimationPool* pool, const AnimationDesc& desc)
+{
+    if (pool->count >= ANIMATION_POOL_CAPACITY) {
+        TraceLog(LOG_WARNING, "Animation pool is full, skipping animation");
+        if (desc.on_done != nullptr) desc.on_done(desc.tile, desc.key);
+        return false;
+    }
+    animation_pool_set(pool, pool->count, desc);
+    pool->count++;
+    return true;
+}
+
+struct AnimationFinished {
+    AnimationDone on_done;
+    int tile;
+    int key;
+};
+
+// Removes the animations that are marked as finished and then calls their callbacks
+static void animation_pool_compact(AnimationPool* pool, const bool* finished)
+{
+    AnimationFinished done[ANIMATION_POOL_CAPACITY];
+    int done_count = 0;
+
+    int write = 0;
+    for (int i = 0; i < pool->count; ++i) {
+        if (finished[i]) {
+            if (pool->on_done[i] != nullptr) {
+                done[done_count++] = AnimationFinished{ pool->on_done[i], pool->tile[i], pool->key[i] };
+            }
+            continue;
+        }
+        if (write != i) animation_pool_move(pool, i, write);
+        write++;
+    }
+    pool->count = write;
+
+    for (int i = 0; i < done_count; ++i) {
+        done[i].on_done(done[i].tile, done[i].key);
+    }
+}
+
+void animation_pool_update(AnimationPool* pool, float dt)
+{
+    bool finished[ANIMATION_POOL_CAPACITY];
+    bool any_finished = false;
+
+    for (int i = 0; i < pool->count; ++i) {
+        float time = pool->time[i] + dt;
+        pool->time[i] = time;
+        finished[i] = time >= pool->duration[i];
+        any_finished |= finished[i];
+
+        float t = (time <= 0.0f) ? 0.0f : (finished[i] ? 1.0f : time / pool->duration[i]);
+        float val = ease((Easing)pool->easing[i], t);
+        pool->position[i].x = pool->start[i].x + (pool->end[i].x - pool->start[i].x) * val;
+        pool->position[i].y = pool->start[i].y + (pool->end[i].y - pool->start[i].y) * val;
+        pool->scale[i] = pool->start_scale[i] + (pool->end_scale[i] - pool->start_scale[i]) * val;
+        pool->alpha[i] = pool->start_alpha[i] + (pool->end_alpha[i] - pool->start_alpha[i]) * val;
+    }
+
+    if (any_finished) animation_pool_compact(pool, finished);
+}
+
+void animation_pool_complete(AnimationPool* pool, int key)
+{
+    bool finished[ANIMATION_POOL_CAPACITY];
+    bool any_finished = false;
+    for (int i = 0; i < pool->count; ++i) {
+        finished[i] = pool->key[i] == key;
+        any_finished |= finished[i];
+    }
+    if (any_finished) animation_pool_compact(pool, finished);
+}
+
+void animation_pool_draw(const AnimationPool* pool, Texture2D texture, float size)
+{
+    for (int i = 0; i < pool->count; ++i) {
+        if (pool->time[i] < 0.0f) continue;
+
+        float scaled = size * pool->scale[i];
+        float offset = (size - scaled) / 2.0f;
+        Rectangle target = {
+            .x = pool->position[i].x + offset,
+            .y = pool->position[i].y + offset,
+            .width = scaled,
+            .height = scaled,
+        };
+        float alpha = (pool->alpha[i] < 0.0f) ? 0.0f : (pool->alpha[i] > 1.0f ? 1.0f : pool->alpha[i]);
+        DrawTexturePro(texture, pool->source[i], target, Vector2{ 0, 0 }, 0, Fade(WHITE, alpha));
+    }
+}
@@ -0,0 +1,85 @@
+/*******************************************************************************************
+*
+*   WordGrid
+*   Simple Word Puzzle Game
+*   (C) Harald Scheirich 2024
+*   WordGrid is is licensed under an unmodified zlib/libpng license see LICENSE
+*
+*   Fixed capacity pool of tile animations, stored as arrays per property so that the
+*   update is one loop over dense data. All animations draw from the same texture which
+*   raylib submits as one batch
+*
+********************************************************************************************/
+
+#pragma once
+
+#include "raylib.h"
+
+static const int ANIMATION_POOL_CAPACITY = 64;
+
+enum Easing {
+    EASE_LINEAR,
+    EASE_OUT_CUBIC,
+    EASE_IN_CUBIC,
+    EASE_OUT_BACK,
+    EASE_COUNT
+};
+
+float ease(Easing easing, float t);
+
+// Called once the animation has finished, `tile` and `key` are the values passed on add
+using AnimationDone = void(*)(int tile, int key);
+
+// Everything that is needed to start one animation, position is the top left corner of
+// the tile, scale and alpha are applied around the center
+struct AnimationDesc {
+    int tile = -1;
+    int key = -1;
+    Rectangle source = { 0 };
+    Vector2 start = { 0 };
+    Vector2 end = { 0 };
+    float start_scale = 1.0f;
+    float end_scale = 1.0f;
+    float start_alpha = 1.0f;
+    float end_alpha = 1.0f;
+    float delay = 0.0f;
+    float duration = 0.5f;
+    Easing easing = EASE_OUT_CUBIC;
+    AnimationDone on_done = nullptr;
+};
+
+struct AnimationPool {
+    int count = 0;
+    int tile[ANIMATION_POOL_CAPACITY];
+    int key[ANIMATION_POOL_CAPACITY];
+    Rectangle source[ANIMATION_POOL_CAPACITY];
+    Vector2 start[ANIMATION_POOL_CAPACITY];
+    Vector2 end[ANIMATION_POOL_CAPACITY];
+    Vector2 position[ANIMATION_POOL_CAPACITY];
+    float start_scale[ANIMATION_POOL_CAPACITY];
+    float end_scale[ANIMATION_POOL_CAPACITY];
+    float scale[ANIMATION_POOL_CAPACITY];
+    float start_alpha[ANIMATION_POOL_CAPACITY];
+    float end_alpha[ANIMATION_POOL_CAPACITY];
+    float alpha[ANIMATION_POOL_CAPACITY];
+    float time[ANIMATION_POOL_CAPACITY];        // Negative while delayed
+    float duration[ANIMATION_POOL_CAPACITY];
+    unsigned char easing[ANIMATION_POOL_CAPACITY];
+    AnimationDone on_done[ANIMATION_POOL_CAPACITY];
+};
+
+void animation_pool_clear(AnimationPool* pool);
+
+// Returns false when the pool is full, the animation is dropped and its callback runs
+// right away so that no tile is lost
+bool animation_pool_add(AnimationPool* pool, const AnimationDesc& desc);
+
+// Advances all animations, finished ones are removed before their callbacks run so
+// callbacks may add new animations
+void animation_pool_update(AnimationPool* pool, float dt);
+
+// Finishes all animations with `key` immediately, used when the state they animate towards changes
+void animation_pool_complete(AnimationPool* pool, int key);
+
+// Draws the started animations as quads of `size` from `texture`
+void animation_pool_draw(const AnimationPool* pool, Texture2D texture, float size);
@@ -0,0 +1,138 @@
+/*******************************************************************************************
+*
+*   WordGrid
+*   Simple Word Puzzle Game
+*   (C) Harald Scheirich 2024
+*   WordGrid is is licensed under an unmodified zlib/libpng license see LICENSE
+*
+*   Arena and pool allocators
+*
+*   An Arena is one block that is allocated up front, allocations move an offset forward
+*   and everything is released at once by resetting it, which is O(1). Nothing is freed
+*   individually, running out of space returns nullptr so the memory use of a session is
+*   fixed when it starts. A Pool hands out blocks of one size from an arena and keeps the
+*   ones that were given back in a free list
+*
+*   Arenas are not shared between threads, every thread or session uses its own
+*
+********************************************************************************************/
+
+#pragma once
+
+#include "raylib.h"
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+struct Arena {
+    unsigned char* base = nullptr;
+    size_t capacity = 0;
+    size_t used = 0;
+    size_t peak = 0;            // Highest use since init, to size the arena
+    const char* name = "arena";
+};
+
+inline void arena_init(Arena* arena, size_t capacity, const char* name)
+{
+    *arena = Arena{};
+    arena->base = (unsigned char*)RL_MALLOC(capacity);
+    arena->capacity = (arena->base != nullptr) ? capacity : 0;
+    arena->name = name;
+}
+
+inline void arena_unload(Arena* arena)
+{
+    RL_FREE(arena->base);
+    *arena = Arena{};
+}
+
+inline void arena_reset(Arena* arena)
+{
+    arena->used = 0;
+}
+
+// `alignment` has to be a power of two, returns nullptr when the arena is full
+inline void* arena_alloc(Arena* arena, size_t size, size_t alignment = alignof(max_align_t))
+{
+    size_t start = (arena->used + alignment - 1) & ~(alignment - 1);
+    if (start + size > arena->capacity) {
+        TraceLog(LOG_WARNING, "ARENA: %s is out of space, %zu of %zu bytes used", arena->name, arena->used, arena->capacity);
+        return nullptr;
+    }
+    arena->used = start + size;
+    if (arena->used > arena->peak) arena->peak = arena->used;
+    return arena->base + start;
+}
+
+template <typename T>
+inline T* arena_push(Arena* arena, size_t count = 1)
+{
+    return (T*)arena_alloc(arena, sizeof(T) * count, alignof(T));
+}
+
+// Everything allocated after the mark is released by arena_rewind()
+inline size_t arena_mark(const Arena* arena)
+{
+    return arena->used;
+}
+
+inline void arena_rewind(Arena* arena, size_t mark)
+{
+    if (mark <= arena->used) arena->used = mark;
+}
+
+// Like TextFormat() but the text stays valid until the arena is reset. Returns an empty
+// string when the arena is full
+inline const char* arena_format(Arena* arena, const char* format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    va_list copy;
+    va_copy(copy, args);
+    int length = vsnprintf(nullptr, 0, format, copy);
+    va_end(copy);
+
+    char* text = (length >= 0) ? (char*)arena_alloc(arena, (size_t)length + 1, 1) : nullptr;
+    if (text != nullptr) vsnprintf(text, (size_t)length + 1, format, args);
+    va_end(args);
+    return (text != nullptr) ? text : "";
+}
+
+struct PoolItem {
+    PoolItem* next;
+};
+
+struct Pool {
+    Arena* arena = nullptr;
+    size_t item_size = 0;
+    PoolItem* free_items = nullptr;
+    int live = 0;
+};
+
+inline void pool_init(Pool* pool, Arena* arena, size_t item_size)
+{
+    *pool = Pool{};
+    pool->arena = arena;
+    pool->item_size = (item_size < sizeof(PoolItem)) ? sizeof(PoolItem) : item_size;
+}
+
+// Reuses a freed block before taking a new one from the arena, nullptr when both are out
+inline void* pool_alloc(Pool* pool)
+{
+    void* result = pool->free_items;
+    if (result != nullptr) pool->free_items = pool->free_items->next;
+    else result = arena_alloc(pool->arena, pool->item_size);
+    if (result != nullptr) pool->live++;
+    return result;
+}
+
+inline void pool_free(Pool* pool, void* item)
+{
+    if (item == nullptr) return;
+    PoolItem* freed = (PoolItem*)item;
+    freed->next = pool->free_items;
+    pool->free_items = freed;
+    pool->live--;
+}
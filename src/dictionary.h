@@ -10,8 +10,13 @@
 #pragma once
 
 #include "raylib.h"
+#include "alphabet.h"
 
+#include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
+
+#include <atomic>
 
 enum class LinebreakMode {
     CR,
@@ -19,79 +24,109 @@ enum class LinebreakMode {
     LF
 };
 
+// Every dictionary that is built gets its own id, lookup caches are keyed on it
+inline uint32_t dictionary_next_id()
+{
+    static std::atomic<uint32_t> next{ 0 };
+    return ++next;
+}
+
 struct Dictionary {
-    int *words = nullptr; // 0 separated "strings" of codepoints for the words
+    uint32_t id = dictionary_next_id();   // Copies of the same words share the id
+    Alphabet alphabet;
+    unsigned char *words = nullptr; // 0 separated "strings" of alphabet indices for the words
     int words_size = 0;
     int word_count = 0;
     LinebreakMode mode = LinebreakMode::CRLF;
-    int* distribution = nullptr;
+    int* distribution = nullptr; // Pairs of alphabet index and weight
     int distribution_count = 0;
     int distribution_sum = 0;
+    uint32_t* index = nullptr;  // Optional hash table of word offset + 1, 0 for free slots
+    uint32_t index_mask = 0;
 };
 
 static const char CR = 13;
 static const char LF = 10;
 
-Dictionary dictionary_load(const char* filename)
+inline Dictionary dictionary_load_binary(const char* filename);
+
+inline Dictionary dictionary_load(const char* filename)
 {
+    if (IsFileExtension(filename, ".wgd")) {
+        return dictionary_load_binary(filename);
+    }
+
     char* data = LoadFileText(filename);
     if (data == nullptr) {
         TraceLog(LOG_FATAL, "Could not find dictionary file %s", filename);
-        return Dictionary{0};
+        return Dictionary{};
     }
 
     Dictionary result;
 
     int i = 0;
-    while (data[i] != CR && data[i] != LF) {
+    while (data[i] != CR && data[i] != LF && data[i] != 0) {
         ++i;
     }
 
-    int skip_crlf = 1;
     result.mode = (data[i] == CR) ? LinebreakMode::CR : LinebreakMode::LF;
-    if (data[i + 1] == LF) {
-        skip_crlf = 2;
+    if (data[i] == CR && data[i + 1] == LF) {
         result.mode = LinebreakMode::CRLF;
     }
 
     TraceLog(LOG_INFO, "Linefeed Mode %d", static_cast<int>(result.mode));
 
     int codepoint_count = -1;
-    int* words = LoadCodepoints(data, &codepoint_count);
+    int* codepoints = LoadCodepoints(data, &codepoint_count);
+    UnloadFileText(data);
 
-    if (words == nullptr) {
+    if (codepoints == nullptr) {
         TraceLog(LOG_FATAL, "LoadCodepoints failed from file %s", filename);
-        UnloadFileText(data);
-        return Dictionary{ 0 };
+        return Dictionary{};
     }
 
-    // Allows to add a '0' at the end
-    int* temp = (int*)RL_REALLOC(words, (codepoint_count + 1) * sizeof(int));
-    words[codepoint_count] = 0;
+    if (!alphabet_build(&result.alphabet, codepoints, codepoint_count)) {
+        TraceLog(LOG_FATAL, "Could not build alphabet from file %s", filename);
+        UnloadCodepoints(codepoints);
+        return Dictionary{};
+    }
 
-    // Clear linebreaks 
-    for (int i = 0; i < codepoint_count + 1; ++i) {
-        if (words[i] == CR || words[i] == LF || words[i] == 0) {
-            result.word_count++;
-            words[i] = 0;
+    // Each codepoint becomes one letter index, linebreaks collapse into a single 0
+    // so there is always enough room including the final terminator
+    unsigned char* words = (unsigned char*)RL_MALLOC(codepoint_count + 1);
+    int size = 0;
+    bool in_word = false;
+    for (int i = 0; i < codepoint_count; ++i) {
+        if (codepoints[i] == CR || codepoints[i] == LF || codepoints[i] == 0) {
+            if (in_word) {
+                words[size++] = 0;
+                result.word_count++;
+            }
+            in_word = false;
         }
+        else {
+            words[size++] = (unsigned char)alphabet_get_index(&result.alphabet, codepoints[i]);
+            in_word = true;
+        }
+    }
+    if (in_word) {
+        words[size++] = 0;
+        result.word_count++;
     }
 
-    result.word_count = result.word_count / skip_crlf;
-    result.words = words;
-    result.words_size = codepoint_count + 1;
+    UnloadCodepoints(codepoints);
 
-    UnloadFileText(data);
+    result.words = words;
+    result.words_size = size;
 
     TraceLog(LOG_INFO, "Loaded %i words from file %s", result.word_count, filename);
 
     int start = 0;
     int end = 0;
-    for (int i = 0; i < 10; ++i) {
+    for (int i = 0; i < 10 && start < size; ++i) {
         while (words[end] != 0) end++;
         
-        TraceLog(LOG_DEBUG, "Word %d: [%c,%c,%c,%c,%c]", i, words[start], words[start+1], words[start+2], words[start+3], words[start+4]);
-        TraceLog(LOG_DEBUG, "Data %d: [%d,%d,%d,%d,%d]", i, words[start], words[start + 1], words[start + 2], words[start + 3], words[start + 4]);
+        TraceLog(LOG_DEBUG, "Word %d: [%d,%d,%d,%d,%d]", i, words[start], words[start+1], words[start+2], words[start+3], words[start+4]);
         start = end+1;
         end = start;
     }
@@ -99,7 +134,104 @@ Dictionary dictionary_load(const char* filename)
     return result;
 }
 
-void dictionary_load_distribution(Dictionary* dict, const char* filename) {
+static uint32_t dictionary_read_u32(const unsigned char* data)
+{
+    return (uint32_t)data[0] | ((uint32_t)data[1] << 8) | ((uint32_t)data[2] << 16) | ((uint32_t)data[3] << 24);
+}
+
+// Loads the front coded binary form written by tools/pack_resources.py --binary-dictionary
+inline Dictionary dictionary_load_binary(const char* filename)
+{
+    int size = 0;
+    unsigned char* data = LoadFileData(filename, &size);
+    if (data == nullptr) {
+        TraceLog(LOG_FATAL, "Could not find dictionary file %s", filename);
+        return Dictionary{};
+    }
+
+    Dictionary result;
+    result.mode = LinebreakMode::LF;
+
+    int offset = 8;
+    int letter_count = (size >= 12) ? (int)dictionary_read_u32(data + 8) : 0;
+    if (size < 12 || memcmp(data, "WGDI", 4) != 0 || dictionary_read_u32(data + 4) != 1 ||
+        letter_count < 0 || letter_count > ALPHABET_MAX_LETTERS || 12 + letter_count * 4 + 8 > size) {
+        TraceLog(LOG_FATAL, "%s is not a valid binary dictionary", filename);
+        UnloadFileData(data);
+        return Dictionary{};
+    }
+    offset += 4;
+
+    result.alphabet.count = letter_count;
+    for (int i = 1; i <= letter_count; ++i) {
+        result.alphabet.codepoints[i] = (int)dictionary_read_u32(data + offset);
+        offset += 4;
+    }
+    result.alphabet.bits = 1;
+    while ((1 << result.alphabet.bits) <= result.alphabet.count) result.alphabet.bits++;
+
+    int word_count = (int)dictionary_read_u32(data + offset);
+    int data_size = (int)dictionary_read_u32(data + offset + 4);
+    offset += 8;
+    if (data_size < 0 || offset + data_size > size) {
+        TraceLog(LOG_FATAL, "Binary dictionary %s is truncated", filename);
+        UnloadFileData(data);
+        return Dictionary{};
+    }
+
+    // First pass for the expanded size, it also checks that every word only shares what the
+    // previous one has, uses letters of the alphabet and ends before the data does
+    const unsigned char* coded = data + offset;
+    int words_size = 0;
+    int decoded = 0;
+    int previous_length = 0;
+    bool valid = true;
+    for (int i = 0; valid && i < data_size;) {
+        int shared = coded[i++];
+        int suffix = 0;
+        while (i < data_size && coded[i] != 0) {
+            valid = valid && coded[i] <= letter_count;
+            suffix++;
+            i++;
+        }
+        valid = valid && i < data_size && shared <= previous_length;
+        i++;
+        previous_length = shared + suffix;
+        words_size += previous_length + 1;
+        decoded++;
+    }
+    if (!valid || decoded != word_count) {
+        TraceLog(LOG_FATAL, "%s is not a valid binary dictionary", filename);
+        UnloadFileData(data);
+        return Dictionary{};
+    }
+
+    // Then copy the shared prefix of the previous word in front of each stored suffix
+
+    unsigned char* words = (unsigned char*)RL_MALLOC(words_size > 0 ? words_size : 1);
+    int previous = 0;
+    int write = 0;
+    for (int i = 0; i < data_size;) {
+        int shared = coded[i++];
+        int start = write;
+        for (int j = 0; j < shared; ++j) words[write++] = words[previous + j];
+        while (i < data_size && coded[i] != 0) words[write++] = coded[i++];
+        i++;
+        words[write++] = 0;
+        previous = start;
+    }
+
+    UnloadFileData(data);
+
+    result.words = words;
+    result.words_size = write;
+    result.word_count = word_count;
+
+    TraceLog(LOG_INFO, "Loaded %i words from binary file %s", result.word_count, filename);
+    return result;
+}
+
+inline void dictionary_load_distribution(Dictionary* dict, const char* filename) {
     free(dict->distribution);
     dict->distribution = nullptr;
     dict->distribution_sum = 0;
@@ -124,70 +256,149 @@ void dictionary_load_distribution(Dictionary* dict, const char* filename) {
         return;
     }
 
-    int i = 0;
-    while (i < split_count) {
-        int codepoint_count = 0;
-        distribution[i] = GetCodepointNext(splits[i], &codepoint_count);
-        if (codepoint_count == 0) {
-            TraceLog(LOG_ERROR, "Did not find valid codepoint, skiping entry %i");
+    // Letters are stored as alphabet indices, entries that are not part of the alphabet
+    // can never form a word and are dropped
+    int count = 0;
+    for (int i = 0; i < split_count; i += 2) {
+        int codepoint_size = 0;
+        int codepoint = GetCodepointNext(splits[i], &codepoint_size);
+        int letter = alphabet_get_index(&dict->alphabet, codepoint);
+        if (letter == 0) {
+            TraceLog(LOG_ERROR, "Letter %i is not in the alphabet, skipping entry %i", codepoint, i / 2);
             continue;
         }
-        distribution[i + 1] = TextToInteger(splits[i + 1]);
-        if (distribution[i + 1] < 1) {
-            TraceLog(LOG_ERROR, "Distribution entry needs to be  >0, skiping entry %i");
+        int weight = TextToInteger(splits[i + 1]);
+        if (weight < 1) {
+            TraceLog(LOG_ERROR, "Distribution entry needs to be  >0, skipping entry %i", i / 2);
             continue;
         }
-        dict->distribution_sum += distribution[i + 1];
-        i += 2;
+        distribution[count] = letter;
+        distribution[count + 1] = weight;
+        dict->distribution_sum += weight;
+        count += 2;
     }
 
     UnloadFileText(text);
-    TraceLog(LOG_INFO, "Loaded distribution from %s with %i letters", filename, split_count / 2);
+    TraceLog(LOG_INFO, "Loaded distribution from %s with %i letters", filename, count / 2);
     dict->distribution = distribution;
-    dict->distribution_count = split_count;
+    dict->distribution_count = count;
 }
 
-int dictionary_get_random_letter(Dictionary* dict) 
+// Letter for `draw` in [0, distribution_sum), lets callers bring their own random numbers
+inline int dictionary_get_letter(const Dictionary* dict, int draw)
 {
-    int draw = GetRandomValue(0, dict->distribution_sum - 1);
     int index = -2;
     do {
         index += 2;
         draw -= dict->distribution[index + 1];
-    } while (draw > 0 && index < dict->distribution_count);
+    } while (draw >= 0 && index + 2 < dict->distribution_count);
 
     return dict->distribution[index];
 }
 
-// Assumes codepoints is null terminated
-bool dictionary_exists(Dictionary* dictionary, int* codepoints, int codepoint_count) {
-    // linear search, assumes unsorted array
-    if (codepoints[codepoint_count - 1] != 0) {
-        TraceLog(LOG_ERROR, "codepoints was not null terminated");
+inline int dictionary_get_random_letter(Dictionary* dict)
+{
+    return dictionary_get_letter(dict, GetRandomValue(0, dict->distribution_sum - 1));
+}
+
+// FNV-1a over the alphabet indices up to the terminator, words and queries hash the same
+template <typename T>
+inline uint32_t dictionary_hash(const T* letters)
+{
+    uint32_t hash = 2166136261u;
+    for (; *letters != 0; ++letters) {
+        hash = (hash ^ (uint32_t)*letters) * 16777619u;
+    }
+    return hash;
+}
+
+// Replaces the linear search of dictionary_exists() with a hash lookup, the table is
+// kept at most half full
+inline void dictionary_build_index(Dictionary* dict)
+{
+    free(dict->index);
+    dict->index = nullptr;
+    dict->index_mask = 0;
+
+    uint32_t capacity = 16;
+    while (capacity < (uint32_t)dict->word_count * 2) capacity *= 2;
+    uint32_t* index = (uint32_t*)calloc(capacity, sizeof(uint32_t));
+    if (index == nullptr) {
+        TraceLog(LOG_ERROR, "Could not allocate dictionary index, using linear search");
+        return;
+    }
+
+    uint32_t mask = capacity - 1;
+    for (int offset = 0; offset < dict->words_size;) {
+        uint32_t slot = dictionary_hash(dict->words + offset) & mask;
+        while (index[slot] != 0) slot = (slot + 1) & mask;
+        index[slot] = (uint32_t)offset + 1;
+        while (dict->words[offset++] != 0) {}
+    }
+    dict->index = index;
+    dict->index_mask = mask;
+}
+
+// Assumes letters is null terminated, letters are alphabet indices
+inline bool dictionary_exists(const Dictionary* dictionary, const int* letters, int letter_count) {
+    if (letters[letter_count - 1] != 0) {
+        TraceLog(LOG_ERROR, "letters was not null terminated");
+        return false;
+    }
+
+    if (dictionary->index != nullptr) {
+        uint32_t slot = dictionary_hash(letters) & dictionary->index_mask;
+        for (; dictionary->index[slot] != 0; slot = (slot + 1) & dictionary->index_mask) {
+            const unsigned char* word = dictionary->words + dictionary->index[slot] - 1;
+            int i = 0;
+            while (word[i] == letters[i] && word[i] != 0) i++;
+            if (word[i] == 0 && letters[i] == 0) return true;
+        }
         return false;
     }
 
+    // linear search, assumes unsorted array
     int index = 0;
     while (index < dictionary->words_size) {
         int search_index = 0;
-        while (dictionary->words[index] == codepoints[search_index] && dictionary->words[index] != 0) {
+        while (dictionary->words[index] == letters[search_index] && dictionary->words[index] != 0) {
             search_index++;
             index++;
         }
-        if (dictionary->words[index] == 0 && codepoints[search_index] == 0) {
-            TraceLog(LOG_DEBUG, "FOUND: [%c,%c,%c,%c,%c]", codepoints[0], codepoints[1], codepoints[2], codepoints[3], codepoints[4]);
+        if (dictionary->words[index] == 0 && letters[search_index] == 0) {
+            TraceLog(LOG_DEBUG, "FOUND: [%d,%d,%d,%d,%d]", letters[0], letters[1], letters[2], letters[3], letters[4]);
             return true;
         }
         // Forward to next 0
         while (dictionary->words[index++] != 0) {}
     }
-    TraceLog(LOG_DEBUG, "Not Found: [%c,%c,%c,%c,%c]", codepoints[0], codepoints[1], codepoints[2], codepoints[3], codepoints[4]);
+    TraceLog(LOG_DEBUG, "Not Found: [%d,%d,%d,%d,%d]", letters[0], letters[1], letters[2], letters[3], letters[4]);
     return false;
 }
 
-void dictionary_unload(Dictionary *dictionary)
+// Deep copy, including the index
+inline Dictionary dictionary_copy(const Dictionary* dict)
+{
+    Dictionary result = *dict;
+    result.words = (unsigned char*)RL_MALLOC(dict->words_size > 0 ? dict->words_size : 1);
+    memcpy(result.words, dict->words, dict->words_size);
+    result.distribution = nullptr;
+    if (dict->distribution != nullptr) {
+        result.distribution = (int*)calloc(dict->distribution_count > 0 ? dict->distribution_count : 1, sizeof(int));
+        memcpy(result.distribution, dict->distribution, dict->distribution_count * sizeof(int));
+    }
+    result.index = nullptr;
+    if (dict->index != nullptr) {
+        result.index = (uint32_t*)malloc((dict->index_mask + 1) * sizeof(uint32_t));
+        memcpy(result.index, dict->index, (dict->index_mask + 1) * sizeof(uint32_t));
+    }
+    return result;
+}
+
+inline void dictionary_unload(Dictionary *dictionary)
 {
     free(dictionary->words);
     free(dictionary->distribution);
-    *dictionary = { 0 };
+    free(dictionary->index);
+    *dictionary = Dictionary{};
 }
\ No newline at end of file
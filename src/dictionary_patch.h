@@ -0,0 +1,199 @@
+/*******************************************************************************************
+*
+*   WordGrid
+*   Simple Word Puzzle Game
+*   (C) Harald Scheirich 2024
+*   WordGrid is is licensed under an unmodified zlib/libpng license see LICENSE
+*
+*   Incremental rebuild of a dictionary after its word list was edited
+*
+*   An edit usually touches a few neighbouring lines. The texts before and after are
+*   compared word by word from both ends, only the words in between are encoded again and
+*   only their index slots change. Everything else is copied, which is a fraction of the
+*   cost of decoding, building the alphabet and hashing the whole list
+*
+********************************************************************************************/
+
+#pragma once
+
+#include "raylib.h"
+#include "dictionary.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Byte range of one word in the text of a word list
+struct WordSpan {
+    int start;
+    int length;
+};
+
+// Splits like dictionary_load(), linebreaks separate words and empty lines are skipped.
+// The spans are allocated with RL_MALLOC
+inline int dictionary_split_words(const char* text, WordSpan** spans)
+{
+    int capacity = 1024;
+    int count = 0;
+    WordSpan* result = (WordSpan*)RL_MALLOC(capacity * sizeof(WordSpan));
+    int start = -1;
+    for (int i = 0;; ++i) {
+        char c = text[i];
+        if (c == CR || c == LF || c == 0) {
+            if (start >= 0) {
+                if (count == capacity) {
+                    capacity *= 2;
+                    result = (WordSpan*)RL_REALLOC(result, capacity * sizeof(WordSpan));
+                }
+                result[count++] = WordSpan{ start, i - start };
+            }
+            start = -1;
+            if (c == 0) break;
+        }
+        else if (start < 0) {
+            start = i;
+        }
+    }
+    *spans = result;
+    return count;
+}
+
+inline bool dictionary_same_word(const char* a, WordSpan span_a, const char* b, WordSpan span_b)
+{
+    return span_a.length == span_b.length && memcmp(a + span_a.start, b + span_b.start, span_a.length) == 0;
+}
+
+// Removes the entry in `slot` from a linear probing table without leaving a marker, later
+// entries of the same probe run move up. `words` is the buffer the entries point into
+inline void dictionary_index_remove(uint32_t* index, uint32_t mask, const unsigned char* words, uint32_t slot)
+{
+    uint32_t hole = slot;
+    for (uint32_t next = (slot + 1) & mask; index[next] != 0; next = (next + 1) & mask) {
+        uint32_t home = dictionary_hash(words + index[next] - 1) & mask;
+        // The entry may only move back if the hole lies between its home and where it is
+        if (((next - home) & mask) >= ((next - hole) & mask)) {
+            index[hole] = index[next];
+            hole = next;
+        }
+    }
+    index[hole] = 0;
+}
+
+inline void dictionary_index_insert(uint32_t* index, uint32_t mask, const unsigned char* words, uint32_t offset)
+{
+    uint32_t slot = dictionary_hash(words + offset) & mask;
+    while (index[slot] != 0) slot = (slot + 1) & mask;
+    index[slot] = offset + 1;
+}
+
+// Builds `result` from `base`, which was loaded from `old_text`, so that it matches
+// `new_text`. Returns false if that needs a full load, when `base` does not match
+// `old_text` or a new word uses a letter that is not in the alphabet
+inline bool dictionary_patch(const Dictionary* base, const char* old_text, const char* new_text, Dictionary* result)
+{
+    WordSpan* old_words = nullptr;
+    WordSpan* new_words = nullptr;
+    int old_count = dictionary_split_words(old_text, &old_words);
+    int new_count = dictionary_split_words(new_text, &new_words);
+    unsigned char* added = nullptr;
+    bool ok = old_count == base->word_count;
+
+    // Words [prefix, count - suffix) differ
+    int prefix = 0;
+    int suffix = 0;
+    if (ok) {
+        int shorter = (old_count < new_count) ? old_count : new_count;
+        while (prefix < shorter && dictionary_same_word(old_text, old_words[prefix], new_text, new_words[prefix])) prefix++;
+        while (suffix < shorter - prefix &&
+            dictionary_same_word(old_text, old_words[old_count - 1 - suffix], new_text, new_words[new_count - 1 - suffix])) suffix++;
+    }
+
+    // Each codepoint takes at least one byte, so the text length bounds the encoded size
+    int added_size = 0;
+    if (ok) {
+        int bound = 0;
+        for (int i = prefix; i < new_count - suffix; ++i) bound += new_words[i].length + 1;
+        added = (unsigned char*)RL_MALLOC(bound > 0 ? bound : 1);
+        for (int i = prefix; i < new_count - suffix && ok; ++i) {
+            const char* text = new_text + new_words[i].start;
+            for (int j = 0; j < new_words[i].length && ok;) {
+                int codepoint_size = 0;
+                int letter = alphabet_get_index(&base->alphabet, GetCodepointNext(text + j, &codepoint_size));
+                ok = letter != 0;
+                added[added_size++] = (unsigned char)letter;
+                j += codepoint_size;
+            }
+            added[added_size++] = 0;
+        }
+    }
+
+    if (!ok) {
+        RL_FREE(old_words);
+        RL_FREE(new_words);
+        RL_FREE(added);
+        return false;
+    }
+
+    // Byte range of the replaced words in the base buffer
+    int start_byte = 0;
+    int end_byte = 0;
+    for (int word = 0, offset = 0; word <= old_count - suffix && offset <= base->words_size; ++word) {
+        if (word == prefix) start_byte = offset;
+        if (word == old_count - suffix) end_byte = offset;
+        while (offset < base->words_size && base->words[offset] != 0) offset++;
+        offset++;
+    }
+    int removed_size = end_byte - start_byte;
+    int delta = added_size - removed_size;
+
+    *result = Dictionary{};
+    result->alphabet = base->alphabet;
+    result->mode = base->mode;
+    result->word_count = new_count;
+    result->words_size = base->words_size + delta;
+    result->words = (unsigned char*)RL_MALLOC(result->words_size > 0 ? result->words_size : 1);
+    memcpy(result->words, base->words, start_byte);
+    memcpy(result->words + start_byte, added, added_size);
+    memcpy(result->words + start_byte + added_size, base->words + end_byte, base->words_size - end_byte);
+
+    if (base->distribution != nullptr) {
+        result->distribution = (int*)calloc(base->distribution_count > 0 ? base->distribution_count : 1, sizeof(int));
+        memcpy(result->distribution, base->distribution, base->distribution_count * sizeof(int));
+        result->distribution_count = base->distribution_count;
+        result->distribution_sum = base->distribution_sum;
+    }
+
+    // The index is patched while it stays at most half full, rebuilt otherwise
+    uint32_t capacity = base->index_mask + 1;
+    if (base->index == nullptr || (uint32_t)new_count * 2 > capacity) {
+        dictionary_build_index(result);
+    }
+    else {
+        uint32_t* index = (uint32_t*)malloc(capacity * sizeof(uint32_t));
+        memcpy(index, base->index, capacity * sizeof(uint32_t));
+        uint32_t mask = base->index_mask;
+
+        for (int offset = start_byte; offset < end_byte;) {
+            uint32_t slot = dictionary_hash(base->words + offset) & mask;
+            while (index[slot] != 0 && index[slot] != (uint32_t)offset + 1) slot = (slot + 1) & mask;
+            if (index[slot] != 0) dictionary_index_remove(index, mask, base->words, slot);
+            while (base->words[offset++] != 0) {}
+        }
+        if (delta != 0) {
+            for (uint32_t i = 0; i < capacity; ++i) {
+                if (index[i] > (uint32_t)end_byte) index[i] += delta;
+            }
+        }
+        for (int offset = start_byte; offset < start_byte + added_size;) {
+            dictionary_index_insert(index, mask, result->words, (uint32_t)offset);
+            while (result->words[offset++] != 0) {}
+        }
+        result->index = index;
+        result->index_mask = mask;
+    }
+
+    RL_FREE(old_words);
+    RL_FREE(new_words);
+    RL_FREE(added);
+    return true;
+}
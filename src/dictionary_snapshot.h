@@ -0,0 +1,136 @@
+/*******************************************************************************************
+*
+*   WordGrid
+*   Simple Word Puzzle Game
+*   (C) Harald Scheirich 2024
+*   WordGrid is is licensed under an unmodified zlib/libpng license see LICENSE
+*
+*   Immutable, reference counted dictionaries that are shared between threads
+*
+*   A DictionarySnapshot owns a Dictionary that is never changed after it was created, any
+*   number of threads can query it without locks. A DictionaryStore points at the current
+*   snapshot, publishing a new one is a single atomic exchange, holders of the old one keep
+*   using it until they release it
+*
+*   Taking a reference from the store has to make sure the snapshot is not freed between
+*   loading the pointer and incrementing its count. Readers announce the pointer in a
+*   per-thread hazard slot first and only increment counts that are not zero yet, the last
+*   release waits until no slot announces the snapshot before freeing it. Readers never
+*   wait, the last release waits for a few instructions at most
+*
+********************************************************************************************/
+
+#pragma once
+
+#include "raylib.h"
+#include "dictionary.h"
+#include "anagram_index.h"
+
+#include <stdint.h>
+#include <atomic>
+#include <thread>
+
+static const int DICTIONARY_READER_SLOTS = 128;    // Threads that can take references at the same time
+
+struct DictionarySnapshot {
+    Dictionary dictionary;      // Read only
+    AnagramIndex anagrams;      // Of the short words of `dictionary`
+    uint64_t version = 0;       // Set when published
+    std::atomic<int> references{ 1 };
+};
+
+struct DictionaryStore {
+    std::atomic<DictionarySnapshot*> current{ nullptr };
+    std::atomic<uint64_t> version{ 0 };
+};
+
+inline std::atomic<DictionarySnapshot*> _dictionary_hazards[DICTIONARY_READER_SLOTS];
+inline std::atomic<bool> _dictionary_slot_used[DICTIONARY_READER_SLOTS];
+
+// Claimed on the first acquire of a thread, given back when the thread ends
+struct DictionaryReaderSlot {
+    int index = -1;
+    ~DictionaryReaderSlot()
+    {
+        if (index >= 0) _dictionary_slot_used[index].store(false);
+    }
+};
+
+inline thread_local DictionaryReaderSlot _dictionary_reader_slot;
+
+inline std::atomic<DictionarySnapshot*>* dictionary_reader_hazard()
+{
+    DictionaryReaderSlot* slot = &_dictionary_reader_slot;
+    while (slot->index < 0) {
+        for (int i = 0; i < DICTIONARY_READER_SLOTS; ++i) {
+            bool used = false;
+            if (_dictionary_slot_used[i].compare_exchange_strong(used, true)) {
+                slot->index = i;
+                break;
+            }
+        }
+        if (slot->index < 0) std::this_thread::yield();
+    }
+    return &_dictionary_hazards[slot->index];
+}
+
+// Takes over the data of `dictionary` and builds its index, `dictionary` is left empty.
+// The caller holds the first reference
+inline DictionarySnapshot* dictionary_snapshot_create(Dictionary* dictionary)
+{
+    DictionarySnapshot* snapshot = new DictionarySnapshot();
+    snapshot->dictionary = *dictionary;
+    *dictionary = Dictionary{};
+    if (snapshot->dictionary.index == nullptr) dictionary_build_index(&snapshot->dictionary);
+    anagram_index_build(&snapshot->anagrams, &snapshot->dictionary);
+    return snapshot;
+}
+
+inline void dictionary_snapshot_retain(DictionarySnapshot* snapshot)
+{
+    snapshot->references.fetch_add(1);
+}
+
+inline void dictionary_snapshot_release(DictionarySnapshot* snapshot)
+{
+    if (snapshot == nullptr || snapshot->references.fetch_sub(1) != 1) return;
+
+    // A reader that loaded the pointer before it was replaced may still look at the count
+    for (int i = 0; i < DICTIONARY_READER_SLOTS; ++i) {
+        while (_dictionary_hazards[i].load() == snapshot) std::this_thread::yield();
+    }
+    anagram_index_unload(&snapshot->anagrams);
+    dictionary_unload(&snapshot->dictionary);
+    delete snapshot;
+}
+
+// Current snapshot with a reference the caller has to release, nullptr if none was published
+inline DictionarySnapshot* dictionary_store_acquire(DictionaryStore* store)
+{
+    std::atomic<DictionarySnapshot*>* hazard = dictionary_reader_hazard();
+    while (true) {
+        DictionarySnapshot* snapshot = store->current.load();
+        hazard->store(snapshot);
+        if (snapshot == nullptr) return nullptr;
+        // While it is still current the store holds a reference, the count is above zero
+        if (store->current.load() != snapshot) continue;
+
+        int references = snapshot->references.load();
+        bool retained = false;
+        while (references > 0 && !(retained = snapshot->references.compare_exchange_weak(references, references + 1))) {}
+        hazard->store(nullptr);
+        if (retained) return snapshot;
+    }
+}
+
+// Takes over the caller's reference to `snapshot`, the previous snapshot is released
+inline void dictionary_store_publish(DictionaryStore* store, DictionarySnapshot* snapshot)
+{
+    if (snapshot != nullptr) snapshot->version = store->version.fetch_add(1) + 1;
+    dictionary_snapshot_release(store->current.exchange(snapshot));
+}
+
+inline void dictionary_store_clear(DictionaryStore* store)
+{
+    dictionary_store_publish(store, nullptr);
+}
@@ -0,0 +1,278 @@
+/*******************************************************************************************
+*
+*   WordGrid
+*   Simple Word Puzzle Game
+*   (C) Harald Scheirich 2024
+*   WordGrid is is licensed under an unmodified zlib/libpng license see LICENSE
+*
+*   State and rules of one game, independent of drawing and input
+*
+*   Game is plain data without pointers, copying it branches the game. Solvers and
+*   simulators can copy a state and play moves on the copy with game_play()
+*
+********************************************************************************************/
+
+#pragma once
+
+#include "raylib.h"
+#include "dictionary.h"
+#include "word_cache.h"
+
+#include <stdint.h>
+
+enum GameMode {
+    MODE_NONE = -1,
+    MODE_TIMEATTACK,
+    MODE_MOVEATTACK,
+    MODE_VERSUS,
+    MODE_COUNT,
+};
+
+enum CheckResult {
+    CHECK_RESULT_NONE = 0x0,
+    CHECK_RESULT_HORIZONTAL = 0x1,
+    CHECK_RESULT_VERTICAL = 0x1 << 1,
+    CHECK_RESULT_BOTH = CHECK_RESULT_HORIZONTAL | CHECK_RESULT_VERTICAL,
+};
+
+// Special tiles are stored after the range of alphabet indices
+enum Specials {
+    SPECIAL_CLEAR_COLUMN = ALPHABET_MAX_LETTERS + 1,
+    SPECIAL_CLEAR_ROW,
+    SPECIAL_CLEAR_TILE,
+    SPECIAL_END
+};
+
+static const int SPECIAL_FIRST = SPECIAL_CLEAR_COLUMN;
+static const int SPECIAL_COUNT = SPECIAL_END - SPECIAL_FIRST;
+
+inline bool is_special(int tile) {
+    return tile >= SPECIAL_FIRST && tile < SPECIAL_END;
+}
+
+static const int GAME_EMPTY = -1;
+static const int GAME_MAX_SIZE = 5;                 // Longest word that is checked
+static const int GAME_MAX_CELLS = 32;               // Fixed space increase if we really need more
+static const int GAME_WELL_SIZE = 5;
+static const int GAME_REFRESH_COUNT = 5;
+static const int GAME_SPECIAL_ODDS = 25;            // One in n new well tiles is a special
+
+struct ModeTimeAttackState {
+    float time_remaining;
+    int next_increase;
+    float time_bonus;       // Seconds the words have added to the clock, undone with the moves
+};
+
+struct ModeMoveAttackState {
+    int available_moves;
+    int next_increase;
+};
+
+// Player 0 is the human, player 1 the computer
+struct ModeVersusState {
+    int turn;
+    int scores[2];
+    int moves_left;
+    int moves_seen;         // Game::move_count and word_count when the turn last changed
+    int words_seen;
+    int difficulty;         // AiDifficulty
+};
+
+struct Game {
+    uint64_t random_state = 0;
+    GameMode mode;
+    int rows = GAME_MAX_SIZE;
+    int columns = GAME_MAX_SIZE;
+    int letters[GAME_MAX_CELLS] = { 0 };    // Column major, GAME_EMPTY for free cells
+    int well[GAME_WELL_SIZE] = { 0 };
+    int word_count = 0;
+    int trash_count = 0;
+    int move_count = 0;
+    int refresh_count = 0;
+    float elapsed_time = 0;
+    ModeTimeAttackState timeattack = { 0 };
+    ModeMoveAttackState moveattack = { 0 };
+    ModeVersusState versus = { 0 };
+};
+
+// splitmix64, small state that is copied with the game
+inline uint64_t game_random_next(Game* game)
+{
+    uint64_t z = (game->random_state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+// Value in [min, max]
+inline int game_random_int(Game* game, int min, int max)
+{
+    if (max <= min) return min;
+    return min + (int)(game_random_next(game) % (uint64_t)(max - min + 1));
+}
+
+inline int game_random_letter(Game* game, const Dictionary* dict)
+{
+    return dictionary_get_letter(dict, game_random_int(game, 0, dict->distribution_sum - 1));
+}
+
+inline int game_random_tile(Game* game, const Dictionary* dict)
+{
+    if (game_random_int(game, 0, GAME_SPECIAL_ODDS - 1) < 1) {
+        return game_random_int(game, SPECIAL_FIRST, SPECIAL_END - 1);
+    }
+    return game_random_letter(game, dict);
+}
+
+// Empty board and a well without specials, counters and mode state are reset
+inline void game_init(Game* game, GameMode mode, int rows, int columns, uint64_t seed, const Dictionary* dict)
+{
+    *game = Game{};
+    game->mode = mode;
+    game->rows = rows;
+    game->columns = columns;
+    game->random_state = seed;
+    game->refresh_count = GAME_REFRESH_COUNT;
+    for (int i = 0; i < GAME_MAX_CELLS; ++i) {
+        game->letters[i] = GAME_EMPTY;
+    }
+    for (int i = 0; i < GAME_WELL_SIZE; ++i) {
+        game->well[i] = game_random_letter(game, dict);
+    }
+}
+
+inline bool game_is_valid_cell(const Game* game, int x, int y)
+{
+    return x >= 0 && x < game->columns && y >= 0 && y < game->rows;
+}
+
+inline int game_get_letter(const Game* game, int x, int y)
+{
+    if (!game_is_valid_cell(game, x, y)) {
+        TraceLog(LOG_FATAL, "Invalid access to board (%i,%i)", x, y);
+        return GAME_EMPTY;
+    }
+    return game->letters[x * game->rows + y];
+}
+
+inline void game_set_letter(Game* game, int x, int y, int letter)
+{
+    if (!game_is_valid_cell(game, x, y)) {
+        TraceLog(LOG_FATAL, "Invalid access to board (%i,%i)", x, y);
+        return;
+    }
+    game->letters[x * game->rows + y] = letter;
+}
+
+// Only full lines can be words, the lookups go through the cache of the calling thread
+inline CheckResult game_check_words(const Game* game, const Dictionary* dict, int x, int y)
+{
+    WordCache* cache = word_cache_local();
+    int word[GAME_MAX_SIZE + 1] = { 0 };
+    bool full = true;
+    for (int i = 0; i < game->columns; ++i) {
+        word[i] = game_get_letter(game, i, y);
+        full = full && word[i] != GAME_EMPTY;
+    }
+    CheckResult result = (full && word_cache_exists(cache, dict, word, GAME_MAX_SIZE + 1)) ? CHECK_RESULT_HORIZONTAL : CHECK_RESULT_NONE;
+
+    full = true;
+    for (int i = 0; i < game->rows; ++i) {
+        word[i] = game_get_letter(game, x, i);
+        full = full && word[i] != GAME_EMPTY;
+    }
+    if (full && word_cache_exists(cache, dict, word, GAME_MAX_SIZE + 1)) {
+        result = (CheckResult)(result | CHECK_RESULT_VERTICAL);
+    }
+    return result;
+}
+
+inline void game_clear_words(Game* game, int x, int y, CheckResult where)
+{
+    if ((where & CHECK_RESULT_HORIZONTAL) != 0) {
+        for (int i = 0; i < game->columns; ++i) {
+            game_set_letter(game, i, y, GAME_EMPTY);
+        }
+    }
+    if ((where & CHECK_RESULT_VERTICAL) != 0) {
+        for (int i = 0; i < game->rows; ++i) {
+            game_set_letter(game, x, i, GAME_EMPTY);
+        }
+    }
+}
+
+inline void game_drop_tile(Game* game, int x, int y, int tile)
+{
+    switch (tile) {
+    case SPECIAL_CLEAR_TILE:
+        game_set_letter(game, x, y, GAME_EMPTY);
+        break;
+    case SPECIAL_CLEAR_ROW:
+        game_clear_words(game, x, y, CHECK_RESULT_HORIZONTAL);
+        break;
+    case SPECIAL_CLEAR_COLUMN:
+        game_clear_words(game, x, y, CHECK_RESULT_VERTICAL);
+        break;
+    default:
+        game_set_letter(game, x, y, tile);
+    }
+}
+
+// Letters go on free cells only, specials anywhere
+inline bool game_can_play(const Game* game, int well_index, int x, int y)
+{
+    if (well_index < 0 || well_index >= GAME_WELL_SIZE || !game_is_valid_cell(game, x, y)) return false;
+    int tile = game->well[well_index];
+    if (tile == GAME_EMPTY) return false;
+    return is_special(tile) || game_get_letter(game, x, y) == GAME_EMPTY;
+}
+
+// Plays the well tile at `well_index` onto (x, y) and replaces it in the well, completed
+// words are removed and counted. Returns false without changes if the move is not allowed
+inline bool game_play(Game* game, const Dictionary* dict, int well_index, int x, int y, CheckResult* result)
+{
+    if (!game_can_play(game, well_index, x, y)) return false;
+
+    game_drop_tile(game, x, y, game->well[well_index]);
+    game->well[well_index] = game_random_tile(game, dict);
+
+    CheckResult words = game_check_words(game, dict, x, y);
+    game_clear_words(game, x, y, words);
+    game->move_count += 1;
+    if (words == CHECK_RESULT_BOTH) {
+        game->word_count += 2;
+    }
+    else if (words != CHECK_RESULT_NONE) {
+        game->word_count += 1;
+    }
+    if (result != nullptr) *result = words;
+    return true;
+}
+
+inline bool game_refresh_well(Game* game, const Dictionary* dict)
+{
+    if (game->refresh_count <= 0) return false;
+    --game->refresh_count;
+    for (int i = 0; i < GAME_WELL_SIZE; ++i) {
+        game->well[i] = game_random_tile(game, dict);
+    }
+    return true;
+}
+
+// Clocks keep running across undo and redo, copy them from `from` before comparing states
+inline void game_copy_clocks(Game* to, const Game* from)
+{
+    to->elapsed_time = from->elapsed_time;
+    to->timeattack.time_remaining = from->timeattack.time_remaining;
+}
+
+// Time attack adds `seconds` to the clock for every `words` words. The bonus is also counted
+// apart from the clock, undo and redo take it back or give it again. Returns true if time was added
+inline bool game_timeattack_bonus(Game* game, float seconds, int words)
+{
+    if (game->timeattack.next_increase >= game->word_count) return false;
+    game->timeattack.time_remaining += seconds;
+    game->timeattack.time_bonus += seconds;
+    game->timeattack.next_increase += words;
+    return true;
+}
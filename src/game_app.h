@@ -0,0 +1,31 @@
+/*******************************************************************************************
+*
+*   WordGrid
+*   Simple Word Puzzle Game
+*   (C) Harald Scheirich 2024
+*   WordGrid is is licensed under an unmodified zlib/libpng license see LICENSE
+*
+*   Startup, frame and shutdown of the whole game
+*
+*   main() in raylib_game.cpp is a loop around game_app_frame(). Harnesses build the game
+*   sources with WORDGRID_NO_MAIN and run the frames themselves, e.g. on a hidden window
+*   with scripted input, see bench/frame_bench.cpp
+*
+********************************************************************************************/
+
+#pragma once
+
+// Seconds spent in the parts of one frame
+struct FrameTiming {
+    double update;      // Update of the screens and the transition
+    double draw;        // Drawing into the batch
+    double present;     // EndDrawing(), flushes the batch, swaps the buffers and polls input
+};
+
+// Opens the window with the raylib ConfigFlags in `config_flags` and shows the logo
+void game_app_init(unsigned int config_flags);
+
+// Updates and draws one frame, `timing` can be nullptr
+void game_app_frame(FrameTiming* timing);
+
+void game_app_shutdown();
@@ -0,0 +1,203 @@
+/*******************************************************************************************
+*
+*   WordGrid
+*   Simple Word Puzzle Game
+*   (C) Harald Scheirich 2024
+*   WordGrid is is licensed under an unmodified zlib/libpng license see LICENSE
+*
+*   Undo and redo for Game, every move is stored as the list of 32 bit words of the
+*   state that it changed with their values before and after the move. A move touches a
+*   few cells, one well slot, the counters and the random state, usually less than 20 words
+*
+*   Entries and words are kept in two rings, the oldest moves are dropped when either runs
+*   out of space
+*
+********************************************************************************************/
+
+#pragma once
+
+#include "raylib.h"
+#include "game.h"
+#include "arena.h"
+
+#include <stdint.h>
+#include <string.h>
+
+static_assert(sizeof(Game) % sizeof(uint32_t) == 0, "Game is compared in 32 bit words");
+
+static const int GAME_WORDS = (int)(sizeof(Game) / sizeof(uint32_t));
+static const int GAME_HISTORY_WORDS_PER_MOVE = 24; // Average budget, single moves may use more
+
+struct GameHistoryWord {
+    uint16_t index;
+    uint32_t before;
+    uint32_t after;
+};
+
+struct GameHistoryEntry {
+    int64_t start;      // Position of the first word, counted since init
+    int count;
+};
+
+struct GameHistory {
+    int depth = 0;
+    GameHistoryEntry* entries = nullptr;
+    int first = 0;              // Ring index of the oldest entry
+    int count = 0;              // Entries stored
+    int current = 0;            // Entries applied, the ones after are redo steps
+    GameHistoryWord* words = nullptr;
+    int word_capacity = 0;
+    int64_t word_tail = 0;      // Start of the oldest entry
+    int64_t word_head = 0;      // End of the newest entry
+    bool in_arena = false;      // Buffers are released with their arena
+};
+
+inline void game_history_clear(GameHistory* history)
+{
+    history->first = 0;
+    history->count = 0;
+    history->current = 0;
+    history->word_tail = 0;
+    history->word_head = 0;
+}
+
+// Keeps the last `depth` moves, the buffers come from `arena` if there is one
+inline void game_history_init(GameHistory* history, int depth, Arena* arena = nullptr)
+{
+    *history = GameHistory{};
+    if (depth <= 0) return;
+    // Room for at least one move that changes everything
+    int word_capacity = depth * GAME_HISTORY_WORDS_PER_MOVE;
+    if (word_capacity < GAME_WORDS) word_capacity = GAME_WORDS;
+
+    if (arena != nullptr) {
+        history->entries = arena_push<GameHistoryEntry>(arena, depth);
+        history->words = arena_push<GameHistoryWord>(arena, word_capacity);
+        history->in_arena = true;
+    }
+    else {
+        history->entries = (GameHistoryEntry*)RL_MALLOC(depth * sizeof(GameHistoryEntry));
+        history->words = (GameHistoryWord*)RL_MALLOC(word_capacity * sizeof(GameHistoryWord));
+    }
+    if (history->entries == nullptr || history->words == nullptr) {
+        TraceLog(LOG_WARNING, "HISTORY: Could not allocate %i moves, undo is off", depth);
+        if (!history->in_arena) {
+            RL_FREE(history->entries);
+            RL_FREE(history->words);
+        }
+        *history = GameHistory{};
+        return;
+    }
+    history->depth = depth;
+    history->word_capacity = word_capacity;
+}
+
+inline void game_history_unload(GameHistory* history)
+{
+    if (!history->in_arena) {
+        RL_FREE(history->entries);
+        RL_FREE(history->words);
+    }
+    *history = GameHistory{};
+}
+
+inline GameHistoryEntry* game_history_entry(GameHistory* history, int i)
+{
+    return &history->entries[(history->first + i) % history->depth];
+}
+
+inline void game_history_drop_oldest(GameHistory* history)
+{
+    history->first = (history->first + 1) % history->depth;
+    history->count--;
+    history->current--;
+    history->word_tail = (history->count > 0) ? game_history_entry(history, 0)->start : history->word_head;
+}
+
+// Stores the change from `before` to `after` as one move, the clocks are not part of it but
+// the time attack bonus is. Moves that were undone can not be redone after this
+inline void game_history_record(GameHistory* history, const Game* before, const Game* after)
+{
+    if (history->depth == 0) return;
+
+    Game masked = *before;
+    game_copy_clocks(&masked, after);
+    uint32_t old_words[GAME_WORDS];
+    uint32_t new_words[GAME_WORDS];
+    memcpy(old_words, &masked, sizeof(Game));
+    memcpy(new_words, after, sizeof(Game));
+
+    int changed = 0;
+    for (int i = 0; i < GAME_WORDS; ++i) {
+        changed += old_words[i] != new_words[i];
+    }
+    if (changed == 0) return;
+
+    // Forget the redo steps
+    history->count = history->current;
+    history->word_head = (history->count > 0) ?
+        game_history_entry(history, history->count - 1)->start + game_history_entry(history, history->count - 1)->count :
+        history->word_tail;
+
+    while (history->count > 0 &&
+        (history->count == history->depth || history->word_head - history->word_tail + changed > history->word_capacity)) {
+        game_history_drop_oldest(history);
+    }
+    if (history->count == 0) {
+        history->word_tail = history->word_head;
+    }
+
+    GameHistoryEntry* entry = game_history_entry(history, history->count);
+    entry->start = history->word_head;
+    entry->count = changed;
+    for (int i = 0; i < GAME_WORDS; ++i) {
+        if (old_words[i] == new_words[i]) continue;
+        GameHistoryWord* word = &history->words[history->word_head % history->word_capacity];
+        word->index = (uint16_t)i;
+        word->before = old_words[i];
+        word->after = new_words[i];
+        history->word_head++;
+    }
+    history->count++;
+    history->current = history->count;
+}
+
+inline bool game_history_can_undo(const GameHistory* history)
+{
+    return history->current > 0;
+}
+
+inline bool game_history_can_redo(const GameHistory* history)
+{
+    return history->current < history->count;
+}
+
+inline void game_history_apply(GameHistory* history, const GameHistoryEntry* entry, Game* game, bool undo)
+{
+    float bonus = game->timeattack.time_bonus;
+    uint32_t words[GAME_WORDS];
+    memcpy(words, game, sizeof(Game));
+    for (int i = 0; i < entry->count; ++i) {
+        const GameHistoryWord* word = &history->words[(entry->start + i) % history->word_capacity];
+        words[word->index] = undo ? word->before : word->after;
+    }
+    memcpy(game, words, sizeof(Game));
+    // The clock keeps its value minus the bonus time that was taken back
+    game->timeattack.time_remaining += game->timeattack.time_bonus - bonus;
+}
+
+inline bool game_history_undo(GameHistory* history, Game* game)
+{
+    if (!game_history_can_undo(history)) return false;
+    history->current--;
+    game_history_apply(history, game_history_entry(history, history->current), game, true);
+    return true;
+}
+
+inline bool game_history_redo(GameHistory* history, Game* game)
+{
+    if (!game_history_can_redo(history)) return false;
+    game_history_apply(history, game_history_entry(history, history->current), game, false);
+    history->current++;
+    return true;
+}
@@ -0,0 +1,198 @@
+/*******************************************************************************************
+*
+*   WordGrid
+*   Simple Word Puzzle Game
+*   (C) Harald Scheirich 2024
+*   WordGrid is is licensed under an unmodified zlib/libpng license see LICENSE
+*
+*   How many words can still be made through each free cell of the board
+*
+*   PatternIndex keeps one bitset over the words of each length for every position and
+*   letter, a bit is set when the word has that letter in that place. The words that fit a
+*   line are the AND of the bitsets of its letters, free cells either match anything or,
+*   when restricted to the well, the OR of the bitsets of the well letters
+*
+*   Heatmap remembers the contents and word count of every row and column, an update only
+*   counts the lines that changed since the last one. The value of a free cell is the sum
+*   of its row and its column
+*
+********************************************************************************************/
+
+#pragma once
+
+#include "raylib.h"
+#include "dictionary.h"
+#include "game.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#include <bit>
+
+static const int PATTERN_MAX_LENGTH = GAME_MAX_SIZE;
+static const int PATTERN_LETTERS = ALPHABET_MAX_LETTERS + 1;
+
+struct PatternIndex {
+    uint64_t* bits[PATTERN_MAX_LENGTH + 1] = { nullptr };  // [position][letter][block] per length
+    int word_count[PATTERN_MAX_LENGTH + 1] = { 0 };
+    int blocks[PATTERN_MAX_LENGTH + 1] = { 0 };
+    uint32_t dictionary_id = 0;
+};
+
+inline uint64_t* pattern_bitset(const PatternIndex* index, int length, int position, int letter)
+{
+    return index->bits[length] + ((size_t)position * PATTERN_LETTERS + letter) * index->blocks[length];
+}
+
+inline void pattern_index_unload(PatternIndex* index)
+{
+    for (int length = 0; length <= PATTERN_MAX_LENGTH; ++length) RL_FREE(index->bits[length]);
+    *index = PatternIndex{};
+}
+
+inline void pattern_index_build(PatternIndex* index, const Dictionary* dictionary)
+{
+    pattern_index_unload(index);
+    index->dictionary_id = dictionary->id;
+
+    // Two passes over the words, the first one sizes the bitsets
+    for (int pass = 0; pass < 2; ++pass) {
+        int count[PATTERN_MAX_LENGTH + 1] = { 0 };
+        for (int offset = 0; offset < dictionary->words_size;) {
+            int start = offset;
+            while (offset < dictionary->words_size && dictionary->words[offset] != 0) offset++;
+            int length = offset - start;
+            offset++;
+            if (length == 0 || length > PATTERN_MAX_LENGTH) continue;
+            if (pass == 1) {
+                for (int position = 0; position < length; ++position) {
+                    uint64_t* bits = pattern_bitset(index, length, position, dictionary->words[start + position]);
+                    bits[count[length] / 64] |= 1ull << (count[length] % 64);
+                }
+            }
+            count[length]++;
+        }
+        if (pass == 1) break;
+
+        for (int length = 1; length <= PATTERN_MAX_LENGTH; ++length) {
+            index->word_count[length] = count[length];
+            index->blocks[length] = (count[length] + 63) / 64;
+            size_t size = (size_t)length * PATTERN_LETTERS * index->blocks[length];
+            if (size == 0) continue;
+            index->bits[length] = (uint64_t*)RL_CALLOC(size, sizeof(uint64_t));
+        }
+    }
+}
+
+// Words of `length` letters that fit `line`, free cells are 0. Bit n of `allowed` is set
+// when letter n may go on a free cell, ~0 for any letter
+inline int pattern_count(const PatternIndex* index, const int* line, int length, uint64_t allowed)
+{
+    if (length <= 0 || length > PATTERN_MAX_LENGTH || index->bits[length] == nullptr) return 0;
+    bool restricted = (allowed | 1) != ~0ull;
+    int blocks = index->blocks[length];
+    int result = 0;
+    for (int block = 0; block < blocks; ++block) {
+        uint64_t fits = ~0ull;
+        for (int position = 0; position < length && fits != 0; ++position) {
+            if (line[position] > 0 && line[position] < PATTERN_LETTERS) {
+                fits &= pattern_bitset(index, length, position, line[position])[block];
+            }
+            else if (line[position] != 0) {
+                fits = 0;
+            }
+            else if (restricted) {
+                uint64_t any = 0;
+                for (uint64_t letters = allowed & ~1ull; letters != 0; letters &= letters - 1) {
+                    any |= pattern_bitset(index, length, position, std::countr_zero(letters))[block];
+                }
+                fits &= any;
+            }
+        }
+        // Bits past the last word are never set by a letter, only a line of free cells sees them
+        if (block == blocks - 1 && index->word_count[length] % 64 != 0) fits &= (1ull << (index->word_count[length] % 64)) - 1;
+        result += std::popcount(fits);
+    }
+    return result;
+}
+
+enum HeatmapLine {
+    HEATMAP_ROW,
+    HEATMAP_COLUMN,
+    HEATMAP_LINE_COUNT
+};
+
+struct Heatmap {
+    PatternIndex index;
+    bool valid = false;
+    uint64_t allowed = 0;                   // Of the counts below
+    int rows = 0;
+    int columns = 0;
+    int lines[HEATMAP_LINE_COUNT][GAME_MAX_SIZE][GAME_MAX_SIZE] = { };
+    int counts[HEATMAP_LINE_COUNT][GAME_MAX_SIZE] = { };
+    int cells[GAME_MAX_CELLS] = { 0 };      // Column major like Game::letters, 0 for used cells
+    int max_cell = 0;
+};
+
+inline void heatmap_unload(Heatmap* heatmap)
+{
+    pattern_index_unload(&heatmap->index);
+    *heatmap = Heatmap{};
+}
+
+// Only free cells can take a letter
+inline uint64_t heatmap_well_letters(const Game* game)
+{
+    uint64_t result = 0;
+    for (int i = 0; i < GAME_WELL_SIZE; ++i) {
+        if (game->well[i] > 0 && game->well[i] < PATTERN_LETTERS) result |= 1ull << game->well[i];
+    }
+    return result;
+}
+
+// Counts the lines that changed since the last update, returns false if none did
+inline bool heatmap_update(Heatmap* heatmap, const Game* game, const Dictionary* dictionary, uint64_t allowed)
+{
+    if (heatmap->index.dictionary_id != dictionary->id) {
+        pattern_index_build(&heatmap->index, dictionary);
+        heatmap->valid = false;
+    }
+    if (heatmap->allowed != allowed || heatmap->rows != game->rows || heatmap->columns != game->columns) {
+        heatmap->valid = false;
+    }
+
+    bool changed = !heatmap->valid;
+    int line[GAME_MAX_SIZE];
+    for (int kind = 0; kind < HEATMAP_LINE_COUNT; ++kind) {
+        int count = (kind == HEATMAP_ROW) ? game->rows : game->columns;
+        int length = (kind == HEATMAP_ROW) ? game->columns : game->rows;
+        for (int i = 0; i < count; ++i) {
+            bool full = true;
+            for (int j = 0; j < length; ++j) {
+                int letter = (kind == HEATMAP_ROW) ? game_get_letter(game, j, i) : game_get_letter(game, i, j);
+                line[j] = (letter > 0) ? letter : 0;
+                full = full && line[j] != 0;
+            }
+            if (heatmap->valid && memcmp(line, heatmap->lines[kind][i], length * sizeof(int)) == 0) continue;
+            memcpy(heatmap->lines[kind][i], line, length * sizeof(int));
+            heatmap->counts[kind][i] = full ? 0 : pattern_count(&heatmap->index, line, length, allowed);
+            changed = true;
+        }
+    }
+    if (!changed) return false;
+
+    heatmap->valid = true;
+    heatmap->allowed = allowed;
+    heatmap->rows = game->rows;
+    heatmap->columns = game->columns;
+    heatmap->max_cell = 0;
+    for (int x = 0; x < game->columns; ++x) {
+        for (int y = 0; y < game->rows; ++y) {
+            int value = (game_get_letter(game, x, y) == GAME_EMPTY) ?
+                heatmap->counts[HEATMAP_ROW][y] + heatmap->counts[HEATMAP_COLUMN][x] : 0;
+            heatmap->cells[x * game->rows + y] = value;
+            if (value > heatmap->max_cell) heatmap->max_cell = value;
+        }
+    }
+    return true;
+}
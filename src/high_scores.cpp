@@ -0,0 +1,229 @@
+/*******************************************************************************************
+*
+*   WordGrid
+*   Simple Word Puzzle Game
+*   (C) Harald Scheirich 2024
+*   WordGrid is is licensed under an unmodified zlib/libpng license see LICENSE
+*
+********************************************************************************************/
+
+#include "high_scores.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <filesystem>
+
+static const char* _log_file = "scores.log";
+static const char* _summary_file = "scores.sum";
+static const char* _summary_temp_file = "scores.sum.tmp";
+
+static HighScoreTable _tables[HIGH_SCORE_MAX_TABLES];
+static int _table_count = 0;
+static uint32_t _summary_generation = 0;    // Last log that is folded into the summary
+static uint32_t _log_generation = 1;
+static int _log_records = 0;                // Records in the log that the summary misses
+static FILE* _log = nullptr;
+static bool _open = false;
+
+static HighScoreTable* high_scores_find(int mode, int rows, int columns, bool create)
+{
+    for (int i = 0; i < _table_count; ++i) {
+        HighScoreTable* table = &_tables[i];
+        if (table->mode == mode && table->rows == rows && table->columns == columns) return table;
+    }
+    if (!create) return nullptr;
+    if (_table_count == HIGH_SCORE_MAX_TABLES) {
+        TraceLog(LOG_WARNING, "SCORES: Too many board sizes, not recording %ix%i", columns, rows);
+        return nullptr;
+    }
+    HighScoreTable* table = &_tables[_table_count++];
+    memset(table, 0, sizeof(HighScoreTable));
+    table->mode = (uint8_t)mode;
+    table->rows = (uint8_t)rows;
+    table->columns = (uint8_t)columns;
+    return table;
+}
+
+static void high_scores_apply(const HighScoreRecord* record)
+{
+    HighScoreTable* table = high_scores_find(record->mode, record->rows, record->columns, true);
+    if (table != nullptr) high_score_table_add(table, record);
+}
+
+static bool high_scores_read_header(FILE* file, const char* magic, HighScoreFileHeader* header)
+{
+    return fread(header, sizeof(HighScoreFileHeader), 1, file) == 1 &&
+        memcmp(header->magic, magic, 4) == 0 && header->version == HIGH_SCORE_VERSION;
+}
+
+static void high_scores_read_summary()
+{
+    FILE* file = fopen(_summary_file, "rb");
+    if (file == nullptr) return;
+
+    HighScoreFileHeader header;
+    bool valid = high_scores_read_header(file, HIGH_SCORE_SUMMARY_MAGIC, &header) &&
+        header.count <= (uint32_t)HIGH_SCORE_MAX_TABLES &&
+        fread(_tables, sizeof(HighScoreTable), header.count, file) == header.count;
+    if (valid) {
+        _table_count = (int)header.count;
+        _summary_generation = header.generation;
+    }
+    else {
+        TraceLog(LOG_WARNING, "SCORES: Ignoring %s, it does not match this version", _summary_file);
+        _table_count = 0;
+    }
+    fclose(file);
+}
+
+// Replays the records the summary does not have yet, a record cut short by a crash is dropped
+static void high_scores_read_log()
+{
+    FILE* file = fopen(_log_file, "rb");
+    if (file == nullptr) return;
+
+    HighScoreFileHeader header;
+    if (high_scores_read_header(file, HIGH_SCORE_LOG_MAGIC, &header) && header.generation > _summary_generation) {
+        _log_generation = header.generation;
+        HighScoreRecord record;
+        while (fread(&record, sizeof(HighScoreRecord), 1, file) == 1) {
+            high_scores_apply(&record);
+            _log_records++;
+        }
+    }
+    fclose(file);
+}
+
+// Writes the header of an empty log, the previous log is replaced
+static bool high_scores_start_log()
+{
+    if (_log != nullptr) fclose(_log);
+    _log = fopen(_log_file, "wb");
+    if (_log == nullptr) {
+        TraceLog(LOG_WARNING, "SCORES: Could not open %s", _log_file);
+        return false;
+    }
+    HighScoreFileHeader header;
+    memcpy(header.magic, HIGH_SCORE_LOG_MAGIC, 4);
+    header.version = HIGH_SCORE_VERSION;
+    header.generation = _log_generation;
+    header.count = 0;
+    bool ok = fwrite(&header, sizeof(HighScoreFileHeader), 1, _log) == 1 && fflush(_log) == 0;
+    _log_records = 0;
+    return ok;
+}
+
+static bool high_scores_append_log(const HighScoreRecord* record)
+{
+    if (_log == nullptr) {
+        _log = fopen(_log_file, "ab");
+        if (_log == nullptr) return false;
+    }
+    return fwrite(record, sizeof(HighScoreRecord), 1, _log) == 1 && fflush(_log) == 0;
+}
+
+// The summary is renamed into place before the log restarts. A crash in between leaves a
+// log whose generation the summary already has, it is skipped on the next open
+static void high_scores_compact()
+{
+    if (_log_records == 0) return;
+
+    FILE* file = fopen(_summary_temp_file, "wb");
+    if (file == nullptr) {
+        TraceLog(LOG_WARNING, "SCORES: Could not open %s", _summary_temp_file);
+        return;
+    }
+    HighScoreFileHeader header;
+    memcpy(header.magic, HIGH_SCORE_SUMMARY_MAGIC, 4);
+    header.version = HIGH_SCORE_VERSION;
+    header.generation = _log_generation;
+    header.count = (uint32_t)_table_count;
+    bool ok = fwrite(&header, sizeof(HighScoreFileHeader), 1, file) == 1 &&
+        fwrite(_tables, sizeof(HighScoreTable), _table_count, file) == (size_t)_table_count;
+    ok = (fclose(file) == 0) && ok;
+
+    std::error_code error;
+    if (ok) std::filesystem::rename(_summary_temp_file, _summary_file, error);
+    if (!ok || error) {
+        TraceLog(LOG_WARNING, "SCORES: Could not write %s", _summary_file);
+        std::filesystem::remove(_summary_temp_file, error);
+        return;
+    }
+    _summary_generation = _log_generation;
+    _log_generation++;
+    high_scores_start_log();
+}
+
+void high_scores_open()
+{
+    if (_open) return;
+    _open = true;
+    _table_count = 0;
+    _summary_generation = 0;
+    _log_generation = 1;
+    _log_records = 0;
+
+    high_scores_read_summary();
+    high_scores_read_log();
+    if (_log_records > 0) {
+        high_scores_compact();
+    }
+    if (_log == nullptr) {
+        _log_generation = _summary_generation + 1;
+        high_scores_start_log();
+    }
+}
+
+void high_scores_close()
+{
+    if (!_open) return;
+    high_scores_compact();
+    if (_log != nullptr) fclose(_log);
+    _log = nullptr;
+    _open = false;
+}
+
+HighScoreRecord high_scores_add(const Game* game)
+{
+    HighScoreRecord record;
+    memset(&record, 0, sizeof(HighScoreRecord));
+    record.mode = (uint8_t)game->mode;
+    record.rows = (uint8_t)game->rows;
+    record.columns = (uint8_t)game->columns;
+    record.score = (game->mode == MODE_VERSUS) ? game->versus.scores[0] : game->word_count;  // Words of the player
+    record.moves = game->move_count;
+    record.elapsed_time = game->elapsed_time;
+    record.timestamp = (int64_t)time(nullptr);
+
+    if (!_open) high_scores_open();
+    high_scores_apply(&record);
+    if (!high_scores_append_log(&record)) {
+        TraceLog(LOG_WARNING, "SCORES: Could not write %s", _log_file);
+    }
+    else if (++_log_records >= HIGH_SCORE_COMPACT_RECORDS) {
+        high_scores_compact();
+    }
+    return record;
+}
+
+const HighScoreTable* high_scores_table(GameMode mode, int rows, int columns)
+{
+    if (!_open) high_scores_open();
+    const HighScoreTable* table = high_scores_find(mode, rows, columns, false);
+    return (table != nullptr && table->game_count > 0) ? table : nullptr;
+}
+
+float high_scores_percentile(GameMode mode, int rows, int columns, int score)
+{
+    const HighScoreTable* table = high_scores_table(mode, rows, columns);
+    return (table != nullptr) ? high_score_table_percentile(table, score) : 0.0f;
+}
+
+bool high_scores_best(GameMode mode, int rows, int columns, HighScoreRecord* best)
+{
+    const HighScoreTable* table = high_scores_table(mode, rows, columns);
+    if (table == nullptr || table->top_count == 0) return false;
+    *best = table->top[0];
+    return true;
+}
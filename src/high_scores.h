@@ -0,0 +1,116 @@
+/*******************************************************************************************
+*
+*   WordGrid
+*   Simple Word Puzzle Game
+*   (C) Harald Scheirich 2024
+*   WordGrid is is licensed under an unmodified zlib/libpng license see LICENSE
+*
+*   High scores per game mode and board size
+*
+*   Finished games are appended to a log. The summary file holds, per mode and size, the
+*   best HIGH_SCORE_TOP_COUNT games and a histogram of all scores, which is all that is
+*   needed for the queries. Compaction folds the log into the summary and starts a new log,
+*   so opening reads the summary and at most HIGH_SCORE_COMPACT_RECORDS log records no
+*   matter how many games were played
+*
+********************************************************************************************/
+
+#pragma once
+
+#include "game.h"
+
+#include <stdint.h>
+
+static const int HIGH_SCORE_TOP_COUNT = 10;
+static const int HIGH_SCORE_BUCKETS = 256;          // Scores above go into the last bucket
+static const int HIGH_SCORE_MAX_TABLES = 8;
+static const int HIGH_SCORE_COMPACT_RECORDS = 4096;
+
+static const char HIGH_SCORE_LOG_MAGIC[4] = { 'W', 'G', 'H', 'L' };
+static const char HIGH_SCORE_SUMMARY_MAGIC[4] = { 'W', 'G', 'H', 'S' };
+static const uint32_t HIGH_SCORE_VERSION = 1;
+
+// Starts both files, a log is already part of the summary when their generations match
+struct HighScoreFileHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t generation;
+    uint32_t count;         // Tables in the summary, unused in the log
+};
+
+struct HighScoreRecord {
+    uint8_t mode;
+    uint8_t rows;
+    uint8_t columns;
+    uint8_t reserved;
+    int32_t score;          // Completed words, of the player in versus games
+    int32_t moves;
+    float elapsed_time;
+    int64_t timestamp;      // Seconds since the epoch
+};
+
+struct HighScoreTable {
+    uint8_t mode;
+    uint8_t rows;
+    uint8_t columns;
+    uint8_t reserved;
+    int32_t top_count;
+    int64_t game_count;
+    HighScoreRecord top[HIGH_SCORE_TOP_COUNT];  // Best first
+    uint32_t histogram[HIGH_SCORE_BUCKETS];
+};
+
+inline int high_score_bucket(int score)
+{
+    if (score < 0) return 0;
+    return (score < HIGH_SCORE_BUCKETS) ? score : HIGH_SCORE_BUCKETS - 1;
+}
+
+// Higher scores first, the same score is ranked by who got there first
+inline bool high_score_better(const HighScoreRecord* a, const HighScoreRecord* b)
+{
+    if (a->score != b->score) return a->score > b->score;
+    return a->timestamp < b->timestamp;
+}
+
+inline void high_score_table_add(HighScoreTable* table, const HighScoreRecord* record)
+{
+    table->game_count++;
+    table->histogram[high_score_bucket(record->score)]++;
+
+    int position = table->top_count;
+    while (position > 0 && high_score_better(record, &table->top[position - 1])) position--;
+    if (position >= HIGH_SCORE_TOP_COUNT) return;
+
+    int last = (table->top_count < HIGH_SCORE_TOP_COUNT) ? table->top_count : HIGH_SCORE_TOP_COUNT - 1;
+    for (int i = last; i > position; --i) table->top[i] = table->top[i - 1];
+    table->top[position] = *record;
+    if (table->top_count < HIGH_SCORE_TOP_COUNT) table->top_count++;
+}
+
+// Share of the games in the table that scored less than `score`, ties count half
+inline float high_score_table_percentile(const HighScoreTable* table, int score)
+{
+    if (table->game_count == 0) return 0.0f;
+
+    int bucket = high_score_bucket(score);
+    double below = 0;
+    for (int i = 0; i < bucket; ++i) below += table->histogram[i];
+    double equal = table->histogram[bucket];
+    return (float)((below + equal / 2.0) / (double)table->game_count * 100.0);
+}
+
+// Reads the summary and the records that were logged after it, creates the files on first use
+void high_scores_open();
+// Folds the log into the summary
+void high_scores_close();
+
+// Appends the finished game to the log and updates the tables
+HighScoreRecord high_scores_add(const Game* game);
+
+// Null when no game with this mode and size was recorded yet
+const HighScoreTable* high_scores_table(GameMode mode, int rows, int columns);
+
+// Percentage of recorded games that did worse
+float high_scores_percentile(GameMode mode, int rows, int columns, int score);
+bool high_scores_best(GameMode mode, int rows, int columns, HighScoreRecord* best);
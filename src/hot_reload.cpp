@@ -0,0 +1,198 @@
+/*******************************************************************************************
+*
+*   WordGrid
+*   Simple Word Puzzle Game
+*   (C) Harald Scheirich 2024
+*   WordGrid is is licensed under an unmodified zlib/libpng license see LICENSE
+*
+********************************************************************************************/
+
+#include "hot_reload.h"
+#include "raylib.h"
+#include "screens.h"
+#include "dictionary_patch.h"
+
+#if defined(WORDGRID_HOT_RELOAD_DIR) && defined(__linux__) && !defined(PLATFORM_WEB)
+    #define HOT_RELOAD_ENABLED
+#endif
+
+#if defined(HOT_RELOAD_ENABLED)
+
+#include <stdio.h>
+#include <string.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/inotify.h>
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+static const char* _words_name = "words.txt";
+static const char* _distribution_name = "distribution.txt";
+static const int POLL_TIMEOUT_MS = 200;
+static const int SETTLE_TIME_MS = 50;       // Editors write a file in several steps
+static const double REPORT_TIME = 4.0;
+
+static int _inotify_fd = -1;
+static std::thread _worker;
+static std::atomic<bool> _stop{ false };
+
+static char* _words_text = nullptr;         // Text of the last snapshot built here, worker only
+
+static std::mutex _pending_mutex;           // Guards the values below
+static DictionarySnapshot* _pending = nullptr;
+static char _report[128] = { 0 };
+static bool _report_new = false;
+static double _report_time = -REPORT_TIME;
+
+static void hot_reload_path(char* path, int size, const char* name)
+{
+    snprintf(path, size, "%s/%s", WORDGRID_HOT_RELOAD_DIR, name);
+}
+
+// Full load the first time, the word list is patched after that
+static void hot_reload_rebuild(bool words_changed, bool distribution_changed)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    char words_path[512];
+    char distribution_path[512];
+    hot_reload_path(words_path, sizeof(words_path), _words_name);
+    hot_reload_path(distribution_path, sizeof(distribution_path), _distribution_name);
+
+    DictionarySnapshot* base = dictionary_store_acquire(&g_dictionary_store);
+    Dictionary dictionary;
+    bool incremental = false;
+    bool loaded = false;
+
+    if (words_changed || _words_text == nullptr || base == nullptr) {
+        char* text = LoadFileText(words_path);
+        if (text == nullptr) {
+            dictionary_snapshot_release(base);
+            return;
+        }
+        incremental = base != nullptr && _words_text != nullptr &&
+            dictionary_patch(&base->dictionary, _words_text, text, &dictionary);
+        if (!incremental) {
+            dictionary = dictionary_load(words_path);
+            distribution_changed = true;
+        }
+        UnloadFileText(_words_text);
+        _words_text = text;
+        loaded = true;
+    }
+    if (distribution_changed) {
+        if (!loaded) dictionary = dictionary_copy(&base->dictionary);
+        dictionary_load_distribution(&dictionary, distribution_path);
+    }
+    dictionary_snapshot_release(base);
+
+    if (dictionary.word_count == 0 || dictionary.distribution_sum == 0) {
+        TraceLog(LOG_WARNING, "RELOAD: Keeping the current dictionary, the new files did not load");
+        dictionary_unload(&dictionary);
+        return;
+    }
+    DictionarySnapshot* snapshot = dictionary_snapshot_create(&dictionary);
+    double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    std::lock_guard<std::mutex> lock(_pending_mutex);
+    dictionary_snapshot_release(_pending);
+    _pending = snapshot;
+    snprintf(_report, sizeof(_report), "%s rebuilt in %.1f ms (%s, %d words)",
+        words_changed ? _words_name : _distribution_name, milliseconds,
+        incremental ? "incremental" : "full", snapshot->dictionary.word_count);
+    _report_new = true;
+}
+
+static void hot_reload_worker()
+{
+    char buffer[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+    bool words_changed = false;
+    bool distribution_changed = false;
+
+    while (!_stop) {
+        pollfd descriptor = { _inotify_fd, POLLIN, 0 };
+        bool pending = words_changed || distribution_changed;
+        int ready = poll(&descriptor, 1, pending ? SETTLE_TIME_MS : POLL_TIMEOUT_MS);
+
+        if (ready > 0) {
+            ssize_t size = read(_inotify_fd, buffer, sizeof(buffer));
+            for (ssize_t offset = 0; offset < size;) {
+                const inotify_event* event = (const inotify_event*)(buffer + offset);
+                if (event->len > 0) {
+                    words_changed |= strcmp(event->name, _words_name) == 0;
+                    distribution_changed |= strcmp(event->name, _distribution_name) == 0;
+                }
+                offset += sizeof(inotify_event) + event->len;
+            }
+        }
+        else if (ready == 0 && pending) {
+            // Quiet for a moment, the files are complete
+            hot_reload_rebuild(words_changed, distribution_changed);
+            words_changed = false;
+            distribution_changed = false;
+        }
+    }
+}
+
+void hot_reload_init()
+{
+    _inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (_inotify_fd < 0 || inotify_add_watch(_inotify_fd, WORDGRID_HOT_RELOAD_DIR, IN_CLOSE_WRITE | IN_MOVED_TO) < 0) {
+        TraceLog(LOG_WARNING, "RELOAD: Can not watch %s", WORDGRID_HOT_RELOAD_DIR);
+        if (_inotify_fd >= 0) close(_inotify_fd);
+        _inotify_fd = -1;
+        return;
+    }
+    TraceLog(LOG_INFO, "RELOAD: Watching %s", WORDGRID_HOT_RELOAD_DIR);
+    _stop = false;
+    _worker = std::thread(hot_reload_worker);
+}
+
+void hot_reload_update()
+{
+    DictionarySnapshot* snapshot = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(_pending_mutex);
+        snapshot = _pending;
+        _pending = nullptr;
+        if (_report_new) {
+            _report_time = GetTime();
+            _report_new = false;
+            TraceLog(LOG_INFO, "RELOAD: %s", _report);
+        }
+    }
+    if (snapshot != nullptr) dictionary_store_publish(&g_dictionary_store, snapshot);
+}
+
+void hot_reload_draw()
+{
+    if (GetTime() - _report_time > REPORT_TIME) return;
+    std::lock_guard<std::mutex> lock(_pending_mutex);
+    DrawText(_report, 10, (int)screen_layout_size().y - 20, 10, DARKGRAY);
+}
+
+void hot_reload_shutdown()
+{
+    if (_inotify_fd < 0) return;
+    _stop = true;
+    if (_worker.joinable()) _worker.join();
+    close(_inotify_fd);
+    _inotify_fd = -1;
+
+    dictionary_snapshot_release(_pending);
+    _pending = nullptr;
+    UnloadFileText(_words_text);
+    _words_text = nullptr;
+}
+
+#else
+
+void hot_reload_init() {}
+void hot_reload_update() {}
+void hot_reload_draw() {}
+void hot_reload_shutdown() {}
+
+#endif
@@ -0,0 +1,28 @@
+/*******************************************************************************************
+*
+*   WordGrid
+*   Simple Word Puzzle Game
+*   (C) Harald Scheirich 2024
+*   WordGrid is is licensed under an unmodified zlib/libpng license see LICENSE
+*
+*   Development reload of the word list and letter distribution
+*
+*   Debug builds on Linux define WORDGRID_HOT_RELOAD_DIR, the text directory of the source
+*   tree. A background thread watches it with inotify and rebuilds the dictionary when
+*   words.txt or distribution.txt is saved, edits of the word list are applied with
+*   dictionary_patch(). The new snapshot is published into g_dictionary_store between
+*   frames, everywhere else all functions do nothing
+*
+********************************************************************************************/
+
+#pragma once
+
+void hot_reload_init();
+
+// Publishes a finished rebuild, call between frames on the main thread
+void hot_reload_update();
+
+// Reports the last rebuild for a few seconds, drawn in design units inside screen_layout_begin()
+void hot_reload_draw();
+
+void hot_reload_shutdown();
@@ -0,0 +1,252 @@
+/*******************************************************************************************
+*
+*   WordGrid
+*   Simple Word Puzzle Game
+*   (C) Harald Scheirich 2024
+*   WordGrid is is licensed under an unmodified zlib/libpng license see LICENSE
+*
+********************************************************************************************/
+
+#include "input_queue.h"
+
+#if defined(PLATFORM_DESKTOP) || defined(PLATFORM_DESKTOP_GLFW) || defined(PLATFORM_WEB)
+    #define INPUT_USE_GLFW
+#endif
+
+#if defined(PLATFORM_WEB)
+    #include <emscripten/emscripten.h>
+    #include <emscripten/html5.h>
+#endif
+
+#if defined(INPUT_USE_GLFW)
+// raylib does not expose the GLFW headers, these match the GLFW 3 declarations
+extern "C" {
+    struct GLFWwindow;
+    typedef void (*GLFWmousebuttonfun)(GLFWwindow*, int, int, int);
+    typedef void (*GLFWcursorposfun)(GLFWwindow*, double, double);
+    GLFWmousebuttonfun glfwSetMouseButtonCallback(GLFWwindow* window, GLFWmousebuttonfun callback);
+    GLFWcursorposfun glfwSetCursorPosCallback(GLFWwindow* window, GLFWcursorposfun callback);
+}
+
+static const int GLFW_RELEASE = 0;
+static const int GLFW_PRESS = 1;
+static const int GLFW_MOUSE_BUTTON_LEFT = 0;
+#endif
+
+struct InputQueue {
+    InputEvent events[INPUT_QUEUE_CAPACITY];
+    int head = 0;
+    int count = 0;
+    Vector2 position = { 0 };
+    bool pressed = false;
+    // Events seen by the callbacks since the last sync
+    int captured_presses = 0;
+    int captured_releases = 0;
+    int captured_moves = 0;
+};
+
+static InputQueue _queue;
+static float _position_scale = 1.0f;    // Window to view units, like SetMouseScale()
+
+#if defined(INPUT_USE_GLFW)
+static GLFWmousebuttonfun _previous_button_callback = nullptr;
+static GLFWcursorposfun _previous_cursor_callback = nullptr;
+#endif
+
+#if defined(PLATFORM_WEB)
+// Browsers follow a touch with emulated mouse events, those are dropped for a while
+static const double TOUCH_MOUSE_SUPPRESS_TIME = 0.5;
+static double _last_touch_time = -1.0;
+static int _touch_id = -1;
+#endif
+
+void input_queue_push(InputEvent event)
+{
+    if (event.type == INPUT_PRESS) _queue.pressed = true;
+    else if (event.type == INPUT_RELEASE) _queue.pressed = false;
+    _queue.position = event.position;
+
+    // Moves in a row only need the latest position, this also keeps the queue short
+    if (event.type == INPUT_MOVE && _queue.count > 0) {
+        InputEvent* last = &_queue.events[(_queue.head + _queue.count - 1) % INPUT_QUEUE_CAPACITY];
+        if (last->type == INPUT_MOVE) {
+            *last = event;
+            return;
+        }
+    }
+
+    if (_queue.count == INPUT_QUEUE_CAPACITY) {
+        TraceLog(LOG_WARNING, "Input queue is full, dropping the oldest event");
+        _queue.head = (_queue.head + 1) % INPUT_QUEUE_CAPACITY;
+        _queue.count--;
+    }
+    _queue.events[(_queue.head + _queue.count) % INPUT_QUEUE_CAPACITY] = event;
+    _queue.count++;
+}
+
+bool input_queue_pop(InputEvent* event)
+{
+    if (_queue.count == 0) return false;
+    *event = _queue.events[_queue.head];
+    _queue.head = (_queue.head + 1) % INPUT_QUEUE_CAPACITY;
+    _queue.count--;
+    return true;
+}
+
+void input_queue_clear()
+{
+    _queue.head = 0;
+    _queue.count = 0;
+}
+
+Vector2 input_queue_position()
+{
+    return _queue.position;
+}
+
+void input_queue_set_scale(float scale)
+{
+    _position_scale = scale;
+}
+
+static void input_queue_capture(InputEventType type, Vector2 position)
+{
+    switch (type) {
+    case INPUT_PRESS: _queue.captured_presses++; break;
+    case INPUT_RELEASE: _queue.captured_releases++; break;
+    case INPUT_MOVE: _queue.captured_moves++; break;
+    }
+    input_queue_push(InputEvent{ type, position, GetTime() });
+}
+
+#if defined(INPUT_USE_GLFW)
+static void input_mouse_button_callback(GLFWwindow* window, int button, int action, int mods)
+{
+    if (_previous_button_callback != nullptr) _previous_button_callback(window, button, action, mods);
+    if (button != GLFW_MOUSE_BUTTON_LEFT) return;
+#if defined(PLATFORM_WEB)
+    if (_last_touch_time >= 0.0 && GetTime() - _last_touch_time < TOUCH_MOUSE_SUPPRESS_TIME) return;
+#endif
+    if (action == GLFW_PRESS) input_queue_capture(INPUT_PRESS, _queue.position);
+    else if (action == GLFW_RELEASE) input_queue_capture(INPUT_RELEASE, _queue.position);
+}
+
+static void input_cursor_callback(GLFWwindow* window, double x, double y)
+{
+    if (_previous_cursor_callback != nullptr) _previous_cursor_callback(window, x, y);
+#if defined(PLATFORM_WEB)
+    if (_last_touch_time >= 0.0 && GetTime() - _last_touch_time < TOUCH_MOUSE_SUPPRESS_TIME) return;
+#endif
+    // Same mapping as raylib without mouse offset
+    input_queue_capture(INPUT_MOVE, Vector2{ (float)x * _position_scale, (float)y * _position_scale });
+}
+#endif
+
+#if defined(PLATFORM_WEB)
+EM_JS(void, input_canvas_rect, (float* rect), {
+    var r = Module['canvas'].getBoundingClientRect();
+    HEAPF32[(rect >> 2) + 0] = r.left;
+    HEAPF32[(rect >> 2) + 1] = r.top;
+    HEAPF32[(rect >> 2) + 2] = r.width;
+    HEAPF32[(rect >> 2) + 3] = r.height;
+});
+
+// Only the first finger drags, the listener sits on the document in the capture phase so it
+// runs before the emulated mouse events of the canvas
+static EM_BOOL input_touch_callback(int event_type, const EmscriptenTouchEvent* event, void* user_data)
+{
+    float rect[4];
+    input_canvas_rect(rect);
+    if (rect[2] <= 0 || rect[3] <= 0) return 0;
+
+    for (int i = 0; i < event->numTouches; ++i) {
+        const EmscriptenTouchPoint* touch = &event->touches[i];
+        if (!touch->isChanged) continue;
+
+        Vector2 position = {
+            ((float)touch->clientX - rect[0]) * (float)GetScreenWidth() / rect[2] * _position_scale,
+            ((float)touch->clientY - rect[1]) * (float)GetScreenHeight() / rect[3] * _position_scale
+        };
+        _last_touch_time = GetTime();
+
+        if (event_type == EMSCRIPTEN_EVENT_TOUCHSTART && _touch_id < 0) {
+            _touch_id = touch->identifier;
+            _queue.position = position;
+            input_queue_capture(INPUT_PRESS, position);
+        }
+        else if (touch->identifier == _touch_id) {
+            if (event_type == EMSCRIPTEN_EVENT_TOUCHMOVE) {
+                input_queue_capture(INPUT_MOVE, position);
+            }
+            else if (event_type == EMSCRIPTEN_EVENT_TOUCHEND || event_type == EMSCRIPTEN_EVENT_TOUCHCANCEL) {
+                input_queue_capture(INPUT_RELEASE, position);
+                _touch_id = -1;
+            }
+        }
+    }
+    return 0;
+}
+#endif
+
+void input_queue_init()
+{
+    _queue = InputQueue{};
+    _queue.position = GetMousePosition();
+
+#if defined(INPUT_USE_GLFW)
+    GLFWwindow* window = (GLFWwindow*)GetWindowHandle();
+    if (window != nullptr) {
+        _previous_button_callback = glfwSetMouseButtonCallback(window, input_mouse_button_callback);
+        _previous_cursor_callback = glfwSetCursorPosCallback(window, input_cursor_callback);
+    }
+#endif
+
+#if defined(PLATFORM_WEB)
+    emscripten_set_touchstart_callback(EMSCRIPTEN_EVENT_TARGET_DOCUMENT, nullptr, 1, input_touch_callback);
+    emscripten_set_touchmove_callback(EMSCRIPTEN_EVENT_TARGET_DOCUMENT, nullptr, 1, input_touch_callback);
+    emscripten_set_touchend_callback(EMSCRIPTEN_EVENT_TARGET_DOCUMENT, nullptr, 1, input_touch_callback);
+    emscripten_set_touchcancel_callback(EMSCRIPTEN_EVENT_TARGET_DOCUMENT, nullptr, 1, input_touch_callback);
+#endif
+}
+
+void input_queue_shutdown()
+{
+#if defined(INPUT_USE_GLFW)
+    GLFWwindow* window = (GLFWwindow*)GetWindowHandle();
+    if (window != nullptr) {
+        glfwSetMouseButtonCallback(window, _previous_button_callback);
+        glfwSetCursorPosCallback(window, _previous_cursor_callback);
+    }
+    _previous_button_callback = nullptr;
+    _previous_cursor_callback = nullptr;
+#endif
+
+#if defined(PLATFORM_WEB)
+    emscripten_set_touchstart_callback(EMSCRIPTEN_EVENT_TARGET_DOCUMENT, nullptr, 1, nullptr);
+    emscripten_set_touchmove_callback(EMSCRIPTEN_EVENT_TARGET_DOCUMENT, nullptr, 1, nullptr);
+    emscripten_set_touchend_callback(EMSCRIPTEN_EVENT_TARGET_DOCUMENT, nullptr, 1, nullptr);
+    emscripten_set_touchcancel_callback(EMSCRIPTEN_EVENT_TARGET_DOCUMENT, nullptr, 1, nullptr);
+#endif
+    input_queue_clear();
+}
+
+void input_queue_sync()
+{
+    Vector2 mouse = GetMousePosition();
+    double now = GetTime();
+
+    if (IsMouseButtonPressed(MOUSE_LEFT_BUTTON) && _queue.captured_presses == 0) {
+        input_queue_push(InputEvent{ INPUT_PRESS, mouse, now });
+    }
+    else if (_queue.pressed && _queue.captured_moves == 0 &&
+        (mouse.x != _queue.position.x || mouse.y != _queue.position.y)) {
+        input_queue_push(InputEvent{ INPUT_MOVE, mouse, now });
+    }
+    if (IsMouseButtonReleased(MOUSE_LEFT_BUTTON) && _queue.captured_releases == 0) {
+        input_queue_push(InputEvent{ INPUT_RELEASE, mouse, now });
+    }
+
+    _queue.captured_presses = 0;
+    _queue.captured_releases = 0;
+    _queue.captured_moves = 0;
+}
@@ -0,0 +1,53 @@
+/*******************************************************************************************
+*
+*   WordGrid
+*   Simple Word Puzzle Game
+*   (C) Harald Scheirich 2024
+*   WordGrid is is licensed under an unmodified zlib/libpng license see LICENSE
+*
+*   Pointer events captured as they arrive instead of once per frame, a press and release
+*   that happen between two frames are both kept and processed in order
+*
+*   Mouse events come from the GLFW callbacks (chained in front of raylibs own), touches on
+*   the web from the browser. Where neither is available, or for input that only shows up
+*   in raylibs polled state (e.g. automation event playback), events are synthesized from
+*   the polled state in input_queue_sync()
+*
+********************************************************************************************/
+
+#pragma once
+
+#include "raylib.h"
+
+static const int INPUT_QUEUE_CAPACITY = 256;
+
+enum InputEventType {
+    INPUT_PRESS,
+    INPUT_MOVE,
+    INPUT_RELEASE,
+};
+
+struct InputEvent {
+    InputEventType type;
+    Vector2 position;
+    double time;    // GetTime() when the event was received
+};
+
+// Needs an open window, call after InitWindow()
+void input_queue_init();
+void input_queue_shutdown();
+
+// Adds events that were captured by the callbacks but missed in the polled state and
+// the other way around, call once at the start of the update
+void input_queue_sync();
+
+void input_queue_push(InputEvent event);
+bool input_queue_pop(InputEvent* event);
+void input_queue_clear();
+
+// Pointer position of the most recent event
+Vector2 input_queue_position();
+
+// Factor from window coordinates to the positions of the events, keep it the same as
+// SetMouseScale() so captured and polled positions agree
+void input_queue_set_scale(float scale);
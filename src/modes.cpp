@@ -10,45 +10,37 @@
 #include "modes.h"
 #include "raylib-extras.h"
 #include "screens.h"
+#include "sound.h"
 
 static ModeTimeAttack _mode_timeattack;
+static ModeMoveAttack _mode_moveattack;
 
-static Font _clock_font = { 0 };
-constexpr int _codepoint_count = 11;
-int _clock_codepoints[_codepoint_count] = { '0', '1', '2', '3', '4', '5', '6', '7',  '8', '9', ':' };
-
-void mode_timeattack_init() {
-    _mode_timeattack.time_remaining = _mode_timeattack.parameters.initial_time;
-    _mode_timeattack.next_increase = _mode_timeattack.parameters.words_to_increase;
-
-    _clock_font = LoadFontEx("resources/fredoka_medium.ttf", 96, _clock_codepoints, _codepoint_count);
+void mode_timeattack_init(Game* game) {
+    game->timeattack.time_remaining = _mode_timeattack.parameters.initial_time;
+    game->timeattack.next_increase = _mode_timeattack.parameters.words_to_increase;
 }
 
+// The texts are laid out again when their values change, the clock once a second
 void mode_timeattack_draw(Game* game) {
-    int minutes = (int)_mode_timeattack.time_remaining / 60;
-    int seconds = (int)_mode_timeattack.time_remaining - minutes * 60;
-
-    const char* text = TextFormat("%02d:%02d", minutes, seconds);
-
-    DrawTextEx(_clock_font, text, _mode_timeattack.layout.clock_pos, (float)_clock_font.baseSize, 1.0f, BLACK);
+    int minutes = (int)game->timeattack.time_remaining / 60;
+    int seconds = (int)game->timeattack.time_remaining - minutes * 60;
+    text_label_drawf(&_mode_timeattack.clock, text_label_key(minutes, seconds), _mode_timeattack.layout.clock_pos, BLACK,
+        "%02d:%02d", minutes, seconds);
 
     Vector2 pos = _mode_timeattack.layout.text_pos;
-    text = TextFormat("Total Words: %d", game->word_count);
-    DrawTextDefaultV(text, pos, BLACK);
+    text_label_drawf(&_mode_timeattack.lines[0], game->word_count, pos, BLACK, "Total Words: %d", game->word_count);
     pos.y += 32;
-    text = TextFormat("%d more words for bonus time", _mode_timeattack.next_increase - game->word_count);
-    DrawTextDefaultV(text, pos, BLACK);
+    int missing = game->timeattack.next_increase - game->word_count;
+    text_label_drawf(&_mode_timeattack.lines[1], missing, pos, BLACK, "%d more words for bonus time", missing);
 }
 
 bool mode_timeattack_update(Game* game) {
-    _mode_timeattack.time_remaining -= GetFrameTime();
-    if (_mode_timeattack.time_remaining < 0) {
+    game->timeattack.time_remaining -= GetFrameTime();
+    if (game->timeattack.time_remaining < 0) {
         return false;
     }
-    if (_mode_timeattack.next_increase < game->word_count) {
-        _mode_timeattack.time_remaining += _mode_timeattack.parameters.time_increase;
-        // TODO Play Sound
-        _mode_timeattack.next_increase += _mode_timeattack.parameters.words_to_increase;
+    if (game_timeattack_bonus(game, _mode_timeattack.parameters.time_increase, _mode_timeattack.parameters.words_to_increase)) {
+        sound_play(SOUND_BONUS);
     }
 
     return true;
@@ -58,33 +50,31 @@ void mode_timeattack_unload() {
 
 }
 
-void mode_moveattack_init() {
-    _mode_moveattack.available_moves = _mode_moveattack.parameters.initial_moves;
-    _mode_moveattack.next_increase = _mode_moveattack.parameters.words_to_increase;
+void mode_moveattack_init(Game* game) {
+    game->moveattack.available_moves = _mode_moveattack.parameters.initial_moves;
+    game->moveattack.next_increase = _mode_moveattack.parameters.words_to_increase;
 }
 
 void mode_moveattack_draw(Game* game) {
     const int line_height = 32;
     Vector2 pos = _mode_moveattack.layout.text_pos;
-    const char* text = TextFormat("Total Words: %d", game->word_count);
-    DrawTextDefaultV(text, pos, BLACK);
+    text_label_drawf(&_mode_moveattack.lines[0], game->word_count, pos, BLACK, "Total Words: %d", game->word_count);
     pos.y += line_height;
-    text = TextFormat("More moves in %d words", _mode_moveattack.next_increase - game->word_count);
-    DrawTextDefaultV(text, pos, BLACK);
+    int missing = game->moveattack.next_increase - game->word_count;
+    text_label_drawf(&_mode_moveattack.lines[1], missing, pos, BLACK, "More moves in %d words", missing);
     pos.y += line_height;
-    text = TextFormat("You have %d moves left", _mode_moveattack.available_moves - game->move_count);
-    DrawTextDefaultV(text, pos, BLACK);
-
+    int moves = game->moveattack.available_moves - game->move_count;
+    text_label_drawf(&_mode_moveattack.lines[2], moves, pos, BLACK, "You have %d moves left", moves);
 }
 
 bool mode_moveattack_update(Game* game) {
-    if (_mode_moveattack.next_increase < game->word_count) {
-        _mode_moveattack.available_moves += _mode_moveattack.parameters.move_increase;
-        // TODO Play Sound
-        _mode_moveattack.next_increase += _mode_moveattack.parameters.words_to_increase;
+    if (game->moveattack.next_increase < game->word_count) {
+        game->moveattack.available_moves += _mode_moveattack.parameters.move_increase;
+        sound_play(SOUND_BONUS);
+        game->moveattack.next_increase += _mode_moveattack.parameters.words_to_increase;
     }
 
-    if (_mode_moveattack.available_moves - game->move_count <= 0) {
+    if (game->moveattack.available_moves - game->move_count <= 0) {
         return false;
     }
 
@@ -92,5 +82,93 @@ bool mode_moveattack_update(Game* game) {
 }
 
 void mode_moveattack_unload() {
-    UnloadFont(_clock_font);
+
+}
+
+static ModeVersus _mode_versus;
+
+void mode_versus_set_difficulty(AiDifficulty difficulty) {
+    _mode_versus.parameters.difficulty = difficulty;
+}
+
+AiDifficulty mode_versus_difficulty() {
+    return _mode_versus.parameters.difficulty;
+}
+
+void mode_versus_init(Game* game) {
+    game->versus = ModeVersusState{};
+    game->versus.moves_left = 2 * _mode_versus.parameters.moves_per_player;
+    game->versus.difficulty = _mode_versus.parameters.difficulty;
+}
+
+void mode_versus_draw(Game* game) {
+    const int line_height = 32;
+    const ModeVersusState* versus = &game->versus;
+    Vector2 pos = _mode_versus.layout.text_pos;
+    text_label_drawf(&_mode_versus.lines[0], versus->scores[0], pos, BLACK, "You: %d words", versus->scores[0]);
+    pos.y += line_height;
+    text_label_drawf(&_mode_versus.lines[1], text_label_key(versus->difficulty, versus->scores[1]), pos, BLACK,
+        "Computer (%s): %d words", AI_LEVELS[versus->difficulty].name, versus->scores[1]);
+    pos.y += line_height;
+    const char* turn = (versus->turn == 0) ? "Your turn" : "The computer is thinking ...";
+    text_label_drawf(&_mode_versus.lines[2], versus->turn, pos, (versus->turn == 0) ? DARKGREEN : DARKGRAY, "%s", turn);
+    pos.y += line_height;
+    text_label_drawf(&_mode_versus.lines[3], versus->moves_left, pos, BLACK, "%d moves left", versus->moves_left);
+}
+
+// Words made since the turn changed go to the side that moved
+bool mode_versus_update(Game* game) {
+    ModeVersusState* versus = &game->versus;
+    if (game->move_count != versus->moves_seen) {
+        versus->scores[versus->turn] += game->word_count - versus->words_seen;
+        versus->moves_left -= game->move_count - versus->moves_seen;
+        versus->moves_seen = game->move_count;
+        versus->words_seen = game->word_count;
+        versus->turn = 1 - versus->turn;
+    }
+
+    // Both sides play from the same well, when it has no moves nobody does
+    uint8_t moves[AI_MAX_MOVES];
+    return versus->moves_left > 0 && ai_generate_moves(game, moves) > 0;
+}
+
+void mode_versus_unload() {
+
+}
+
+void mode_versus_pass(Game* game) {
+    game->versus.moves_left -= 1;
+    game->versus.turn = 1 - game->versus.turn;
+}
+
+void modes_init_labels() {
+    text_label_init(&_mode_timeattack.clock, &g_font, FONT_SIZE_LARGE);
+    for (TextLabel& label : _mode_timeattack.lines) text_label_init(&label, &g_default_font, g_default_font_size);
+    for (TextLabel& label : _mode_moveattack.lines) text_label_init(&label, &g_default_font, g_default_font_size);
+    for (TextLabel& label : _mode_versus.lines) text_label_init(&label, &g_default_font, g_default_font_size);
+}
+
+const TextLabel* mode_label(GameMode mode, int line) {
+    switch (mode) {
+    case MODE_TIMEATTACK:
+        if (line == 2) return &_mode_timeattack.clock;
+        return (line >= 0 && line < 2) ? &_mode_timeattack.lines[line] : nullptr;
+    case MODE_MOVEATTACK:
+        return (line >= 0 && line < 3) ? &_mode_moveattack.lines[line] : nullptr;
+    case MODE_VERSUS:
+        return (line >= 0 && line < 4) ? &_mode_versus.lines[line] : nullptr;
+    default:
+        return nullptr;
+    }
+}
+
+void modes_layout(Rectangle area) {
+    Vector2 text_pos = Vector2{ area.x, area.y };
+    _mode_timeattack.layout.text_pos = text_pos;
+    _mode_moveattack.layout.text_pos = text_pos;
+    _mode_versus.layout.text_pos = text_pos;
+
+    // The clock is centered below the two lines of the time attack
+    float clock_width = MeasureTextEx(g_font.font, "00:00", FONT_SIZE_LARGE, 1.0f).x;
+    _mode_timeattack.layout.clock_pos = Vector2{ area.x + (area.width - clock_width) / 2.0f, area.y + 80 };
 }
@@ -10,6 +10,8 @@
 
 #include "raylib.h"
 #include "screens.h"
+#include "ai_search.h"
+#include "text_label.h"
 
 struct ModeTimeAttackParameters {
     float initial_time = 300;
@@ -17,19 +19,21 @@ struct ModeTimeAttackParameters {
     float time_increase = 30;
 };
 
+// Placed by modes_layout()
 struct ModeTimeAttackLayout {
-    Vector2 clock_pos = Vector2{ 560, 100};
-    Vector2 text_pos = Vector2{ 500, 20 };
+    Vector2 clock_pos = Vector2{ 0, 0 };
+    Vector2 text_pos = Vector2{ 0, 0 };
 };
 
+// Running state lives in Game::timeattack
 struct ModeTimeAttack {
-    float time_remaining;
-    int next_increase;
     ModeTimeAttackParameters parameters;
     ModeTimeAttackLayout layout;
+    TextLabel clock;
+    TextLabel lines[2];
 };
 
-void mode_timeattack_init();
+void mode_timeattack_init(Game* game);
 void mode_timeattack_draw(Game* game);
 bool mode_timeattack_update(Game* game);
 void mode_timeattack_unload();
@@ -41,19 +45,54 @@ struct ModeMoveAttackParameters {
 };
 
 struct ModeMoveAttackLayout {
-    Vector2 text_pos = Vector2{ 500, 20 };
+    Vector2 text_pos = Vector2{ 0, 0 };
 };
 
+// Running state lives in Game::moveattack
 struct ModeMoveAttack {
-    int available_moves;
-    int next_increase;
     ModeMoveAttackParameters parameters;
     ModeMoveAttackLayout layout;
+    TextLabel lines[3];
 };
 
-static ModeMoveAttack _mode_moveattack;
-
-void mode_moveattack_init();
+void mode_moveattack_init(Game* game);
 void mode_moveattack_draw(Game* game);
 bool mode_moveattack_update(Game* game);
 void mode_moveattack_unload();
+
+struct ModeVersusParameters {
+    int moves_per_player = 15;
+    AiDifficulty difficulty = AI_NORMAL;    // For the next game
+};
+
+struct ModeVersusLayout {
+    Vector2 text_pos = Vector2{ 0, 0 };
+};
+
+// Running state lives in Game::versus, the computer moves from the game screen
+struct ModeVersus {
+    ModeVersusParameters parameters;
+    ModeVersusLayout layout;
+    TextLabel lines[4];
+};
+
+void mode_versus_set_difficulty(AiDifficulty difficulty);
+AiDifficulty mode_versus_difficulty();
+void mode_versus_init(Game* game);
+void mode_versus_draw(Game* game);
+bool mode_versus_update(Game* game);
+void mode_versus_unload();
+
+// The side to move gives up its move
+void mode_versus_pass(Game* game);
+
+// Sets up the texts of every mode, they do not depend on the game so a resumed game finds
+// them ready whatever mode was set up before it
+void modes_init_labels();
+
+// Line `line` of the texts of `mode`, the clock of the time attack comes after its lines.
+// nullptr past the last one
+const TextLabel* mode_label(GameMode mode, int line);
+
+// Places the texts of every mode in `area` of the game screen, in design units
+void modes_layout(Rectangle area);
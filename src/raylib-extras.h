@@ -10,27 +10,35 @@
 #pragma once
 
 #include "raylib.h"
+#include "sdf_font.h"
+#include "screen_layout.h"
 
-extern Font g_default_font;
+extern SdfFont g_default_font;
+extern float g_default_font_size;
 
-inline void DrawTextDefault(const char* text, float x, float y, Color color) {
-    DrawTextEx(g_default_font, text, Vector2(x, y), (float)g_default_font.baseSize, 1.0f, color);
+inline void DrawTextDefaultV(const char* text, Vector2 pos, Color color) {
+    sdf_font_begin(&g_default_font);
+    DrawTextEx(g_default_font.font, text, pos, g_default_font_size, 1.0f, color);
+    sdf_font_end(&g_default_font);
 }
 
-inline void DrawTextDefaultV(const char* text, Vector2 pos, Color color) {
-    DrawTextEx(g_default_font, text, pos, (float)g_default_font.baseSize, 1.0f, color);
+inline void DrawTextDefault(const char* text, float x, float y, Color color) {
+    DrawTextDefaultV(text, Vector2(x, y), color);
 }
 
-inline void FontSetDefaultFont(Font default_font)
+inline void FontSetDefaultFont(SdfFont default_font, float size)
 {
     g_default_font = default_font;
+    g_default_font_size = size;
 }
 
-// Utility function to draw a text line that's centered horizontally on the screen
-inline void DrawTextCenteredHorizontally(Font font, const char* text, float y, float spacing, Color color)
+// Utility function to draw a text line that's centered horizontally on the visible design area
+inline void DrawTextCenteredHorizontally(const SdfFont* font, const char* text, float y, float size, Color color)
 {
-    Vector2 pos = MeasureTextEx(font, text, (float)font.baseSize * 1.0f, 1.0f);
+    Vector2 pos = MeasureTextEx(font->font, text, size, 1.0f);
     pos.y = y;
-    pos.x = (GetScreenWidth() - pos.x) / 2.0f;
-    DrawTextEx(font, text, pos, (float)font.baseSize, 1.0f, color);
+    pos.x = (screen_layout_size().x - pos.x) / 2.0f;
+    sdf_font_begin(font);
+    DrawTextEx(font->font, text, pos, size, 1.0f, color);
+    sdf_font_end(font);
 }
\ No newline at end of file
@@ -20,6 +20,15 @@
 
 #include "screens.h"    // NOTE: Declares global (extern) variables and screens functions
 #include "raylib-extras.h"
+#include "resource_pack.h"
+#include "ai_player.h"
+#include "input_queue.h"
+#include "save_game.h"
+#include "sound.h"
+#include "high_scores.h"
+#include "hot_reload.h"
+#include "screen_layout.h"
+#include "game_app.h"
 
 #if defined(PLATFORM_WEB)
     #include <emscripten/emscripten.h>
@@ -30,17 +39,25 @@
 // NOTE: Those variables are shared between modules through screens.h
 //----------------------------------------------------------------------------------
 GameScreen g_currentScreen = LOGO;
-Font g_font_small = { 0 };
-Font g_font_large = { 0 };
-Font g_default_font = { 0 };
+SdfFont g_font;
+SdfFont g_default_font;
+float g_default_font_size = FONT_SIZE_SMALL;
+bool g_assets_ready = false;
+bool g_resume_game = false;
 
 Game g_game{};
+DictionaryStore g_dictionary_store;
+Arena g_game_arena;
+Arena g_frame_arena;
+
+static const size_t GAME_ARENA_SIZE = 64 * 1024;
+static const size_t FRAME_ARENA_SIZE = 16 * 1024;
 
 //----------------------------------------------------------------------------------
 // Local Variables Definition (local to this module)
 //----------------------------------------------------------------------------------
-static const int screenWidth = 852;
-static const int screenHeight = 393;
+static const int screenWidth = (int)LAYOUT_DESIGN_WIDTH;     // Initial size, the window can be resized
+static const int screenHeight = (int)LAYOUT_DESIGN_HEIGHT;
 
 // Required variables to manage screen transitions (fade-in, fade-out)
 static float transAlpha = 0.0f;
@@ -58,32 +75,34 @@ static void TransitionToScreen(int screen); // Request transition to next screen
 static void UpdateTransition(void);         // Update transition effect
 static void DrawTransition(void);           // Draw transition effect (full-screen rectangle)
 
+#if !defined(WORDGRID_NO_MAIN)
 static void UpdateDrawFrame(void);          // Update and draw one frame
+#endif
+
+static void load_global_assets(void);       // Fonts and gui style, needs the resources
+
+#if defined(PLATFORM_WEB)
+static void on_archive_loaded(void* arg, void* data, int size)
+{
+    resource_pack_open_memory((const unsigned char*)data, size);
+    load_global_assets();
+}
+
+static void on_archive_failed(void* arg)
+{
+    TraceLog(LOG_ERROR, "PACK: Could not download resources.wgpak");
+    load_global_assets();
+}
+#endif
 
 //----------------------------------------------------------------------------------
 // Main entry point
 //----------------------------------------------------------------------------------
+#if !defined(WORDGRID_NO_MAIN)
 int main(void)
 {
-    // Initialization
-    //---------------------------------------------------------
-    InitWindow(screenWidth, screenHeight, "Wordgrid");
-
-    InitAudioDevice();      // Initialize audio device
-
-    // Load global data (assets that must be available in all screens, i.e. font)
-    g_font_small = LoadFontEx("resources/fredoka_medium.ttf",24, nullptr, 0);
-    g_default_font = g_font_small;
-
-    g_font_large = LoadFontEx("resources/fredoka_medium.ttf", 96, nullptr, 0);
-
-    GuiSetFont(g_font_small);
-    GuiSetStyle(DEFAULT, TEXT_SIZE, 24);
-    
-
-    // Setup and init first screen
-    g_currentScreen = LOGO;
-    init_logo_screen();
+    // The screens scale with the window, see screen_layout.h
+    game_app_init(FLAG_WINDOW_RESIZABLE | FLAG_WINDOW_HIGHDPI);
 
 #if defined(PLATFORM_WEB)
     emscripten_set_main_loop(UpdateDrawFrame, 60, 1);
@@ -98,6 +117,41 @@ int main(void)
     }
 #endif
 
+    game_app_shutdown();
+    return 0;
+}
+#endif
+
+void game_app_init(unsigned int config_flags)
+{
+    // Initialization
+    //---------------------------------------------------------
+    SetConfigFlags(config_flags);
+    InitWindow(screenWidth, screenHeight, "Wordgrid");
+    SetWindowMinSize(screenWidth / 2, screenHeight / 2);
+    input_queue_init();     // Capture pointer events between frames
+    arena_init(&g_game_arena, GAME_ARENA_SIZE, "game arena");
+    arena_init(&g_frame_arena, FRAME_ARENA_SIZE, "frame arena");
+    high_scores_open();
+    hot_reload_init();      // Debug builds only
+    screen_layout_update(); // Needs the input queue
+
+#if defined(PLATFORM_WEB)
+    // Nothing is preloaded on the web, the archive is downloaded while the logo plays
+    emscripten_async_wget_data("resources.wgpak", nullptr, on_archive_loaded, on_archive_failed);
+#else
+    // All assets are read from the archive when it exists, loose files otherwise
+    resource_pack_open("resources.wgpak");
+    load_global_assets();
+#endif
+
+    // Setup and init first screen
+    g_currentScreen = LOGO;
+    init_logo_screen();
+}
+
+void game_app_shutdown()
+{
     // De-Initialization
     //--------------------------------------------------------------------------------------
     // Unload current screen data before closing
@@ -110,20 +164,45 @@ int main(void)
         default: break;
     }
 
+    ai_player_shutdown();
+    save_game_shutdown();
+    high_scores_close();
+    hot_reload_shutdown();
+    dictionary_store_clear(&g_dictionary_store);
+    arena_unload(&g_game_arena);
+    arena_unload(&g_frame_arena);
+
     // Unload global data loaded
-    UnloadFont(g_font_small);
+    if (g_assets_ready) {
+        sdf_font_unload(&g_font);
+    }
+
+    resource_pack_close();
+
+    sound_shutdown();       // Closes the audio device if a game opened it
 
-    CloseAudioDevice();     // Close audio context
+    input_queue_shutdown();
 
     CloseWindow();          // Close window and OpenGL context
     //--------------------------------------------------------------------------------------
-
-    return 0;
 }
 
 //----------------------------------------------------------------------------------
 // Module specific Functions Definition
 //----------------------------------------------------------------------------------
+// Load global data (assets that must be available in all screens, i.e. font)
+static void load_global_assets(void)
+{
+    // Every size is drawn from this atlas, 48 pixels keep the outlines exact up to the clock
+    sdf_font_load(&g_font, "resources/fredoka_medium.ttf", 48);
+    FontSetDefaultFont(g_font, FONT_SIZE_SMALL);
+
+    GuiSetFont(g_font.font);
+    GuiSetStyle(DEFAULT, TEXT_SIZE, (int)FONT_SIZE_SMALL);
+
+    g_assets_ready = true;
+}
+
 // Change to next screen, no transition
 static void ChangeToScreen(GameScreen screen)
 {
@@ -221,12 +300,24 @@ static void DrawTransition(void)
     DrawRectangle(0, 0, GetScreenWidth(), GetScreenHeight(), Fade(BLACK, transAlpha));
 }
 
+#if !defined(WORDGRID_NO_MAIN)
 // Update and draw game frame
 static void UpdateDrawFrame(void)
 {
+    game_app_frame(nullptr);
+}
+#endif
+
+void game_app_frame(FrameTiming* timing)
+{
+    double start = GetTime();
+
     // Update
     //----------------------------------------------------------------------------------
     //UpdateMusicStream(music);       // NOTE: Music keeps playing between screens
+    arena_reset(&g_frame_arena);
+    hot_reload_update();
+    screen_layout_update();
 
     if (!onTransition)
     {
@@ -236,7 +327,12 @@ static void UpdateDrawFrame(void)
             {
                 update_logo_screen();
 
-                if (finish_logo_screen()) TransitionToScreen(TITLE);
+                // The logo keeps showing until the downloaded assets are in place, a game
+                // that was left running continues right away
+                if (finish_logo_screen() && g_assets_ready) {
+                    g_resume_game = save_game_exists();
+                    TransitionToScreen(g_resume_game ? GAMEPLAY : TITLE);
+                }
 
             } break;
             case TITLE:
@@ -273,7 +369,12 @@ static void UpdateDrawFrame(void)
         }
     }
     else UpdateTransition();    // Update transition (fade-in, fade-out)
+
+    // Only the game screen takes the captured pointer events, the other screens use the
+    // polled state and the events would pile up until the queue overflows
+    if (onTransition || g_currentScreen != GAMEPLAY) input_queue_clear();
     //----------------------------------------------------------------------------------
+    double updated = GetTime();
 
     // Draw
     //----------------------------------------------------------------------------------
@@ -281,6 +382,7 @@ static void UpdateDrawFrame(void)
 
         ClearBackground(RAYWHITE);
 
+        screen_layout_begin();
         switch(g_currentScreen)
         {
             case LOGO: draw_logo_screen(); break;
@@ -290,12 +392,21 @@ static void UpdateDrawFrame(void)
             case ENDING: draw_ending_screen(); break;
             default: break;
         }
+        hot_reload_draw();
+        screen_layout_end();
 
         // Draw full screen rectangle in front of everything
         if (onTransition) DrawTransition();
 
         //DrawFPS(10, 10);
 
+    double drawn = GetTime();
     EndDrawing();
     //----------------------------------------------------------------------------------
+
+    if (timing != nullptr) {
+        timing->update = updated - start;
+        timing->draw = drawn - updated;
+        timing->present = GetTime() - drawn;
+    }
 }
@@ -0,0 +1,237 @@
+/*******************************************************************************************
+*
+*   WordGrid
+*   Simple Word Puzzle Game
+*   (C) Harald Scheirich 2024
+*   WordGrid is is licensed under an unmodified zlib/libpng license see LICENSE
+*
+********************************************************************************************/
+
+#include "resource_pack.h"
+
+#include <limits.h>
+#include <stdio.h>
+#include <string.h>
+
+#if !defined(_WIN32) && !defined(PLATFORM_WEB)
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+    #define PACK_USE_MMAP
+#endif
+
+struct ResourcePack {
+    const unsigned char* data = nullptr;
+    size_t size = 0;
+    const PackHeader* header = nullptr;
+    const PackEntry* entries = nullptr;
+    const char* names = nullptr;
+    bool mapped = false;    // Memory comes from mmap instead of MemAlloc
+};
+
+static ResourcePack _pack;
+
+static const PackEntry* resource_pack_find(const char* filename)
+{
+    if (_pack.header == nullptr) return nullptr;
+    if (filename[0] == '.' && filename[1] == '/') filename += 2;
+
+    size_t length = strlen(filename);
+    int low = 0;
+    int high = (int)_pack.header->entry_count - 1;
+    while (low <= high) {
+        int mid = (low + high) / 2;
+        const PackEntry* entry = &_pack.entries[mid];
+        size_t common = (entry->name_length < length) ? entry->name_length : length;
+        int order = memcmp(_pack.names + entry->name_offset, filename, common);
+        if (order == 0) order = (entry->name_length < length) ? -1 : (entry->name_length > length ? 1 : 0);
+        if (order == 0) return entry;
+        if (order < 0) low = mid + 1;
+        else high = mid - 1;
+    }
+    return nullptr;
+}
+
+// Returns a buffer that raylib can release with UnloadFileData(), `extra` zeroed bytes are appended
+static unsigned char* resource_pack_extract(const PackEntry* entry, int extra)
+{
+    const unsigned char* source = _pack.data + entry->data_offset;
+    unsigned char* result = (unsigned char*)MemAlloc(entry->size + extra);
+    if (result == nullptr) return nullptr;
+
+    if ((entry->flags & PACK_FLAG_DEFLATE) != 0) {
+        int size = 0;
+        unsigned char* inflated = DecompressData(source, (int)entry->stored_size, &size);
+        if (inflated == nullptr || size != (int)entry->size) {
+            TraceLog(LOG_ERROR, "PACK: Failed to inflate entry of %u bytes", entry->size);
+            MemFree(inflated);
+            MemFree(result);
+            return nullptr;
+        }
+        memcpy(result, inflated, entry->size);
+        MemFree(inflated);
+    }
+    else {
+        memcpy(result, source, entry->size);
+    }
+    return result;
+}
+
+static unsigned char* resource_read_disk(const char* filename, int* size, int extra)
+{
+    *size = 0;
+    FILE* file = fopen(filename, "rb");
+    if (file == nullptr) {
+        TraceLog(LOG_WARNING, "FILEIO: [%s] Failed to open file", filename);
+        return nullptr;
+    }
+    fseek(file, 0, SEEK_END);
+    long length = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    unsigned char* result = (unsigned char*)MemAlloc((unsigned int)(length + extra));
+    if (result != nullptr) {
+        *size = (int)fread(result, 1, length, file);
+    }
+    fclose(file);
+    return result;
+}
+
+static unsigned char* resource_load_file_data(const char* filename, int* size)
+{
+    const PackEntry* entry = resource_pack_find(filename);
+    if (entry == nullptr) return resource_read_disk(filename, size, 0);
+
+    unsigned char* result = resource_pack_extract(entry, 0);
+    *size = (result != nullptr) ? (int)entry->size : 0;
+    return result;
+}
+
+static char* resource_load_file_text(const char* filename)
+{
+    const PackEntry* entry = resource_pack_find(filename);
+    if (entry == nullptr) {
+        int size = 0;
+        char* text = (char*)resource_read_disk(filename, &size, 1);
+        if (text != nullptr) text[size] = 0;
+        return text;
+    }
+    return (char*)resource_pack_extract(entry, 1);
+}
+
+static bool resource_pack_map(const char* filename)
+{
+#if defined(PACK_USE_MMAP)
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) return false;
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size == 0) {
+        close(fd);
+        return false;
+    }
+    void* data = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) return false;
+    _pack.data = (const unsigned char*)data;
+    _pack.size = (size_t)info.st_size;
+    _pack.mapped = true;
+    return true;
+#else
+    // No mapping on the web or windows, the archive is read once and kept in memory
+    int size = 0;
+    _pack.data = LoadFileData(filename, &size);
+    _pack.size = (size_t)size;
+    return _pack.data != nullptr;
+#endif
+}
+
+static void resource_pack_unmap()
+{
+    if (_pack.data == nullptr) return;
+#if defined(PACK_USE_MMAP)
+    if (_pack.mapped) munmap((void*)_pack.data, _pack.size);
+    else UnloadFileData((unsigned char*)_pack.data);
+#else
+    UnloadFileData((unsigned char*)_pack.data);
+#endif
+    _pack = ResourcePack{};
+}
+
+// The name and the data have to be inside the archive, sizes are handed out as int
+static bool resource_pack_valid_entry(const PackEntry* entry, uint64_t names_offset)
+{
+    uint64_t name_end = names_offset + entry->name_offset + entry->name_length;
+    uint64_t data_end = (uint64_t)entry->data_offset + entry->stored_size;
+    bool stored_as_is = (entry->flags & PACK_FLAG_DEFLATE) == 0;
+    return name_end <= _pack.size && data_end <= _pack.size &&
+        entry->size < (uint32_t)INT_MAX && entry->stored_size < (uint32_t)INT_MAX &&
+        (!stored_as_is || entry->stored_size == entry->size);
+}
+
+// Every entry is checked once here, a truncated or corrupt archive is rejected as a whole
+static bool resource_pack_attach(const char* filename)
+{
+    const PackHeader* header = (const PackHeader*)_pack.data;
+    bool valid = _pack.size >= sizeof(PackHeader) && memcmp(header->magic, PACK_MAGIC, 4) == 0 &&
+        header->version == PACK_VERSION &&
+        sizeof(PackHeader) + (uint64_t)header->entry_count * sizeof(PackEntry) <= _pack.size &&
+        header->names_offset <= _pack.size;
+    const PackEntry* entries = (const PackEntry*)(_pack.data + sizeof(PackHeader));
+    for (uint32_t i = 0; valid && i < header->entry_count; ++i) {
+        valid = resource_pack_valid_entry(&entries[i], header->names_offset);
+    }
+    if (!valid) {
+        TraceLog(LOG_ERROR, "PACK: %s is not a valid resource archive", filename);
+        resource_pack_unmap();
+        return false;
+    }
+
+    _pack.header = header;
+    _pack.entries = (const PackEntry*)(_pack.data + sizeof(PackHeader));
+    _pack.names = (const char*)(_pack.data + header->names_offset);
+
+    SetLoadFileDataCallback(resource_load_file_data);
+    SetLoadFileTextCallback(resource_load_file_text);
+
+    TraceLog(LOG_INFO, "PACK: Opened %s with %u entries", filename, header->entry_count);
+    return true;
+}
+
+bool resource_pack_open(const char* filename)
+{
+    resource_pack_close();
+    if (!resource_pack_map(filename)) {
+        TraceLog(LOG_INFO, "PACK: No archive at %s, using loose files", filename);
+        return false;
+    }
+    return resource_pack_attach(filename);
+}
+
+bool resource_pack_open_memory(const unsigned char* data, int size)
+{
+    resource_pack_close();
+    unsigned char* copy = (unsigned char*)MemAlloc((unsigned int)size);
+    if (copy == nullptr || size <= 0) {
+        MemFree(copy);
+        return false;
+    }
+    memcpy(copy, data, size);
+    _pack.data = copy;
+    _pack.size = (size_t)size;
+    return resource_pack_attach("memory archive");
+}
+
+void resource_pack_close()
+{
+    if (_pack.header != nullptr) {
+        SetLoadFileDataCallback(nullptr);
+        SetLoadFileTextCallback(nullptr);
+    }
+    resource_pack_unmap();
+}
+
+bool resource_exists(const char* filename)
+{
+    return resource_pack_find(filename) != nullptr || FileExists(filename);
+}
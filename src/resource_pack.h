@@ -0,0 +1,58 @@
+/*******************************************************************************************
+*
+*   WordGrid
+*   Simple Word Puzzle Game
+*   (C) Harald Scheirich 2024
+*   WordGrid is is licensed under an unmodified zlib/libpng license see LICENSE
+*
+*   Resource archive, all assets in one file that is mapped into memory once
+*
+*   Layout (little endian), written by tools/pack_resources.py
+*       PackHeader
+*       PackEntry[entry_count]      sorted by name
+*       names                       concatenated, not 0 terminated
+*       data                        every entry starts at a multiple of PACK_ALIGNMENT
+*
+*   Entries with PACK_FLAG_DEFLATE are raw deflate streams, as written by zlib with
+*   wbits = -15 and read by raylibs DecompressData()
+*
+********************************************************************************************/
+
+#pragma once
+
+#include "raylib.h"
+
+#include <stdint.h>
+
+static const char PACK_MAGIC[4] = { 'W', 'G', 'P', 'K' };
+static const uint32_t PACK_VERSION = 1;
+static const uint32_t PACK_ALIGNMENT = 16;
+static const uint32_t PACK_FLAG_DEFLATE = 0x1;
+
+struct PackHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t entry_count;
+    uint32_t names_offset;
+};
+
+struct PackEntry {
+    uint32_t name_offset;   // Relative to PackHeader::names_offset
+    uint32_t name_length;
+    uint32_t flags;
+    uint32_t data_offset;   // From the start of the file
+    uint32_t stored_size;
+    uint32_t size;
+};
+
+// Maps `filename` and routes raylibs file loading through it, files that are not in the
+// archive are still read from disk. Returns false and keeps the default loaders when the
+// archive can not be opened
+bool resource_pack_open(const char* filename);
+// Same as resource_pack_open() for an archive that was downloaded instead of read from a
+// file, `data` is copied and can be released afterwards
+bool resource_pack_open_memory(const unsigned char* data, int size);
+void resource_pack_close();
+
+// True if `filename` is in the archive or exists on disk
+bool resource_exists(const char* filename);
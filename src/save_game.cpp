@@ -0,0 +1,199 @@
+/*******************************************************************************************
+*
+*   WordGrid
+*   Simple Word Puzzle Game
+*   (C) Harald Scheirich 2024
+*   WordGrid is is licensed under an unmodified zlib/libpng license see LICENSE
+*
+********************************************************************************************/
+
+#include "save_game.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <filesystem>
+
+#if !defined(PLATFORM_WEB)
+    #include <condition_variable>
+    #include <mutex>
+    #include <thread>
+    #define SAVE_USE_THREAD
+#endif
+
+static const char* _save_file = "wordgrid.sav";
+static const char* _save_temp_file = "wordgrid.sav.tmp";
+
+struct SaveData {
+    SaveHeader header;
+    Game game;
+    uint64_t sequence;      // Older requests are not written over newer ones
+};
+
+static uint64_t _next_sequence = 1;
+static uint64_t _written_sequence = 0;
+
+#if defined(SAVE_USE_THREAD)
+static std::mutex _request_mutex;   // Guards the queued request
+static std::mutex _file_mutex;      // Guards the files and _written_sequence
+static std::condition_variable _request_signal;
+static std::thread _worker;
+static SaveData _request;
+static bool _request_pending = false;
+static bool _stop = false;
+#endif
+
+unsigned int save_game_alphabet_key(const Alphabet* alphabet)
+{
+    return ComputeCRC32((unsigned char*)alphabet->codepoints, (alphabet->count + 1) * sizeof(int));
+}
+
+static SaveData save_game_prepare(const Game* game, unsigned int alphabet_key)
+{
+    SaveData data;
+    memcpy(data.header.magic, SAVE_MAGIC, 4);
+    data.header.version = SAVE_VERSION;
+    data.header.game_size = sizeof(Game);
+    data.header.alphabet_key = alphabet_key;
+    data.game = *game;
+    data.header.crc = ComputeCRC32((unsigned char*)&data.game, sizeof(Game));
+    data.sequence = _next_sequence++;
+    return data;
+}
+
+// Caller holds the file lock
+static void save_game_write_file(const SaveData& data)
+{
+    if (data.sequence < _written_sequence) return;
+
+    FILE* file = fopen(_save_temp_file, "wb");
+    if (file == nullptr) {
+        TraceLog(LOG_WARNING, "SAVE: Could not open %s", _save_temp_file);
+        return;
+    }
+    bool ok = fwrite(&data.header, sizeof(SaveHeader), 1, file) == 1 &&
+        fwrite(&data.game, sizeof(Game), 1, file) == 1;
+    ok = (fclose(file) == 0) && ok;
+
+    std::error_code error;
+    if (ok) std::filesystem::rename(_save_temp_file, _save_file, error);
+    if (!ok || error) {
+        TraceLog(LOG_WARNING, "SAVE: Could not write %s", _save_file);
+        std::filesystem::remove(_save_temp_file, error);
+        return;
+    }
+    _written_sequence = data.sequence;
+}
+
+#if defined(SAVE_USE_THREAD)
+static void save_game_worker()
+{
+    std::unique_lock<std::mutex> lock(_request_mutex);
+    while (true) {
+        _request_signal.wait(lock, [] { return _request_pending || _stop; });
+        if (!_request_pending) break;
+
+        SaveData data = _request;
+        _request_pending = false;
+        lock.unlock();
+        {
+            std::lock_guard<std::mutex> file_lock(_file_mutex);
+            save_game_write_file(data);
+        }
+        lock.lock();
+    }
+}
+#endif
+
+bool save_game_exists()
+{
+    return FileExists(_save_file);
+}
+
+bool save_game_read(Game* game, unsigned int alphabet_key)
+{
+    int size = 0;
+    unsigned char* data = LoadFileData(_save_file, &size);
+    if (data == nullptr) return false;
+
+    SaveHeader header;
+    bool valid = size == (int)(sizeof(SaveHeader) + sizeof(Game));
+    if (valid) {
+        memcpy(&header, data, sizeof(SaveHeader));
+        valid = memcmp(header.magic, SAVE_MAGIC, 4) == 0 && header.version == SAVE_VERSION &&
+            header.game_size == sizeof(Game) && header.alphabet_key == alphabet_key &&
+            header.crc == ComputeCRC32(data + sizeof(SaveHeader), sizeof(Game));
+    }
+    if (valid) {
+        memcpy(game, data + sizeof(SaveHeader), sizeof(Game));
+        valid = game->mode > MODE_NONE && game->mode < MODE_COUNT;
+    }
+    if (!valid) TraceLog(LOG_WARNING, "SAVE: Ignoring %s, it does not match this version", _save_file);
+
+    UnloadFileData(data);
+    return valid;
+}
+
+void save_game_write_async(const Game* game, unsigned int alphabet_key)
+{
+#if defined(SAVE_USE_THREAD)
+    {
+        std::lock_guard<std::mutex> lock(_request_mutex);
+        _request = save_game_prepare(game, alphabet_key);
+        _request_pending = true;
+        if (!_worker.joinable()) {
+            _stop = false;
+            _worker = std::thread(save_game_worker);
+        }
+    }
+    _request_signal.notify_one();
+#else
+    save_game_write(game, alphabet_key);
+#endif
+}
+
+void save_game_write(const Game* game, unsigned int alphabet_key)
+{
+#if defined(SAVE_USE_THREAD)
+    SaveData data;
+    {
+        std::lock_guard<std::mutex> lock(_request_mutex);
+        data = save_game_prepare(game, alphabet_key);
+        _request_pending = false;
+    }
+    std::lock_guard<std::mutex> file_lock(_file_mutex);
+    save_game_write_file(data);
+#else
+    save_game_write_file(save_game_prepare(game, alphabet_key));
+#endif
+}
+
+void save_game_delete()
+{
+#if defined(SAVE_USE_THREAD)
+    uint64_t sequence = 0;
+    {
+        std::lock_guard<std::mutex> lock(_request_mutex);
+        _request_pending = false;
+        sequence = _next_sequence;
+    }
+    std::lock_guard<std::mutex> file_lock(_file_mutex);
+#else
+    uint64_t sequence = _next_sequence;
+#endif
+    // Writes that were requested before are outdated now
+    _written_sequence = sequence;
+    std::error_code error;
+    std::filesystem::remove(_save_file, error);
+}
+
+void save_game_shutdown()
+{
+#if defined(SAVE_USE_THREAD)
+    {
+        std::lock_guard<std::mutex> lock(_request_mutex);
+        _stop = true;
+    }
+    _request_signal.notify_one();
+    if (_worker.joinable()) _worker.join();
+#endif
+}
@@ -0,0 +1,49 @@
+/*******************************************************************************************
+*
+*   WordGrid
+*   Simple Word Puzzle Game
+*   (C) Harald Scheirich 2024
+*   WordGrid is is licensed under an unmodified zlib/libpng license see LICENSE
+*
+*   Save and resume of the game in progress
+*
+*   The file is a SaveHeader followed by the bytes of Game, files with another version,
+*   size or alphabet are ignored. Writes go to a temporary file that is renamed over the
+*   save so a crash never leaves a partial file behind
+*
+********************************************************************************************/
+
+#pragma once
+
+#include "game.h"
+
+#include <stdint.h>
+
+static const char SAVE_MAGIC[4] = { 'W', 'G', 'S', 'V' };
+static const uint32_t SAVE_VERSION = 3;
+
+struct SaveHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t game_size;
+    uint32_t alphabet_key;  // Letters are stored as indices into this alphabet
+    uint32_t crc;           // Of the game data
+};
+
+// Identifies the alphabet the letter indices of a save refer to
+unsigned int save_game_alphabet_key(const Alphabet* alphabet);
+
+bool save_game_exists();
+bool save_game_read(Game* game, unsigned int alphabet_key);
+
+// Copies the game and writes it on a background thread, the main thread does not wait
+// for the file system. On the web the write happens right away
+void save_game_write_async(const Game* game, unsigned int alphabet_key);
+
+// Writes before returning, replaces writes that are still queued
+void save_game_write(const Game* game, unsigned int alphabet_key);
+
+void save_game_delete();
+
+// Finishes queued writes and stops the background thread
+void save_game_shutdown();
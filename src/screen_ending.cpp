@@ -11,14 +11,22 @@
 #include "screens.h"
 #include "modes.h"
 #include "raylib-extras.h"
+#include "high_scores.h"
+#include "text_label.h"
 
 #include <math.h>
+#include <stdio.h>
 
 //----------------------------------------------------------------------------------
 // Module Variables Definition (local)
 //----------------------------------------------------------------------------------
 static int _frames_counter = 0;
 static int _finish_screen = 0;
+static HighScoreRecord _best;           // Before this game
+static bool _has_best = false;
+static float _percentile = 0;
+static int _score = 0;
+static TextLabel _lines[3];
 
 //----------------------------------------------------------------------------------
 // Ending Screen Functions Definition
@@ -30,6 +38,56 @@ void init_ending_screen(void)
     // TODO: Initialize ENDING screen variables here!
     _frames_counter = 0;
     _finish_screen = 0;
+
+    _has_best = high_scores_best(g_game.mode, g_game.rows, g_game.columns, &_best);
+    HighScoreRecord record = high_scores_add(&g_game);
+    _score = record.score;
+    _percentile = high_scores_percentile(g_game.mode, g_game.rows, g_game.columns, record.score);
+
+    // Nothing changes while the screen is up, the texts are laid out once
+    for (TextLabel& label : _lines) text_label_init(&label, &g_default_font, g_default_font_size);
+
+    int minutes = (int)(g_game.elapsed_time / 60);
+    int seconds = (int)(g_game.elapsed_time - minutes * 60.0f);
+    char text[TEXT_LABEL_MAX_GLYPHS + 1];
+
+    switch (g_game.mode) {
+    case (MODE_TIMEATTACK):
+    {
+        snprintf(text, sizeof(text), "You managed to survive for %d minutes and %d seconds.", minutes, seconds);
+        text_label_set(&_lines[0], 0, text);
+        snprintf(text, sizeof(text), "You completed %d words !", g_game.word_count);
+        text_label_set(&_lines[1], 0, text);
+        break;
+    }
+    case (MODE_MOVEATTACK):
+    {
+        snprintf(text, sizeof(text), "You completed %d words !", g_game.word_count);
+        text_label_set(&_lines[1], 0, text);
+        break;
+    }
+    case (MODE_VERSUS):
+    {
+        const int* scores = g_game.versus.scores;
+        if (scores[0] > scores[1]) text_label_set(&_lines[0], 0, "You beat the computer !");
+        else if (scores[0] < scores[1]) text_label_set(&_lines[0], 0, "The computer won this time.");
+        else text_label_set(&_lines[0], 0, "It is a draw.");
+        snprintf(text, sizeof(text), "You completed %d words, the computer (%s) %d.",
+            scores[0], AI_LEVELS[g_game.versus.difficulty].name, scores[1]);
+        text_label_set(&_lines[1], 0, text);
+        break;
+    }
+    default:
+        break;
+    }
+
+    if (!_has_best || _score > _best.score) {
+        text_label_set(&_lines[2], 0, "That is a new best !");
+    }
+    else {
+        snprintf(text, sizeof(text), "Your best is %d words, this game beat %.0f%% of your games.", _best.score, _percentile);
+        text_label_set(&_lines[2], 0, text);
+    }
 }
 
 // Ending Screen Update logic
@@ -49,39 +107,15 @@ void draw_ending_screen(void)
 {
     float y = 20;
     float x = 20;
-    DrawTextCenteredHorizontally(g_font_large, "GAME OVER", y, 1.0, DARKGREEN);
-    y += g_font_large.baseSize + 12;
-
-    int minutes = (int)(g_game.elapsed_time / 60);
-    int seconds = (int)(g_game.elapsed_time - minutes * 60.0f);
-
-    switch (g_game.mode) {
-    case (MODE_TIMEATTACK):
-    {
-        const char* text;
-        text = TextFormat("You managed to survive for %d minutes and %d seconds.",
-            minutes, seconds);
-        DrawTextDefault(text, x, y, BLACK);
-        y += g_font_small.baseSize + 8;
-        
-        text = TextFormat("You completed %d words !", g_game.word_count);
-        DrawTextDefault(text, x, y, BLACK);
-        break;
-    }
-    case (MODE_MOVEATTACK):
-    {
-        const char* text;
-        text = TextFormat("You played for %d minutes and %d seconds.",
-            minutes, seconds);
-        y += g_font_small.baseSize + 8;
+    DrawTextCenteredHorizontally(&g_font, "GAME OVER", y, FONT_SIZE_LARGE, DARKGREEN);
+    y += FONT_SIZE_LARGE + 12;
 
-        text = TextFormat("You completed %d words !", g_game.word_count);
-        DrawTextDefault(text, x, y, BLACK);
-        break;
-    }
+    for (const TextLabel& label : _lines) {
+        text_label_draw(&label, Vector2{ x, y }, BLACK);
+        y += FONT_SIZE_SMALL + 8;
     }
-    DrawTextCenteredHorizontally(g_font_small,
-        "Press any key to return to the title screen", GetScreenHeight() / 4.0f * 3.0f, 1.0, BLACK);
+    DrawTextCenteredHorizontally(&g_font,
+        "Press any key to return to the title screen", screen_layout_size().y / 4.0f * 3.0f, FONT_SIZE_SMALL, BLACK);
 }
 
 // Ending Screen Unload logic
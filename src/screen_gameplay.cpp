@@ -12,10 +12,24 @@
 #include "raygui.h"
 #include "screens.h"
 
+#include "ai_player.h"
+#include "animation.h"
 #include "dictionary.h"
+#include "game.h"
+#include "game_history.h"
+#include "heatmap.h"
+#include "input_queue.h"
 #include "modes.h"
-
+#include "texture_variant.h"
+#include "tile_atlas.h"
+#include "resource_pack.h"
+#include "save_game.h"
+#include "sound.h"
+#include "text_label.h"
+
+#include <math.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
 //----------------------------------------------------------------------------------
@@ -24,172 +38,194 @@
 static int _frames_counter = 0;
 static int _finish_screen = 0;
 
-enum class Action {
-    None,
-    Pickup,
-    Drop,
-};
-
-enum CheckResult {
-    CHECK_RESULT_NONE = 0x0,
-    CHECK_RESULT_HORIZONTAL = 0x1,
-    CHECK_RESULT_VERTICAL = 0x1 << 1,
-    CHECK_RESULT_BOTH = CHECK_RESULT_HORIZONTAL | CHECK_RESULT_VERTICAL,
-};
-
-enum Specials {
-    SPECIAL_CLEAR_COLUMN,
-    SPECIAL_CLEAR_ROW,
-    SPECIAL_CLEAR_TILE,
-    SPECIAL_COUNT
-};
-
 using GameModeCall = void(*)();
+using GameModeInitCall = void(*)(Game*);
 using GameModeUpdateCall = bool(*)(Game*);
 using GameModeDrawCall = void(*)(Game*);
 
-GameModeCall mode_init_calls[MODE_COUNT] = { mode_timeattack_init, mode_moveattack_init };
-GameModeUpdateCall mode_update_calls[MODE_COUNT] = { mode_timeattack_update, mode_moveattack_update };
-GameModeDrawCall mode_draw_calls[MODE_COUNT] = { mode_timeattack_draw, mode_moveattack_draw };
-GameModeCall mode_unload_calls[MODE_COUNT] = { mode_timeattack_unload, mode_moveattack_unload };
+GameModeInitCall mode_init_calls[MODE_COUNT] = { mode_timeattack_init, mode_moveattack_init, mode_versus_init };
+GameModeUpdateCall mode_update_calls[MODE_COUNT] = { mode_timeattack_update, mode_moveattack_update, mode_versus_update };
+GameModeDrawCall mode_draw_calls[MODE_COUNT] = { mode_timeattack_draw, mode_moveattack_draw, mode_versus_draw };
+GameModeCall mode_unload_calls[MODE_COUNT] = { mode_timeattack_unload, mode_moveattack_unload, mode_versus_unload };
  
-Action _current_action = Action::None;
 
 struct Letters {
-    static const int count = 27;
-    Texture2D texture;
-    Rectangle rectangles[count] = { 0 };
-    Rectangle specials[SPECIAL_COUNT] = { 0 };
+    TileAtlas atlas;
     float scale;
 };
 
 static Letters _letters;
 
+// In design units, placed again only when the screen layout changes. Drawing and the
+// hit tests of the board and the buttons use the same rectangles
 struct Layout {
     Vector2 board_pos;
     Rectangle board_rect;
     Vector2 well_pos;
     Rectangle well_rect;
     float tile_size;
+    Rectangle undo;
+    Rectangle redo;
+    Rectangle refresh;
+    Rectangle help;
+    Rectangle quit;
+    Rectangle help_box;
+    Rectangle help_close;
+    Rectangle hud;          // Texts of the mode, above the buttons
+    uint32_t version = 0;
 };
 
 static Layout _layout;
 
+// On screen size of one board space, the source image is 276px drawn at a quarter
+static const float SPACE_SIZE = 69.0f;
+
+// What is drawn for g_game, the state itself lives in Game
 struct Board {
-    Texture2D texture_space;
-    float space_scale;
-    int rows;
-    int columns;
-    Vector2 board_position = {0};
-    // Fixed space increase if we really need more
-    int letters[32] = { 0 };
-    Vector2 well_position = { 0 };
-    static const int max_well_letters = 5;
-    int well[max_well_letters] = { 0 };
+    TextureVariant space;
+    bool well_hidden[GAME_WELL_SIZE] = { false }; // A tile is still animating into the slot
 };
 
-typedef struct Animation {
-    int letter;
-    Vector2 start;
-    Vector2 end;
-    Vector2 current;
-    float current_time;
-    float total_time;
-} Animation;
+// Moves that can be undone
+static const int UNDO_DEPTH = 64;
+static GameHistory _history;
+
+static AnimationPool _animations;
 
-Animation _animation;
+// Durations of the board effects in seconds
+static const float RETURN_TIME = 0.5f;
+static const float SPAWN_TIME = 0.25f;
+static const float SPAWN_STAGGER = 0.05f;
+static const float CLEAR_TIME = 0.3f;
+static const float CLEAR_STAGGER = 0.04f;
+static const float BONUS_TIME = 0.6f;
 
 static Board _board;
 
+// The state before the current move, recorded into the history at the end of the update
+// so that mode bonuses are part of the move
+static bool _move_pending = false;
+static Game _move_start;
+
 struct DragInfo {
     bool is_dragging = false;
     int original_index = -1;
-    char letter = -1;
+    int letter = -1;
     Vector2 position{ 0 };
 };
 
 static DragInfo _drag_info;
 
-static Dictionary _dictionary;
+static DictionarySnapshot* _dictionary = nullptr;
+static uint64_t _skipped_version = 0;    // Published snapshot that does not fit this game
+
+// Well tiles that complete a row or column together with other well tiles, recomputed
+// only when the board, the well or the dictionary changed
+struct Hints {
+    bool enabled = false;
+    uint32_t useful = 0;        // Bit per well slot
+    int words = 0;              // Words that can be completed
+    const AnagramIndex* index = nullptr;
+    int letters[GAME_MAX_CELLS] = { 0 };
+    int well[GAME_WELL_SIZE] = { 0 };
+};
+
+static Hints _hints;
+
+// Shading of the free cells by the words that can still go through them
+enum HeatmapMode {
+    HEATMAP_OFF,
+    HEATMAP_ANY_LETTER,
+    HEATMAP_WELL_LETTERS,
+    HEATMAP_MODE_COUNT
+};
+
+static HeatmapMode _heatmap_mode = HEATMAP_OFF;
+static Heatmap _heatmap;
+
+// The computer's move waits this long so the turn can be seen changing
+static const float AI_MIN_TURN = 0.6f;
+static float _ai_turn_time = 0.0f;
+static bool _ai_move_ready = false;
+static AiResult _ai_move;
+
+// raygui measures the button text itself, only the string is kept between frames
+static TextLabel _refresh_label;
+
+// Seconds between saves of the running game
+static const float SAVE_INTERVAL = 5.0f;
+static float _save_timer = 0.0f;
+static unsigned int _alphabet_key = 0;
+
+static void hints_update(Hints* hints, const Game* game, const AnagramIndex* index)
+{
+    if (!hints->enabled) return;
+    if (hints->index == index && memcmp(hints->letters, game->letters, sizeof(hints->letters)) == 0 &&
+        memcmp(hints->well, game->well, sizeof(hints->well)) == 0) return;
+
+    hints->index = index;
+    memcpy(hints->letters, game->letters, sizeof(hints->letters));
+    memcpy(hints->well, game->well, sizeof(hints->well));
+    hints->useful = 0;
+    hints->words = 0;
+
+    // Free cells are 0 for the index
+    int line[GAME_MAX_SIZE];
+    uint32_t used = 0;
+    for (int y = 0; y < game->rows; ++y) {
+        for (int x = 0; x < game->columns; ++x) line[x] = (game_get_letter(game, x, y) > 0) ? game_get_letter(game, x, y) : 0;
+        hints->words += anagram_fill_line(index, line, game->columns, game->well, GAME_WELL_SIZE, &used);
+        hints->useful |= used;
+    }
+    for (int x = 0; x < game->columns; ++x) {
+        for (int y = 0; y < game->rows; ++y) line[y] = (game_get_letter(game, x, y) > 0) ? game_get_letter(game, x, y) : 0;
+        hints->words += anagram_fill_line(index, line, game->rows, game->well, GAME_WELL_SIZE, &used);
+        hints->useful |= used;
+    }
+}
 
 static char _help_text[] = "Form words by dragging tiles from the line of tiles into the grid, when a row or a column is "
 "filled the word is removed and you get a score. Words can be made from left to right or from "
 "top to bottom.\n\nThere are three special tiles, you can activate them by dragging them onto the board "
-"'x' will remove one tile, '|' will remove a whole column and '-' will remove a row.\n\n There are two "
-"game modes, Time Attack and Move Attack, in Time Attack your play time is limited but can be extended "
-"by making words, in Move Attack your number of moves is limited but you can get more by making words.\n\n"
+"'x' will remove one tile, '|' will remove a whole column and '-' will remove a row.\n\n There are three "
+"game modes, Time Attack, Move Attack and Versus, in Time Attack your play time is limited but can be extended "
+"by making words, in Move Attack your number of moves is limited but you can get more by making words. In "
+"Versus you and the computer take turns on the same board, whoever completes more words wins.\n\n"
 "By pushing `Refresh` you can swap out the list of letters that is available to you but you can only do "
 "that as many times as indicated in the button\n\n"
+"Press H to highlight the tiles in the line that can complete a row or a column. Press M to shade "
+"the free cells by how many words can still be made through them, press it again to only count "
+"words with the letters in the line.\n\n"
 "Have Fun and Good Luck!";
 
 static bool _show_help = false;
 
-float ease_out_cubic(float t) {
-    float val = 1.0f - t;
-    return 1.f - val * val * val;
-}
-
-static void letters_init(Letters *letters, const char* filename) {
-    int letter_width = 256;
-    int letter_height = 256;
-    int row_count = 7;
-    int row_gap = 2;
-    int col_count = 4;
-    int col_gap = 2;
-    const char letter_order[27] = { 
-        'Y', 'R', 'K', 'D',
-        'X', 'Q', 'J', 'C',
-        'W', 'P', 'I', 'B',
-        'V', 'O', 'H', 'A',
-        'U', 'N', 'G', ' ',
-        'T', 'M', 'F', 'L',
-        'S', 'Z', 'E'
-    };
-    letters->texture = LoadTexture(filename);
-    for (int row = 0; row < row_count; ++row) {
-        for (int col = 0; col < col_count; ++col) {
-            Rectangle rect = {
-                .x = (float)(col * (letter_width + col_gap)),
-                .y = (float)(row * (letter_height + row_gap)),
-                .width = (float)letter_width,
-                .height = (float)letter_height,
-            };
-            int index = letter_order[row * col_count + col] - 'A';
-            // Space will be less than 1, skip the last rect
-            // if (letter_order[row * col_count + col] == ' ') index = 0;
-
-            if (index < letters->count) letters->rectangles[index] = rect;
-        }
-    }
-
-    // Init special tiles
-    for (int i = 0; i < SPECIAL_COUNT; ++i) {
-        Rectangle rect = {
-            .x = (float)(4 * (letter_width + col_gap)),
-            .y = (float)(i * (letter_height + row_gap)),
-            .width = (float)letter_width,
-            .height = (float)letter_height,
-        };
-        letters->specials[i] = rect;
+static void letters_init(Letters *letters, const Alphabet* alphabet, const char* font_file,
+    const char* spritesheet_file, float scale) {
+    letters->scale = scale;
+    // Tiles are rasterized at the pixel size they are drawn with, the interior of the authored
+    // 256px tile is 216px. A window that is scaled later gets sharp tiles with the next game
+    int tile_size = (int)(216 * scale * screen_layout_current()->pixel_scale);
+    if (!tile_atlas_load(&letters->atlas, alphabet, font_file, spritesheet_file, tile_size)) {
+        TraceLog(LOG_ERROR, "Failed to create letter tiles from %s", font_file);
     }
 }
 
 static void letters_unload(Letters* letters) {
-    UnloadTexture(letters->texture);
-    letters->texture = { 0 };
+    tile_atlas_unload(&letters->atlas);
 }
 
-static void letters_draw(Letters* letters, int c, Vector2 pos, float scale)
+static Rectangle letters_source(Letters* letters, int c)
 {
-    Rectangle source;
-
-    if (c < SPECIAL_COUNT) {
-        source = letters->specials[c];
+    if (is_special(c)) {
+        return letters->atlas.specials[c - SPECIAL_FIRST];
     }
-    else {
-        //TraceLog(LOG_INFO, "%i", c - 'A');
-        source = letters->rectangles[c - 'A'];
-    };
+    return letters->atlas.letters[c];
+}
+
+static void letters_draw(Letters* letters, int c, Vector2 pos, float scale)
+{
+    Rectangle source = letters_source(letters, c);
 
     Rectangle target = {
         .x = pos.x,
@@ -197,247 +233,364 @@ static void letters_draw(Letters* letters, int c, Vector2 pos, float scale)
         .width = (float)216 * scale, // Measure interior space of tile that is being used
         .height = (float)216 * scale,
     };
-    DrawTexturePro(letters->texture, source, target, Vector2 { 0, 0 }, 0, WHITE);
+    DrawTexturePro(letters->atlas.texture, source, target, Vector2 { 0, 0 }, 0, WHITE);
 }
 
-static int dictionary_get_letter_or_special(Dictionary* dict) {
-    if (GetRandomValue(0, 24) < 1) {
-        return GetRandomValue(0, 2);
-    }
-    else {
-        return dictionary_get_random_letter(dict);
-    }
-}
-
-static void board_init(Board* board, const char* filename, int rows, int cols) {
-    board->rows = rows;
-    board->columns = cols;
-    board->texture_space = LoadTexture(filename);
-    if (board->texture_space.id == 0) {
-        TraceLog(LOG_ERROR, "Failed to load board space from %s/%s", GetWorkingDirectory(), filename);
-        return;
-    }
-    board->space_scale = .25f;
-    for (int i = 0; i < rows * cols; ++i) {
-        board->letters[i] = -1;
-    }
-
-    for (int i = 0; i < board->max_well_letters; ++i) {
-        board->well[i] = dictionary_get_random_letter(&_dictionary);
+static void board_init(Board* board, const char* texture_name) {
+    *board = Board{};
+    board->space = texture_variant_load(texture_name, SPACE_SIZE);
+    if (board->space.texture.id == 0) {
+        TraceLog(LOG_ERROR, "Failed to load board space %s from %s", texture_name, GetWorkingDirectory());
     }
 }
 
 static Vector2 board_get_well_position(Board* board, int index) {
     // Copied from board_draw
-    const float space_size = (float)board->texture_space.width * board->space_scale;
+    const float space_size = SPACE_SIZE;
     const int letter_margin = 8; // From image full scale is 32, we're using quarter size => 8
-    const float board_scale = .25;
     return Vector2{ .x = _layout.well_pos.x + letter_margin, .y = _layout.well_pos.y + index * space_size + letter_margin };
 }
 
-static int board_get_letter(Board* board, int x, int y) {
-    if (x < 0 || x >= board->columns || y < 0 || y >= board->rows) {
-        TraceLog(LOG_FATAL, "Invalid access to board (%i,%i)", x, y);
-        return -1;
-    }
-    return board->letters[x * board->rows + y];
+static Vector2 board_get_cell_position(Board* board, int x, int y) {
+    const float space_size = SPACE_SIZE;
+    const int letter_margin = 8;
+    return Vector2{ .x = _layout.board_pos.x + x * space_size + letter_margin,
+        .y = _layout.board_pos.y + y * space_size + letter_margin };
 }
 
-static void board_set_letter(Board* board, int x, int y, int c) {
-    if (x < 0 || x >= board->columns || y < 0 || y >= board->rows) {
-        TraceLog(LOG_FATAL, "Invalid access to board (%i,%i)", x, y);
-        return;
-    }
-    board->letters[x * board->rows + y] = c;
+// The well slot is not drawn while a tile animates into it
+static void on_well_tile_arrived(int tile, int index) {
+    _board.well_hidden[index] = false;
 }
 
-static CheckResult board_check_words(Board* board, Dictionary* dict, int x, int y) {
-    // Check horizontal
-    // Check vertical 
-    int word[6] = { 0 };
-    for (int i = 0; i < board->columns; ++i) {
-        word[i] = board_get_letter(board, i, y);
-    }
-    CheckResult result = dictionary_exists(dict, word, 6) ? CHECK_RESULT_HORIZONTAL : CHECK_RESULT_NONE;
-
-    for (int i = 0; i < board->rows; ++i) {
-        word[i] = board_get_letter(board, x, i);
-    }
-
-    result = (CheckResult)(result | (dictionary_exists(dict, word, 6) ? CHECK_RESULT_VERTICAL : CHECK_RESULT_NONE));
-    return result;
+static void effect_well_spawn(Board* board, int index, int letter, float delay) {
+    board->well_hidden[index] = true;
+    AnimationDesc desc;
+    desc.tile = letter;
+    desc.key = index;
+    desc.source = letters_source(&_letters, letter);
+    desc.start = board_get_well_position(board, index);
+    desc.end = desc.start;
+    desc.start_scale = 0.0f;
+    desc.delay = delay;
+    desc.duration = SPAWN_TIME;
+    desc.easing = EASE_OUT_BACK;
+    desc.on_done = on_well_tile_arrived;
+    animation_pool_add(&_animations, desc);
 }
 
+static void effect_well_return(Board* board, int index, int letter, Vector2 from) {
+    board->well_hidden[index] = true;
+    AnimationDesc desc;
+    desc.tile = letter;
+    desc.key = index;
+    desc.source = letters_source(&_letters, letter);
+    desc.start = from;
+    desc.end = board_get_well_position(board, index);
+    desc.duration = RETURN_TIME;
+    desc.easing = EASE_OUT_CUBIC;
+    desc.on_done = on_well_tile_arrived;
+    animation_pool_add(&_animations, desc);
+}
 
+static void effect_clear(Board* board, int x, int y, int letter, float delay) {
+    AnimationDesc desc;
+    desc.tile = letter;
+    desc.source = letters_source(&_letters, letter);
+    desc.start = board_get_cell_position(board, x, y);
+    desc.end = desc.start;
+    desc.end_scale = 1.4f;
+    desc.end_alpha = 0.0f;
+    desc.delay = delay;
+    desc.duration = CLEAR_TIME;
+    desc.easing = EASE_OUT_CUBIC;
+    animation_pool_add(&_animations, desc);
+}
 
-static void board_clear_words(Board* board, int x, int y, CheckResult where) {
-    if ((where & CHECK_RESULT_HORIZONTAL) != 0) {
-        for (int i = 0; i < board->columns; ++i) {
-            board_set_letter(board, i, y, -1);
-        }
-    }
-    if ((where & CHECK_RESULT_VERTICAL) != 0) {
-        for (int i = 0; i < board->rows; ++i) {
-            board_set_letter(board, x, i, -1);
-        }
-    }
+// Two words with one tile
+static void effect_bonus(Board* board, int x, int y, int letter) {
+    AnimationDesc desc;
+    desc.tile = letter;
+    desc.source = letters_source(&_letters, letter);
+    desc.start = board_get_cell_position(board, x, y);
+    desc.end = desc.start;
+    desc.end_scale = 2.5f;
+    desc.end_alpha = 0.0f;
+    desc.duration = BONUS_TIME;
+    desc.easing = EASE_OUT_CUBIC;
+    animation_pool_add(&_animations, desc);
 }
 
-void board_drop_tile(Board* board, int x, int y, int letter) {
-    switch (letter) {
-    case SPECIAL_CLEAR_TILE:
-        board_set_letter(board, x, y, -1);
-        break;
-    case SPECIAL_CLEAR_ROW:
-        board_clear_words(board, x, y, CHECK_RESULT_HORIZONTAL);
-        break;
-    case SPECIAL_CLEAR_COLUMN:
-        board_clear_words(board, x, y, CHECK_RESULT_VERTICAL);
-        break;
-    default:
-        board_set_letter(board, x, y, letter);
+// Tiles that were removed by a move fade out, the further away from (x, y) the later
+static void effect_cleared_tiles(Board* board, const Game* before, const Game* after, int x, int y, int dropped) {
+    for (int i = 0; i < after->columns; ++i) {
+        for (int j = 0; j < after->rows; ++j) {
+            if (game_get_letter(after, i, j) != GAME_EMPTY) continue;
+            int letter = (i == x && j == y && !is_special(dropped)) ? dropped : game_get_letter(before, i, j);
+            if (letter == GAME_EMPTY) continue;
+            effect_clear(board, i, j, letter, CLEAR_STAGGER * (abs(i - x) + abs(j - y)));
+        }
     }
 }
 
-static void board_reset(Board* board) {
-    for (int i = 0; i < 32; ++i) {
-        board->letters[i] = -1;
+// Visual state follows the game again, e.g. after undo
+static void board_reset_effects(Board* board) {
+    animation_pool_clear(&_animations);
+    for (int i = 0; i < GAME_WELL_SIZE; ++i) {
+        board->well_hidden[i] = false;
     }
 }
 
-static void board_reset_well(Board* board) {
-    for (int i = 0; i < board->max_well_letters; ++i) {
-        board->well[i] = dictionary_get_letter_or_special(&_dictionary);
+static void board_refresh_well(Board* board) {
+    Game before = g_game;
+    if (!game_refresh_well(&g_game, &_dictionary->dictionary)) return;
+    game_history_record(&_history, &before, &g_game);
+    for (int i = 0; i < GAME_WELL_SIZE; ++i) {
+        animation_pool_complete(&_animations, i);
+        effect_well_spawn(board, i, g_game.well[i], i * SPAWN_STAGGER);
     }
 }
 
 static void board_unload(Board* board) {
-    UnloadTexture(board->texture_space);
-    board->texture_space = { 0 };
+    texture_variant_unload(&board->space);
 }
 
-static void board_draw(Board* board, Vector2 board_position, Vector2 well_position)
+static void board_draw(Board* board, const Game* game, Vector2 board_position, Vector2 well_position)
 {
-    const float space_size = (float)board->texture_space.width * board->space_scale;
+    const float space_size = SPACE_SIZE;
     const int letter_margin = 8; // From image full scale is 32, we're using quarter size => 8
-    const float board_scale = .25;
+    const float board_scale = board->space.scale;
 
     // TODO #optimization unit sprite sheet into one and draw from one texture 
 
-    for (int i = 0; i < board->rows; ++i) {
+    for (int i = 0; i < game->columns; ++i) {
         float x = board_position.x + i * space_size;
-        for (int j = 0; j < board->columns; ++j) {
+        for (int j = 0; j < game->rows; ++j) {
             float y = board_position.y + j * space_size;
-            DrawTextureEx(board->texture_space, Vector2{ x, y }, 0, board_scale, WHITE);
+            DrawTextureEx(board->space.texture, Vector2{ x, y }, 0, board_scale, WHITE);
         }
     }
 
-    for (int i = 0; i < board->max_well_letters; ++i) {
-        DrawTextureEx(board->texture_space, Vector2{ well_position.x, well_position.y + i * space_size }, 0, board_scale, WHITE);
+    for (int i = 0; i < GAME_WELL_SIZE; ++i) {
+        DrawTextureEx(board->space.texture, Vector2{ well_position.x, well_position.y + i * space_size }, 0, board_scale, WHITE);
+    }
+
+    if (_heatmap_mode != HEATMAP_OFF && _heatmap.valid && _heatmap.max_cell > 0) {
+        float scale = 1.0f / logf(1.0f + (float)_heatmap.max_cell);
+        for (int i = 0; i < game->columns; ++i) {
+            for (int j = 0; j < game->rows; ++j) {
+                int value = _heatmap.cells[i * game->rows + j];
+                if (value == 0) continue;
+                float strength = logf(1.0f + (float)value) * scale;
+                Rectangle cell = { board_position.x + i * space_size + 4, board_position.y + j * space_size + 4,
+                    space_size - 8, space_size - 8 };
+                DrawRectangleRec(cell, Fade(SKYBLUE, 0.1f + 0.5f * strength));
+            }
+        }
     }
 
-    for (int i = 0; i < board->rows; ++i) {
+    for (int i = 0; i < game->columns; ++i) {
         float x = board_position.x + i * space_size + letter_margin;
-        for (int j = 0; j < board->columns; ++j) {
+        for (int j = 0; j < game->rows; ++j) {
             float y = board_position.y + j * space_size + letter_margin;
-            int letter = board->letters[i * board->columns + j];
+            int letter = game_get_letter(game, i, j);
             if (letter > 0) {
                 letters_draw(&_letters, letter, Vector2{ x,y }, .25f);
             }
         }
     }
 
-    for (int i = 0; i < board->max_well_letters; ++i) {
-        if (board->well[i] >= 0)
+    for (int i = 0; i < GAME_WELL_SIZE; ++i) {
+        bool dragged = _drag_info.is_dragging && _drag_info.original_index == i;
+        if (_hints.enabled && (_hints.useful & (1u << i)) != 0 && !dragged) {
+            Rectangle slot = { well_position.x + 2, well_position.y + i * space_size + 2, space_size - 4, space_size - 4 };
+            DrawRectangleLinesEx(slot, 3, Fade(GOLD, 0.8f));
+        }
+        if (game->well[i] >= 0 && !board->well_hidden[i] && !dragged)
         {
-           letters_draw(&_letters, board->well[i], Vector2{ well_position.x + letter_margin,well_position.y + i * space_size + letter_margin }, .25f);
+           letters_draw(&_letters, game->well[i], Vector2{ well_position.x + letter_margin,well_position.y + i * space_size + letter_margin }, .25f);
         }
     }
 }
 
-static void input_update(DragInfo* dragging) {
-    if (IsMouseButtonReleased(MOUSE_LEFT_BUTTON) && dragging->is_dragging) {
-        _current_action = Action::Drop;
-    }
-    if (IsMouseButtonPressed(MOUSE_LEFT_BUTTON) && !dragging->is_dragging) {
-        _current_action = Action::Pickup;
-    }
+// The board and the well stay at the top left, the buttons at the bottom right
+static void layout_compute(Layout* layout) {
+    layout->version = screen_layout_version();
+    Vector2 size = screen_layout_size();
+
+    float tile_size = SPACE_SIZE; // Assumes square
+    layout->board_rect = Rectangle{
+        .x = 20, .y = 20,
+        .width = tile_size * g_game.columns,
+        .height = tile_size * g_game.rows
+    };
+    layout->board_pos = Vector2{ layout->board_rect.x, layout->board_rect.y };
+
+    layout->well_rect = Rectangle{
+        .x = 400, .y = 20,
+        .width = tile_size,
+        .height = tile_size * GAME_WELL_SIZE
+    };
+    layout->well_pos = Vector2{ layout->well_rect.x, layout->well_rect.y };
+    layout->tile_size = tile_size;
+
+    Rectangle button_rect = { .x = 500, .y = 0, .width = size.x - 500 - 20, .height = FONT_SIZE_SMALL + 8 };
+    float button_spacing = button_rect.height + 8;
+    button_rect.y = size.y - 20 - 4 * button_spacing;
+    layout->undo = button_rect;
+    layout->undo.width = (button_rect.width - 8) / 2;
+    layout->redo = layout->undo;
+    layout->redo.x += layout->undo.width + 8;
+    button_rect.y += button_spacing;
+    layout->refresh = button_rect;
+    button_rect.y += button_spacing;
+    layout->help = button_rect;
+    button_rect.y += button_spacing;
+    layout->quit = button_rect;
+
+    layout->hud = Rectangle{ .x = 500, .y = 20, .width = size.x - 500 - 20, .height = layout->undo.y - 8 - 20 };
+    modes_layout(layout->hud);
+
+    layout->help_box = Rectangle{ .x = 40, .y = 40, .width = size.x - 80, .height = size.y - 120 };
+    layout->help_close = Rectangle{ .x = size.x / 2.0f - 40, .y = layout->help_box.y + layout->help_box.height + 8,
+        .width = 80, .height = 40 };
 }
 
-static void drag_update(DragInfo* drag, Board* board) {
-    Vector2 mouse_pos = GetMousePosition();
+static void layout_update(Layout* layout) {
+    if (layout->version != screen_layout_version()) layout_compute(layout);
+}
 
-    if (_current_action == Action::Pickup) {
-        if (CheckCollisionPointRec(mouse_pos, _layout.well_rect)) {
-            float dist = mouse_pos.y - _layout.well_rect.y;
-            int index = (int)(dist / _layout.tile_size);
-            if (index < 0 || index > board->max_well_letters) {
-                TraceLog(LOG_WARNING, "Mouse pickup error, index wrong [%s], ", index);
-                return;
-            }
-            if (board->well[index] >= 0) 
-            {
-                drag->is_dragging = true;
-                drag->letter = board->well[index];
-                drag->original_index = index;
-                board->well[index] = -1;
-                drag->position = mouse_pos;
-            }
+static bool computer_turn() {
+    return g_game.mode == MODE_VERSUS && g_game.versus.turn == 1;
+}
+
+// Plays a well tile for either side, returns false if the move is not allowed
+static bool board_play(Board* board, int well_index, int x, int y) {
+    Game before = g_game;
+    int letter = g_game.well[well_index];
+    CheckResult result = CHECK_RESULT_NONE;
+    if (!game_play(&g_game, &_dictionary->dictionary, well_index, x, y, &result)) return false;
+
+    _move_pending = true;
+    _move_start = before;
+    effect_well_spawn(board, well_index, g_game.well[well_index], 0.0f);
+    effect_cleared_tiles(board, &before, &g_game, x, y, letter);
+    sound_play(SOUND_DROP);
+    if (result == CHECK_RESULT_BOTH) {
+        effect_bonus(board, x, y, letter);
+        sound_play(SOUND_BONUS);
+    }
+    else if (result != CHECK_RESULT_NONE) {
+        sound_play(SOUND_WORD);
+    }
+    return true;
+}
+
+// The tile stays in the well of the game state until it is dropped, dragging only hides it
+static void drag_pickup(DragInfo* drag, Board* board, Vector2 position) {
+    if (CheckCollisionPointRec(position, _layout.well_rect)) {
+        float dist = position.y - _layout.well_rect.y;
+        int index = (int)(dist / _layout.tile_size);
+        if (index < 0 || index >= GAME_WELL_SIZE) {
+            TraceLog(LOG_WARNING, "Mouse pickup error, index wrong [%i], ", index);
+            return;
         }
-    }
-    else if (_current_action == Action::Drop) {
-        bool drop_success = false;
-        if (CheckCollisionPointRec(mouse_pos, _layout.board_rect)) {
-            Vector2 dist = Vector2Scale(
-                Vector2Subtract(mouse_pos, _layout.board_pos), 1.0f/(float)_layout.tile_size);
-            int x = (int)dist.x;
-            int y = (int)dist.y;
-            char letter = board_get_letter(board, x, y);
-            if (letter == -1 || drag->letter < SPECIAL_COUNT) {
-                board_drop_tile(board, x, y, drag->letter);
-                board->well[drag->original_index] = dictionary_get_letter_or_special(&_dictionary);
-                CheckResult result = board_check_words(board, &_dictionary, x, y);
-                board_clear_words(board, x, y, result);
-                g_game.move_count += 1;
-                if (result == CHECK_RESULT_BOTH) {
-                    g_game.word_count += 2;
-                }
-                else if (result != CHECK_RESULT_NONE) {
-                    g_game.word_count += 1;
-                }
-                drop_success = true;
-            }
+        if (g_game.well[index] >= 0 && !board->well_hidden[index] && !computer_turn()) 
+        {
+            drag->is_dragging = true;
+            drag->letter = g_game.well[index];
+            drag->original_index = index;
+            drag->position = position;
         }
+    }
+}
 
-        if (drop_success == false) {
-            _animation.letter = drag->letter;
-            _animation.current_time = 0;
-            _animation.total_time = .5f;
-            _animation.start = drag->position;
-            _animation.end = board_get_well_position(board, drag->original_index);
-        }
+static void drag_drop(DragInfo* drag, Board* board, Vector2 position) {
+    drag->is_dragging = false;
 
-        drag->is_dragging = false;
+    if (CheckCollisionPointRec(position, _layout.board_rect)) {
+        Vector2 dist = Vector2Scale(
+            Vector2Subtract(position, _layout.board_pos), 1.0f/(float)_layout.tile_size);
+        int x = (int)dist.x;
+        int y = (int)dist.y;
+        if (board_play(board, drag->original_index, x, y)) return;
     }
 
-    if (drag->is_dragging) {
-        drag->position = mouse_pos;
-    }
+    effect_well_return(board, drag->original_index, drag->letter, position);
+}
 
-    _current_action = Action::None;
+// Handles all pointer events since the last frame in the order they happened, a quick
+// press and release between two frames still picks up and drops the tile
+static void input_update(DragInfo* drag, Board* board) {
+    input_queue_sync();
+
+    InputEvent event;
+    while (input_queue_pop(&event)) {
+        switch (event.type) {
+        case INPUT_PRESS:
+            if (!drag->is_dragging) drag_pickup(drag, board, event.position);
+            break;
+        case INPUT_MOVE:
+            if (drag->is_dragging) drag->position = event.position;
+            break;
+        case INPUT_RELEASE:
+            if (drag->is_dragging) drag_drop(drag, board, event.position);
+            break;
+        }
+    }
 }
 
-bool animation_update(Animation* anim) {
-    
-    if (anim->letter < 0) return false;
+// The search runs in the background from the start of the computer's turn, the move is
+// played once it is ready and the turn has lasted AI_MIN_TURN
+static void versus_update(Board* board) {
+    if (!computer_turn() || _move_pending) {
+        _ai_turn_time = 0.0f;
+        return;
+    }
+    _ai_turn_time += GetFrameTime();
+    if (!_ai_move_ready) {
+        if (!ai_player_thinking()) {
+            ai_player_start(&g_game, _dictionary, (AiDifficulty)g_game.versus.difficulty, g_game.versus.moves_left);
+            return;
+        }
+        if (!ai_player_poll(&_ai_move)) return;
+        _ai_move_ready = true;
+    }
+    if (_ai_turn_time < AI_MIN_TURN) return;
+
+    _ai_move_ready = false;
+    if (_ai_move.depth == 0 || !board_play(board, _ai_move.well_index, _ai_move.x, _ai_move.y)) {
+        mode_versus_pass(&g_game);
+    }
+}
 
-    anim->current_time += GetFrameTime();
-    if (anim->current_time > anim->total_time) {
-        return true;
+// Word lists that were reloaded during the game apply from the next move on, unless the
+// letters of the board would mean something else
+static void refresh_dictionary()
+{
+    DictionarySnapshot* current = g_dictionary_store.current.load();
+    if (current == _dictionary || current == nullptr || current->version == _skipped_version) return;
+
+    DictionarySnapshot* next = dictionary_store_acquire(&g_dictionary_store);
+    if (next == nullptr) return;
+    if (save_game_alphabet_key(&next->dictionary.alphabet) != _alphabet_key) {
+        TraceLog(LOG_WARNING, "GAMEPLAY: The alphabet changed, the new word list is used from the next game on");
+        _skipped_version = next->version;
+        dictionary_snapshot_release(next);
+        return;
     }
-    float val = ease_out_cubic(anim->current_time / anim->total_time);
-    anim->current = Vector2Add(anim->start, Vector2Scale(Vector2Subtract(anim->end, anim->start), val));
-    return false;
+    dictionary_snapshot_release(_dictionary);
+    _dictionary = next;
+}
+
+// An active drag is dropped, the tile is still in the well of the restored state. There is
+// no taking back moves against the computer
+static void history_step(bool undo) {
+    if (g_game.mode == MODE_VERSUS) return;
+    _drag_info.is_dragging = false;
+    board_reset_effects(&_board);
+    if (undo) game_history_undo(&_history, &g_game);
+    else game_history_redo(&_history, &g_game);
 }
 
 //----------------------------------------------------------------------------------
@@ -451,51 +604,94 @@ void init_game_screen(void)
     _frames_counter = 0;
     _finish_screen = 0;
 
-    g_game.refresh_count = 5;
-
-    _dictionary = dictionary_load("resources/text/en/words.txt");
-    dictionary_load_distribution(&_dictionary, "resources/text/en/distribution.txt");
-
-    letters_init(&_letters, "resources/solid_spritesheet.png");
-    board_init(&_board, "resources/tile_space.png", 5, 5);
-
-    float tile_size = _board.texture_space.width * 0.25f; // Assumes square
-
-    _layout.board_rect = Rectangle{
-        .x = 20, .y = 20,
-        .width = tile_size * _board.columns,
-        .height = tile_size * _board.rows
-    };
-    _layout.board_pos = Vector2{ _layout.board_rect.x, _layout.board_rect.y };
-
-    _layout.well_rect = Rectangle{
-        .x = 400, .y = 20,
-        .width = tile_size,
-        .height = tile_size * _board.max_well_letters
-    };
-    _layout.well_pos = Vector2{ _layout.well_rect.x, _layout.well_rect.y };
-    _layout.tile_size = tile_size;
-
-    // Init the game mode
-    mode_init_calls[g_game.mode]();
+    // Loaded by the first game and kept for the next ones
+    _dictionary = dictionary_store_acquire(&g_dictionary_store);
+    if (_dictionary == nullptr) {
+        // The packed archive only carries the binary form of the word list
+        const char* dictionary_file = "resources/text/en/words.wgd";
+        if (!resource_exists(dictionary_file)) dictionary_file = "resources/text/en/words.txt";
+        Dictionary dictionary = dictionary_load(dictionary_file);
+        dictionary_load_distribution(&dictionary, "resources/text/en/distribution.txt");
+        dictionary_store_publish(&g_dictionary_store, dictionary_snapshot_create(&dictionary));
+        _dictionary = dictionary_store_acquire(&g_dictionary_store);
+    }
+
+    uint64_t seed = ((uint64_t)GetRandomValue(0, 0x7fffffff) << 32) | (uint64_t)GetRandomValue(0, 0x7fffffff);
+    game_init(&g_game, g_game.mode, 5, 5, seed, &_dictionary->dictionary);
+    arena_reset(&g_game_arena);
+    game_history_init(&_history, UNDO_DEPTH, &g_game_arena);
+    _move_pending = false;
+    ai_player_cancel();
+    _ai_move_ready = false;
+    _ai_turn_time = 0.0f;
+    sound_prepare();        // Opens in the background while the first move is made
+
+    animation_pool_clear(&_animations);
+    input_queue_clear();
+    _drag_info = DragInfo{};
+    _hints.index = nullptr;
+    letters_init(&_letters, &_dictionary->dictionary.alphabet, "resources/fredoka_medium.ttf",
+        "resources/solid_spritesheet.png", .25f);
+    board_init(&_board, "tile_space");
+    layout_compute(&_layout);
+
+    // Init the game mode, the texts are set up for all modes in case a saved game of another one is resumed
+    mode_init_calls[g_game.mode](&g_game);
+    modes_init_labels();
+
+    _alphabet_key = save_game_alphabet_key(&_dictionary->dictionary.alphabet);
+    _save_timer = 0.0f;
+    Game saved;
+    if (g_resume_game && save_game_read(&saved, _alphabet_key)) {
+        g_game = saved;
+        TraceLog(LOG_INFO, "Resumed saved game after %.0f seconds", g_game.elapsed_time);
+    }
+    g_resume_game = false;
 }
 
 // Gameplay Screen Update logic
 void update_game_screen(void)
 {
-    if (_show_help) return;
+    layout_update(&_layout);
+    if (_show_help) {
+        input_queue_clear();
+        return;
+    }
 
     g_game.elapsed_time += GetFrameTime();
+    refresh_dictionary();
 
-    input_update(&_drag_info);
-    drag_update(&_drag_info, &_board);
-    if (animation_update(&_animation) == true) {
-        _board.well[_drag_info.original_index] = _animation.letter;
-        _animation.letter = -1;
-    }
+    bool control = IsKeyDown(KEY_LEFT_CONTROL) || IsKeyDown(KEY_RIGHT_CONTROL);
+    bool shift = IsKeyDown(KEY_LEFT_SHIFT) || IsKeyDown(KEY_RIGHT_SHIFT);
+    if (control && IsKeyPressed(KEY_Z)) history_step(!shift);
+    else if (control && IsKeyPressed(KEY_Y)) history_step(false);
+    if (IsKeyPressed(KEY_H)) _hints.enabled = !_hints.enabled;
+    if (IsKeyPressed(KEY_M)) _heatmap_mode = (HeatmapMode)((_heatmap_mode + 1) % HEATMAP_MODE_COUNT);
+
+    input_update(&_drag_info, &_board);
+    versus_update(&_board);
+    animation_pool_update(&_animations, GetFrameTime());
 
     bool run_again = mode_update_calls[g_game.mode](&g_game);
+    if (_move_pending) {
+        game_history_record(&_history, &_move_start, &g_game);
+        _move_pending = false;
+        _save_timer = SAVE_INTERVAL;
+    }
+
+    hints_update(&_hints, &g_game, &_dictionary->anagrams);
+    if (_heatmap_mode != HEATMAP_OFF) {
+        uint64_t allowed = (_heatmap_mode == HEATMAP_WELL_LETTERS) ? heatmap_well_letters(&g_game) : ~0ull;
+        heatmap_update(&_heatmap, &g_game, &_dictionary->dictionary, allowed);
+    }
+
+    _save_timer += GetFrameTime();
+    if (run_again && _save_timer >= SAVE_INTERVAL) {
+        save_game_write_async(&g_game, _alphabet_key);
+        _save_timer = 0.0f;
+    }
     if (!run_again) {
+        sound_play(SOUND_GAME_OVER);
         _finish_screen = 1;
     }
 }
@@ -503,73 +699,88 @@ void update_game_screen(void)
 // Gameplay Screen Draw logic
 void draw_game_screen(void)
 {
-    DrawRectangle(0, 0, GetScreenWidth(), GetScreenHeight(), WHITE);
+    layout_update(&_layout);    // Screens are drawn without an update during transitions
+    DrawRectangleV(Vector2{ 0, 0 }, screen_layout_size(), WHITE);
 
-    Rectangle button_rect = { .x = 500, .y = 0, .width = (float)GetScreenWidth() - 500 - 20,
-    .height = (float)g_font_small.baseSize + 8 };
-
-    float button_spacing = button_rect.height + 8;
-    // Should just draw from bottom to top ...
-    button_rect.y = GetScreenHeight() - 20 - 3 * button_spacing;
-    board_draw(&_board, _layout.board_pos, _layout.well_pos);
+    board_draw(&_board, &g_game, _layout.board_pos, _layout.well_pos);
+    animation_pool_draw(&_animations, _letters.atlas.texture, 216 * _letters.scale);
     if (_drag_info.is_dragging) {
         letters_draw(&_letters, _drag_info.letter, _drag_info.position, 0.25f);
     }
 
-    if (_animation.letter > 0) {
-        letters_draw(&_letters, _animation.letter, _animation.current, 0.25f);
-    }
-
     //if (GuiButton(Rectangle{ .x = 500, .y = 300, .width = 100, .height = 40 }, "Reset Board")) {
     //    board_reset(&_board);
     //}
 
-    if (_show_help || g_game.refresh_count <= 0) GuiDisable();
-    if (GuiButton(button_rect, TextFormat("Refresh (%d)", g_game.refresh_count))) {
-        --g_game.refresh_count;
-        board_reset_well(&_board);
+    // The buttons only draw shapes and text, the text needs the shader of the font
+    sdf_font_begin(&g_font);
+    bool versus = g_game.mode == MODE_VERSUS;
+    if (_show_help || versus || !game_history_can_undo(&_history)) GuiDisable();
+    if (GuiButton(_layout.undo, "Undo")) {
+        history_step(true);
+    }
+    if (!_show_help) GuiEnable();
+    if (_show_help || versus || !game_history_can_redo(&_history)) GuiDisable();
+    if (GuiButton(_layout.redo, "Redo")) {
+        history_step(false);
     }
     if (!_show_help) GuiEnable();
 
-    button_rect.y += button_spacing;
+    if (_show_help || g_game.refresh_count <= 0 || computer_turn()) GuiDisable();
+    if (text_label_stale(&_refresh_label, g_game.refresh_count)) {
+        text_label_set(&_refresh_label, g_game.refresh_count, arena_format(&g_frame_arena, "Refresh (%d)", g_game.refresh_count));
+    }
+    if (GuiButton(_layout.refresh, _refresh_label.text)) {
+        board_refresh_well(&_board);
+    }
+    if (!_show_help) GuiEnable();
 
-    if (GuiButton(button_rect, "Help")) {
+    if (GuiButton(_layout.help, "Help")) {
         _show_help = true;
     }
-    
-    button_rect.y += button_spacing;
 
-    if (GuiButton(button_rect, "Quit")) {
+    if (GuiButton(_layout.quit, "Quit")) {
         _finish_screen = 2;
     }
 
     
     if (_show_help) GuiEnable();
+    sdf_font_end(&g_font);
 
     mode_draw_calls[g_game.mode](&g_game);
 
     if (_show_help) {
         GuiSetStyle(DEFAULT, TEXT_ALIGNMENT_VERTICAL, TEXT_ALIGN_TOP);   // WARNING: Word-wrap does not work as expected in case of no-top alignment
         GuiSetStyle(DEFAULT, TEXT_WRAP_MODE, TEXT_WRAP_WORD);            // WARNING: If wrap mode enabled, text editing is not supported
-        Rectangle box = Rectangle{ .x = 40, .y = 40, 
-            .width = (float)GetScreenWidth() - 80, .height = (float)GetScreenHeight() - 120 };
-        GuiPanel(box, nullptr);
-        GuiTextBox(box , _help_text, (int)strlen(_help_text), false);
+        sdf_font_begin(&g_font);
+        GuiPanel(_layout.help_box, nullptr);
+        GuiTextBox(_layout.help_box, _help_text, (int)strlen(_help_text), false);
         GuiSetStyle(DEFAULT, TEXT_WRAP_MODE, TEXT_WRAP_NONE);
         GuiSetStyle(DEFAULT, TEXT_ALIGNMENT_VERTICAL, TEXT_ALIGN_MIDDLE);
 
-        Rectangle button = Rectangle{ .x = (float)GetScreenWidth() / 2.0f - 40, .y = box.y + box.height + 8,
-        .width = 80, .height = 40 };
-        _show_help = !GuiButton(button, "Close");
+        _show_help = !GuiButton(_layout.help_close, "Close");
+        sdf_font_end(&g_font);
     }
 }
 
 // Gameplay Screen Unload logic
 void unload_game_screen(void)
 {
+    // Closing the window keeps the game, finishing or quitting it ends it
+    if (_finish_screen == 0) save_game_write(&g_game, _alphabet_key);
+    else save_game_delete();
+    ai_player_cancel();
+
     letters_unload(&_letters);
     board_unload(&_board);
-    dictionary_unload(&_dictionary);
+    game_history_unload(&_history);
+    heatmap_unload(&_heatmap);
+    dictionary_snapshot_release(_dictionary);
+    _dictionary = nullptr;
+
+    const WordCacheStats* stats = &word_cache_local()->stats;
+    TraceLog(LOG_INFO, "GAME: Word cache %lld hits, %lld misses, %.1f%% hit rate",
+        (long long)stats->hits, (long long)stats->misses, 100.0 * word_cache_hit_rate(stats));
 }
 
 // Gameplay Screen should finish?
@@ -0,0 +1,59 @@
+/*******************************************************************************************
+*
+*   WordGrid
+*   Simple Word Puzzle Game
+*   (C) Harald Scheirich 2024
+*   WordGrid is is licensed under an unmodified zlib/libpng license see LICENSE
+*
+********************************************************************************************/
+
+#include "screen_layout.h"
+#include "input_queue.h"
+
+#include <math.h>
+
+static ScreenLayout _layout;
+
+bool screen_layout_update()
+{
+    int width = GetScreenWidth();
+    int height = GetScreenHeight();
+    float dpi_scale = GetWindowScaleDPI().x;
+    if (width == _layout.window_width && height == _layout.window_height && dpi_scale == _layout.dpi_scale) {
+        return false;
+    }
+    // A minimized window reports 0, the old layout stays until it has a size again
+    if (width <= 0 || height <= 0) return false;
+
+    _layout.window_width = width;
+    _layout.window_height = height;
+    _layout.dpi_scale = dpi_scale;
+    _layout.scale = fminf((float)width / LAYOUT_DESIGN_WIDTH, (float)height / LAYOUT_DESIGN_HEIGHT);
+    _layout.pixel_scale = _layout.scale * dpi_scale;
+    _layout.size = Vector2{ (float)width / _layout.scale, (float)height / _layout.scale };
+    _layout.camera = Camera2D{ .offset = { 0, 0 }, .target = { 0, 0 }, .rotation = 0.0f, .zoom = _layout.scale };
+    _layout.version++;
+
+    SetMouseOffset(0, 0);
+    SetMouseScale(1.0f / _layout.scale, 1.0f / _layout.scale);
+    input_queue_set_scale(1.0f / _layout.scale);
+
+    TraceLog(LOG_INFO, "LAYOUT: Window %dx%d at %.2f dpi scale, %.0fx%.0f design units visible",
+        width, height, dpi_scale, _layout.size.x, _layout.size.y);
+    return true;
+}
+
+const ScreenLayout* screen_layout_current()
+{
+    return &_layout;
+}
+
+void screen_layout_begin()
+{
+    BeginMode2D(_layout.camera);
+}
+
+void screen_layout_end()
+{
+    EndMode2D();
+}
@@ -0,0 +1,60 @@
+/*******************************************************************************************
+*
+*   WordGrid
+*   Simple Word Puzzle Game
+*   (C) Harald Scheirich 2024
+*   WordGrid is is licensed under an unmodified zlib/libpng license see LICENSE
+*
+*   Mapping of the designed screen to the window
+*
+*   Screens are designed for LAYOUT_DESIGN_WIDTH x LAYOUT_DESIGN_HEIGHT units. The design is
+*   scaled uniformly until it fits the window and the visible area grows on the longer side,
+*   a wide window shows more room on the right, a tall phone more room at the bottom. Screens
+*   place their elements against screen_layout_size() and keep the rectangles they computed
+*   until screen_layout_version() changes, that only happens when the size or the DPI of the
+*   window changes.
+*
+*   Everything drawn between screen_layout_begin() and screen_layout_end() is in design
+*   units, so are the pointer positions of raylib and of the input queue, hit tests use the
+*   same rectangles that are drawn
+*
+********************************************************************************************/
+
+#pragma once
+
+#include "raylib.h"
+
+#include <stdint.h>
+
+static const float LAYOUT_DESIGN_WIDTH = 852.0f;
+static const float LAYOUT_DESIGN_HEIGHT = 393.0f;
+
+struct ScreenLayout {
+    int window_width = 0;       // The layout was computed for this window
+    int window_height = 0;
+    float dpi_scale = 0.0f;
+    float scale = 1.0f;         // Design units to window units
+    float pixel_scale = 1.0f;   // Design units to pixels of the framebuffer, for sizing textures
+    Vector2 size = { LAYOUT_DESIGN_WIDTH, LAYOUT_DESIGN_HEIGHT };    // Visible design units
+    Camera2D camera = { 0 };
+    uint32_t version = 0;       // Changes with every new layout
+};
+
+// Compares the window with the current layout and computes a new one when it changed, call
+// once at the start of every frame, returns true when the layout changed
+bool screen_layout_update();
+
+const ScreenLayout* screen_layout_current();
+
+inline Vector2 screen_layout_size()
+{
+    return screen_layout_current()->size;
+}
+
+inline uint32_t screen_layout_version()
+{
+    return screen_layout_current()->version;
+}
+
+void screen_layout_begin();
+void screen_layout_end();
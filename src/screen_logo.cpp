@@ -41,8 +41,9 @@ void init_logo_screen(void)
     _frames_counter = 0;
     lettersCount = 0;
 
-    logoPositionX = GetScreenWidth()/2 - 128;
-    logoPositionY = GetScreenHeight()/2 - 128;
+    Vector2 size = screen_layout_size();
+    logoPositionX = (int)size.x/2 - 128;
+    logoPositionY = (int)size.y/2 - 128;
 
     topSideRecWidth = 16;
     leftSideRecHeight = 16;
@@ -136,12 +137,17 @@ void draw_logo_screen(void)
         DrawRectangle(logoPositionX + 240, logoPositionY + 16, 16, rightSideRecHeight - 32, Fade(BLACK, alpha));
         DrawRectangle(logoPositionX, logoPositionY + 240, bottomSideRecWidth, 16, Fade(BLACK, alpha));
 
-        DrawRectangle(GetScreenWidth()/2 - 112, GetScreenHeight()/2 - 112, 224, 224, Fade(RAYWHITE, alpha));
+        DrawRectangle(logoPositionX + 16, logoPositionY + 16, 224, 224, Fade(RAYWHITE, alpha));
 
-        DrawText(TextSubtext("raylib", 0, lettersCount), GetScreenWidth()/2 - 44, GetScreenHeight()/2 + 48, 50, Fade(BLACK, alpha));
+        DrawText(TextSubtext("raylib", 0, lettersCount), logoPositionX + 84, logoPositionY + 176, 50, Fade(BLACK, alpha));
 
         if (_frames_counter > 20) DrawText("powered by", logoPositionX, logoPositionY - 27, 20, Fade(DARKGRAY, alpha));
     }
+
+    if (_finish_screen && !g_assets_ready)
+    {
+        DrawText("loading...", logoPositionX + 128 - MeasureText("loading...", 20)/2, logoPositionY + 128, 20, DARKGRAY);
+    }
 }
 
 // Logo Screen Unload logic
@@ -11,6 +11,8 @@
 #include "raygui.h"
 #include "screens.h"
 #include "raylib-extras.h"
+#include "high_scores.h"
+#include "modes.h"
 
 //----------------------------------------------------------------------------------
 // Module Variables Definition (local)
@@ -18,6 +20,18 @@
 static int _frames_counter = 0;
 static int _finish_screen = 0;
 
+// Placed again only when the screen layout changes
+struct TitleLayout {
+    float body_y;
+    Rectangle mode_buttons[MODE_COUNT];
+    Vector2 best_scores[MODE_COUNT];    // Top center of the texts below each button
+    Rectangle difficulty;               // First toggle of the group
+    uint32_t version = 0;
+};
+
+static TitleLayout _layout;
+static const char* _mode_names[MODE_COUNT] = { "Time Attack", "Move Attack", "Versus" };
+
 //----------------------------------------------------------------------------------
 // Title Screen Functions Definition
 //----------------------------------------------------------------------------------
@@ -44,6 +58,41 @@ enum AnchorType {
 
 static const char* body_text = "Choose your letters wisely and keep going as long as you can !";
 
+// Best result for the mode below its button, the tables are already in memory
+static void draw_best_score(GameMode mode, float x, float y)
+{
+    const HighScoreTable* table = high_scores_table(mode, GAME_MAX_SIZE, GAME_MAX_SIZE);
+    if (table == nullptr) return;
+
+    const char* lines[2] = {
+        arena_format(&g_frame_arena, "Best: %d words", table->top[0].score),
+        arena_format(&g_frame_arena, "%lld games played", (long long)table->game_count),
+    };
+    for (const char* text : lines) {
+        float width = MeasureTextEx(g_default_font.font, text, g_default_font_size, 1.0f).x;
+        DrawTextDefault(text, x - width / 2.0f, y, DARKGRAY);
+        y += g_default_font_size + 4;
+    }
+}
+
+static void layout_update(TitleLayout* layout)
+{
+    if (layout->version == screen_layout_version()) return;
+    layout->version = screen_layout_version();
+
+    Vector2 size = screen_layout_size();
+    layout->body_y = 20 + FONT_SIZE_LARGE + 12;
+    float y = size.y / 2.0f;
+    float x = size.x / 6.0f;
+    for (int mode = 0; mode < MODE_COUNT; ++mode) {
+        float center = x * (float)(2 * mode + 1);
+        layout->mode_buttons[mode] = Rectangle{ .x = center - 100, .y = y, .width = 200, .height = 60 };
+        layout->best_scores[mode] = Vector2{ center, y + 70 };
+    }
+    float width = 200.0f / (float)AI_DIFFICULTY_COUNT - 2;
+    layout->difficulty = Rectangle{ .x = x * 5 - 100, .y = y + 130, .width = width, .height = 30 };
+}
+
 // Title Screen Update logic
 void update_title_screen(void)
 {
@@ -60,24 +109,32 @@ void update_title_screen(void)
 // Title Screen Draw logic
 void draw_title_screen(void)
 {
-    float y = 20;
-    DrawTextCenteredHorizontally(g_font_large, "WORDGRID", y, 1.0, DARKGREEN);
-    y += g_font_large.baseSize + 12;
-    DrawTextCenteredHorizontally(g_font_small, body_text, y, 1.0, BLACK);
+    layout_update(&_layout);
 
-    y = GetScreenHeight() / 2.0f;
-    float x = GetScreenWidth() / 4.0f;
+    DrawTextCenteredHorizontally(&g_font, "WORDGRID", 20, FONT_SIZE_LARGE, DARKGREEN);
+    DrawTextCenteredHorizontally(&g_font, body_text, _layout.body_y, FONT_SIZE_SMALL, BLACK);
 
-    if (GuiButton(Rectangle{ .x = x - 100, .y = y, .width = 200, .height = 60 }, "Time Attack")) 
-    {
-        g_game.mode = MODE_TIMEATTACK;
-        _finish_screen = 2;
-    };
-    if (GuiButton(Rectangle{ .x = x * 3 - 100, .y = y, .width = 200, .height = 60 }, "Move Attack")) 
-    {
-        g_game.mode = MODE_MOVEATTACK;
-        _finish_screen = 2;
-    };
+    // The buttons only draw shapes and text, the text needs the shader of the font
+    sdf_font_begin(&g_font);
+    for (int mode = 0; mode < MODE_COUNT; ++mode) {
+        if (GuiButton(_layout.mode_buttons[mode], _mode_names[mode]))
+        {
+            g_game.mode = (GameMode)mode;
+            _finish_screen = 2;
+        }
+    }
+    sdf_font_end(&g_font);
+
+    for (int mode = 0; mode < MODE_COUNT; ++mode) {
+        draw_best_score((GameMode)mode, _layout.best_scores[mode].x, _layout.best_scores[mode].y);
+    }
+
+    // Strength of the computer for the next versus game
+    int difficulty = mode_versus_difficulty();
+    sdf_font_begin(&g_font);
+    GuiToggleGroup(_layout.difficulty, "Easy;Normal;Hard", &difficulty);
+    sdf_font_end(&g_font);
+    mode_versus_set_difficulty((AiDifficulty)difficulty);
 }
 
 // Title Screen Unload logic
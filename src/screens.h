@@ -10,6 +10,12 @@
 #ifndef SCREENS_H
 #define SCREENS_H
 
+#include "game.h"
+#include "dictionary_snapshot.h"
+#include "arena.h"
+#include "sdf_font.h"
+#include "screen_layout.h"
+
 //----------------------------------------------------------------------------------
 // Types and Structures Definition
 //----------------------------------------------------------------------------------
@@ -34,30 +40,21 @@ typedef enum GameScreen { UNKNOWN = -1, LOGO = 0, TITLE, OPTIONS, GAMEPLAY, ENDI
 #define BLEU = Color{23, 137, 252, 255};
 #define MY_GRAY RAYWHITE
 
+static const float FONT_SIZE_SMALL = 24.0f;
+static const float FONT_SIZE_LARGE = 96.0f;
+
 //----------------------------------------------------------------------------------
 // Global Variables Declaration (shared by several modules)
 //----------------------------------------------------------------------------------
 extern GameScreen g_currentScreen;
-extern Font g_font_small;
-extern Font g_font_large;
-
-enum GameMode {
-    MODE_NONE = -1,
-    MODE_TIMEATTACK,
-    MODE_MOVEATTACK,
-    MODE_COUNT,
-};
-
-struct Game {
-    GameMode mode;
-    int word_count = 0;
-    int trash_count = 0;
-    int move_count = 0;
-    int refresh_count = 0;
-    float elapsed_time = 0;
-};
-
-extern Game g_game;
+extern SdfFont g_font;           // The one atlas all text is drawn from, see sdf_font.h
+extern bool g_assets_ready;     // Set once the resource archive and global assets are loaded
+extern bool g_resume_game;      // The gameplay screen continues the saved game
+
+extern Game g_game;             // State of the current game, see game.h
+extern DictionaryStore g_dictionary_store;  // Word list shared by everything that checks words
+extern Arena g_game_arena;      // Per game buffers, reset when a game starts
+extern Arena g_frame_arena;     // Temporary strings and buffers, reset every frame
 
 #ifdef __cplusplus
 extern "C" {            // Prevents name mangling of functions
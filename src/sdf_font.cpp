@@ -0,0 +1,106 @@
+/*******************************************************************************************
+*
+*   WordGrid
+*   Simple Word Puzzle Game
+*   (C) Harald Scheirich 2024
+*   WordGrid is is licensed under an unmodified zlib/libpng license see LICENSE
+*
+********************************************************************************************/
+
+#include "sdf_font.h"
+
+#include "rlgl.h"
+
+static const int SDF_GLYPH_COUNT = 95;      // Printable ASCII, the default set of raylib
+
+// 0.5 is the outline, blending over one screen pixel keeps the edge smooth at every scale.
+// Shapes sample the opaque white texture of raylib and stay as they are
+#if defined(PLATFORM_WEB)
+static const char* _fragment_shader = R"(#version 100
+#extension GL_OES_standard_derivatives : enable
+precision mediump float;
+varying vec2 fragTexCoord;
+varying vec4 fragColor;
+uniform sampler2D texture0;
+uniform vec4 colDiffuse;
+void main()
+{
+    float distance = texture2D(texture0, fragTexCoord).a;
+    float width = max(fwidth(distance), 0.0001);
+    float alpha = smoothstep(0.5 - width, 0.5 + width, distance);
+    gl_FragColor = vec4(fragColor.rgb, fragColor.a * alpha) * colDiffuse;
+}
+)";
+#else
+static const char* _fragment_shader = R"(#version 330
+in vec2 fragTexCoord;
+in vec4 fragColor;
+uniform sampler2D texture0;
+uniform vec4 colDiffuse;
+out vec4 finalColor;
+void main()
+{
+    float distance = texture(texture0, fragTexCoord).a;
+    float width = max(fwidth(distance), 0.0001);
+    float alpha = smoothstep(0.5 - width, 0.5 + width, distance);
+    finalColor = vec4(fragColor.rgb, fragColor.a * alpha) * colDiffuse;
+}
+)";
+#endif
+
+static bool sdf_font_load_raster(SdfFont* font, const char* path, int atlas_size)
+{
+    font->font = LoadFontEx(path, atlas_size, nullptr, 0);
+    SetTextureFilter(font->font.texture, TEXTURE_FILTER_BILINEAR);
+    return font->font.texture.id != GetFontDefault().texture.id;
+}
+
+bool sdf_font_load(SdfFont* font, const char* path, int atlas_size)
+{
+    *font = SdfFont{};
+    Shader shader = LoadShaderFromMemory(nullptr, _fragment_shader);
+    if (shader.id == rlGetShaderIdDefault()) {
+        TraceLog(LOG_WARNING, "FONT: No distance field shader, %s uses a raster atlas", path);
+        return sdf_font_load_raster(font, path, atlas_size);
+    }
+
+    int data_size = 0;
+    unsigned char* data = LoadFileData(path, &data_size);
+    GlyphInfo* glyphs = (data != nullptr) ?
+        LoadFontData(data, data_size, atlas_size, nullptr, 0, FONT_SDF) : nullptr;
+    UnloadFileData(data);
+    if (glyphs == nullptr) {
+        TraceLog(LOG_ERROR, "FONT: Could not load %s", path);
+        UnloadShader(shader);
+        font->font = GetFontDefault();
+        return false;
+    }
+
+    font->shader = shader;
+    font->font.baseSize = atlas_size;
+    font->font.glyphCount = SDF_GLYPH_COUNT;
+    font->font.glyphPadding = 0;
+    font->font.glyphs = glyphs;
+    Image atlas = GenImageFontAtlas(glyphs, &font->font.recs, SDF_GLYPH_COUNT, atlas_size, 0, 1);
+    font->font.texture = LoadTextureFromImage(atlas);
+    UnloadImage(atlas);
+    SetTextureFilter(font->font.texture, TEXTURE_FILTER_BILINEAR);
+    return true;
+}
+
+void sdf_font_unload(SdfFont* font)
+{
+    UnloadFont(font->font);     // Leaves the default font alone
+    if (font->shader.id != 0) UnloadShader(font->shader);
+    *font = SdfFont{};
+}
+
+void sdf_font_begin(const SdfFont* font)
+{
+    if (font->shader.id != 0) BeginShaderMode(font->shader);
+}
+
+void sdf_font_end(const SdfFont* font)
+{
+    if (font->shader.id != 0) EndShaderMode();
+}
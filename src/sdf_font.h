@@ -0,0 +1,38 @@
+/*******************************************************************************************
+*
+*   WordGrid
+*   Simple Word Puzzle Game
+*   (C) Harald Scheirich 2024
+*   WordGrid is is licensed under an unmodified zlib/libpng license see LICENSE
+*
+*   Signed distance field font
+*
+*   The font is rasterized once into an atlas that stores the distance to the outline of
+*   each glyph instead of its coverage. A small shader turns the distance back into a
+*   sharp edge, so the same atlas draws crisp text at any size. Glyph metrics are those of
+*   `font.baseSize`, draw with DrawTextEx() and the size that is wanted between
+*   sdf_font_begin() and sdf_font_end(). Shapes that are drawn in between are not changed,
+*   textured sprites lose their colors
+*
+*   When the shader does not compile the atlas is a normal raster one and begin and end
+*   do nothing, text is still drawn, only blurrier when it is scaled up
+*
+********************************************************************************************/
+
+#pragma once
+
+#include "raylib.h"
+
+struct SdfFont {
+    Font font = { 0 };
+    Shader shader = { 0 };      // Id 0 for a raster atlas
+};
+
+// Returns false and uses the default font of raylib when `path` can't be read
+bool sdf_font_load(SdfFont* font, const char* path, int atlas_size);
+
+void sdf_font_unload(SdfFont* font);
+
+void sdf_font_begin(const SdfFont* font);
+
+void sdf_font_end(const SdfFont* font);
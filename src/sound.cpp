@@ -0,0 +1,141 @@
+/*******************************************************************************************
+*
+*   WordGrid
+*   Simple Word Puzzle Game
+*   (C) Harald Scheirich 2024
+*   WordGrid is is licensed under an unmodified zlib/libpng license see LICENSE
+*
+********************************************************************************************/
+
+#include "sound.h"
+
+#include "raylib.h"
+
+#include <math.h>
+
+#include <atomic>
+
+#if !defined(PLATFORM_WEB)
+    #include <thread>
+    #define SOUND_USE_THREAD
+#endif
+
+static const int SOUND_VOICES = 4;              // Per effect, the oldest one is restarted
+static const int SOUND_SAMPLE_RATE = 22050;
+static const int SOUND_MAX_NOTES = 4;
+
+enum SoundState {
+    SOUND_CLOSED,
+    SOUND_OPENING,
+    SOUND_READY,
+    SOUND_FAILED,
+};
+
+// Notes are played one after the other, each one a sine that fades out
+struct SoundRecipe {
+    float frequencies[SOUND_MAX_NOTES];         // 0 ends the list
+    float note_length;                          // Seconds
+    float slide;                                // Frequency factor over one note
+    float volume;
+};
+
+static const SoundRecipe _recipes[SOUND_COUNT] = {
+    { { 180.0f }, 0.06f, 0.6f, 0.5f },                              // SOUND_DROP
+    { { 659.3f, 880.0f }, 0.09f, 1.0f, 0.6f },                      // SOUND_WORD
+    { { 523.3f, 659.3f, 784.0f, 1046.5f }, 0.08f, 1.0f, 0.6f },     // SOUND_BONUS
+    { { 440.0f, 349.2f, 261.6f }, 0.2f, 0.97f, 0.7f },              // SOUND_GAME_OVER
+};
+
+static std::atomic<int> _state{ SOUND_CLOSED };
+static Sound _voices[SOUND_COUNT][SOUND_VOICES];    // Voice 0 owns the samples
+static int _next_voice[SOUND_COUNT] = { 0 };
+
+#if defined(SOUND_USE_THREAD)
+static std::thread _loader;
+#endif
+
+static Wave sound_synthesize(const SoundRecipe* recipe)
+{
+    int note_count = 0;
+    while (note_count < SOUND_MAX_NOTES && recipe->frequencies[note_count] > 0.0f) note_count++;
+    int note_frames = (int)(recipe->note_length * SOUND_SAMPLE_RATE);
+
+    Wave wave = { 0 };
+    wave.frameCount = (unsigned int)(note_count * note_frames);
+    wave.sampleRate = SOUND_SAMPLE_RATE;
+    wave.sampleSize = 16;
+    wave.channels = 1;
+    short* samples = (short*)RL_CALLOC(wave.frameCount, sizeof(short));
+    wave.data = samples;
+
+    for (int note = 0; note < note_count; ++note) {
+        double phase = 0.0;
+        for (int i = 0; i < note_frames; ++i) {
+            float t = (float)i / (float)note_frames;
+            float frequency = recipe->frequencies[note] * powf(recipe->slide, t);
+            phase += 2.0 * PI * frequency / SOUND_SAMPLE_RATE;
+            // Short attack against clicks, then a linear fade
+            float envelope = fminf(t * 40.0f, 1.0f) * (1.0f - t);
+            samples[note * note_frames + i] = (short)(sin(phase) * envelope * 32000.0f);
+        }
+    }
+    return wave;
+}
+
+static void sound_open()
+{
+    InitAudioDevice();
+    if (!IsAudioDeviceReady()) {
+        TraceLog(LOG_WARNING, "SOUND: No audio device, playing without sound");
+        _state.store(SOUND_FAILED);
+        return;
+    }
+
+    for (int effect = 0; effect < SOUND_COUNT; ++effect) {
+        Wave wave = sound_synthesize(&_recipes[effect]);
+        _voices[effect][0] = LoadSoundFromWave(wave);
+        UnloadWave(wave);
+        SetSoundVolume(_voices[effect][0], _recipes[effect].volume);
+        for (int voice = 1; voice < SOUND_VOICES; ++voice) {
+            _voices[effect][voice] = LoadSoundAlias(_voices[effect][0]);
+            SetSoundVolume(_voices[effect][voice], _recipes[effect].volume);
+        }
+    }
+    _state.store(SOUND_READY);
+}
+
+void sound_prepare()
+{
+    int expected = SOUND_CLOSED;
+    if (!_state.compare_exchange_strong(expected, SOUND_OPENING)) return;
+#if defined(SOUND_USE_THREAD)
+    _loader = std::thread(sound_open);
+#else
+    sound_open();
+#endif
+}
+
+void sound_play(SoundEffect effect)
+{
+    if (_state.load() != SOUND_READY) {
+        sound_prepare();
+        return;
+    }
+    PlaySound(_voices[effect][_next_voice[effect]]);
+    _next_voice[effect] = (_next_voice[effect] + 1) % SOUND_VOICES;
+}
+
+void sound_shutdown()
+{
+#if defined(SOUND_USE_THREAD)
+    if (_loader.joinable()) _loader.join();
+#endif
+    if (_state.load() == SOUND_READY) {
+        for (int effect = 0; effect < SOUND_COUNT; ++effect) {
+            for (int voice = 1; voice < SOUND_VOICES; ++voice) UnloadSoundAlias(_voices[effect][voice]);
+            UnloadSound(_voices[effect][0]);
+        }
+        CloseAudioDevice();
+    }
+    _state.store(SOUND_CLOSED);
+}
@@ -0,0 +1,35 @@
+/*******************************************************************************************
+*
+*   WordGrid
+*   Simple Word Puzzle Game
+*   (C) Harald Scheirich 2024
+*   WordGrid is is licensed under an unmodified zlib/libpng license see LICENSE
+*
+*   Sound effects
+*
+*   Nothing is opened at startup, the audio device is opened in the background the first
+*   time a game starts or a sound is played, and the effects are synthesized into it. Every
+*   effect has a fixed number of voices that share its samples, playing takes the next one
+*   round robin and restarts it if it is still busy, there is no allocation after loading.
+*   Sounds played before the device is ready are dropped. On the web the device opens on
+*   the main thread, browsers only allow that after the player touched the page anyway
+*
+********************************************************************************************/
+
+#pragma once
+
+enum SoundEffect {
+    SOUND_DROP,
+    SOUND_WORD,
+    SOUND_BONUS,
+    SOUND_GAME_OVER,
+    SOUND_COUNT
+};
+
+// Starts opening the audio device unless it is open or opening already
+void sound_prepare();
+
+void sound_play(SoundEffect effect);
+
+// Waits for the device to finish opening and closes it
+void sound_shutdown();
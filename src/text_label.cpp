@@ -0,0 +1,100 @@
+/*******************************************************************************************
+*
+*   WordGrid
+*   Simple Word Puzzle Game
+*   (C) Harald Scheirich 2024
+*   WordGrid is is licensed under an unmodified zlib/libpng license see LICENSE
+*
+********************************************************************************************/
+
+#include "text_label.h"
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+static const float LINE_SPACING = 2.0f;     // Default of raylib for text with line breaks
+
+void text_label_init(TextLabel* label, const SdfFont* font, float size)
+{
+    label->font = font;
+    label->size = size;
+    label->spacing = 1.0f;
+    label->valid = false;
+    label->key = 0;
+    label->text[0] = 0;
+    label->extent = Vector2{ 0, 0 };
+    label->glyph_count = 0;
+}
+
+bool text_label_stale(const TextLabel* label, uint64_t key)
+{
+    return !label->valid || label->key != key;
+}
+
+// Places the glyphs the same way as DrawTextEx()
+void text_label_set(TextLabel* label, uint64_t key, const char* text)
+{
+    label->valid = true;
+    label->key = key;
+    strncpy(label->text, text, TEXT_LABEL_MAX_GLYPHS);
+    label->text[TEXT_LABEL_MAX_GLYPHS] = 0;
+    label->glyph_count = 0;
+    if (label->font == nullptr || label->font->font.glyphs == nullptr) return;
+
+    const Font& font = label->font->font;
+    float scale = label->size / (float)font.baseSize;
+    float padding = (float)font.glyphPadding;
+    float x = 0.0f;
+    float y = 0.0f;
+    for (const char* c = label->text; *c != 0;) {
+        int bytes = 0;
+        int codepoint = GetCodepointNext(c, &bytes);
+        c += bytes;
+        if (codepoint == '\n') {
+            x = 0.0f;
+            y += ((float)font.baseSize + LINE_SPACING) * scale;
+            continue;
+        }
+
+        int index = GetGlyphIndex(font, codepoint);
+        const Rectangle& rec = font.recs[index];
+        if (codepoint != ' ' && codepoint != '\t' && label->glyph_count < TEXT_LABEL_MAX_GLYPHS) {
+            TextLabelGlyph* glyph = &label->glyphs[label->glyph_count++];
+            glyph->source = Rectangle{ rec.x - padding, rec.y - padding, rec.width + 2.0f * padding, rec.height + 2.0f * padding };
+            glyph->dest = Rectangle{
+                x + ((float)font.glyphs[index].offsetX - padding) * scale,
+                y + ((float)font.glyphs[index].offsetY - padding) * scale,
+                glyph->source.width * scale, glyph->source.height * scale };
+        }
+        float advance = (font.glyphs[index].advanceX == 0) ? rec.width : (float)font.glyphs[index].advanceX;
+        x += advance * scale + label->spacing;
+    }
+    label->extent = MeasureTextEx(font, label->text, label->size, label->spacing);
+}
+
+void text_label_draw(const TextLabel* label, Vector2 position, Color color)
+{
+    if (label->glyph_count == 0) return;
+    sdf_font_begin(label->font);
+    for (int i = 0; i < label->glyph_count; ++i) {
+        Rectangle dest = label->glyphs[i].dest;
+        dest.x += position.x;
+        dest.y += position.y;
+        DrawTexturePro(label->font->font.texture, label->glyphs[i].source, dest, Vector2{ 0, 0 }, 0.0f, color);
+    }
+    sdf_font_end(label->font);
+}
+
+void text_label_drawf(TextLabel* label, uint64_t key, Vector2 position, Color color, const char* format, ...)
+{
+    if (text_label_stale(label, key)) {
+        char text[TEXT_LABEL_MAX_GLYPHS + 1];
+        va_list args;
+        va_start(args, format);
+        vsnprintf(text, sizeof(text), format, args);
+        va_end(args);
+        text_label_set(label, key, text);
+    }
+    text_label_draw(label, position, color);
+}
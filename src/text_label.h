@@ -0,0 +1,59 @@
+/*******************************************************************************************
+*
+*   WordGrid
+*   Simple Word Puzzle Game
+*   (C) Harald Scheirich 2024
+*   WordGrid is is licensed under an unmodified zlib/libpng license see LICENSE
+*
+*   Text that is laid out once and drawn many times
+*
+*   A label remembers a key of the values its text was made from. As long as the key and
+*   the font stay the same drawing skips formatting, decoding and the glyph search of
+*   DrawTextEx() and draws the glyph quads that were placed when the text was set
+*
+********************************************************************************************/
+
+#pragma once
+
+#include "raylib.h"
+#include "sdf_font.h"
+
+#include <stdint.h>
+
+static const int TEXT_LABEL_MAX_GLYPHS = 96;   // Longer texts are cut
+
+struct TextLabelGlyph {
+    Rectangle source;       // In the font texture
+    Rectangle dest;         // Relative to the position of the label
+};
+
+struct TextLabel {
+    const SdfFont* font = nullptr;
+    float size = 0.0f;
+    float spacing = 1.0f;
+    bool valid = false;
+    uint64_t key = 0;
+    char text[TEXT_LABEL_MAX_GLYPHS + 1] = { 0 };
+    Vector2 extent = { 0 };
+    int glyph_count = 0;
+    TextLabelGlyph glyphs[TEXT_LABEL_MAX_GLYPHS];
+};
+
+// Two values that a text is made from
+inline uint64_t text_label_key(int a, int b = 0)
+{
+    return ((uint64_t)(uint32_t)a << 32) | (uint32_t)b;
+}
+
+// Forgets the text, `font` has to outlive the label
+void text_label_init(TextLabel* label, const SdfFont* font, float size);
+
+// True when the text has to be set again for `key`
+bool text_label_stale(const TextLabel* label, uint64_t key);
+
+void text_label_set(TextLabel* label, uint64_t key, const char* text);
+
+void text_label_draw(const TextLabel* label, Vector2 position, Color color);
+
+// Formats the text only when `key` changed, then draws it
+void text_label_drawf(TextLabel* label, uint64_t key, Vector2 position, Color color, const char* format, ...);
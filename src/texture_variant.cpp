@@ -0,0 +1,74 @@
+/*******************************************************************************************
+*
+*   WordGrid
+*   Simple Word Puzzle Game
+*   (C) Harald Scheirich 2024
+*   WordGrid is is licensed under an unmodified zlib/libpng license see LICENSE
+*
+********************************************************************************************/
+
+#include "texture_variant.h"
+#include "resource_pack.h"
+#include "screen_layout.h"
+
+// Needs to match the scales written by tools/asset_baker.cpp
+static const int _variant_scales[] = { 1, 2 };
+
+void texture_enable_mipmaps(Texture2D* texture)
+{
+    if (texture->id == 0) return;
+    if (texture->mipmaps <= 1) GenTextureMipmaps(texture);
+    SetTextureFilter(*texture, TEXTURE_FILTER_TRILINEAR);
+}
+
+static Texture2D texture_variant_try(const char* filename)
+{
+    if (!resource_exists(filename)) return Texture2D{ 0 };
+    // Compressed textures fail to upload when the GPU does not support the format,
+    // the texture id is 0 in that case and the next candidate is tried
+    return LoadTexture(filename);
+}
+
+TextureVariant texture_variant_load(const char* name, float design_size)
+{
+    TextureVariant result;
+
+    float window_scale = screen_layout_current()->pixel_scale;
+    int scale_count = sizeof(_variant_scales) / sizeof(_variant_scales[0]);
+    int start = scale_count - 1;
+    for (int i = 0; i < scale_count; ++i) {
+        if (_variant_scales[i] >= window_scale) {
+            start = i;
+            break;
+        }
+    }
+
+    for (int i = start; i < scale_count && result.texture.id == 0; ++i) {
+#if !defined(PLATFORM_WEB) && !defined(PLATFORM_ANDROID)
+        result.texture = texture_variant_try(TextFormat("resources/baked/%s@%dx.dds", name, _variant_scales[i]));
+#endif
+        if (result.texture.id == 0) {
+            result.texture = texture_variant_try(TextFormat("resources/baked/%s@%dx.png", name, _variant_scales[i]));
+        }
+    }
+
+    if (result.texture.id == 0) {
+        TraceLog(LOG_INFO, "No baked variant for %s, loading source image", name);
+        result.texture = LoadTexture(TextFormat("resources/%s.png", name));
+    }
+
+    if (result.texture.id == 0) {
+        TraceLog(LOG_ERROR, "Failed to load texture %s", name);
+        return result;
+    }
+
+    texture_enable_mipmaps(&result.texture);
+    result.scale = design_size / (float)result.texture.width;
+    return result;
+}
+
+void texture_variant_unload(TextureVariant* variant)
+{
+    UnloadTexture(variant->texture);
+    *variant = TextureVariant{};
+}
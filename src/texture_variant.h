@@ -0,0 +1,27 @@
+/*******************************************************************************************
+*
+*   WordGrid
+*   Simple Word Puzzle Game
+*   (C) Harald Scheirich 2024
+*   WordGrid is is licensed under an unmodified zlib/libpng license see LICENSE
+*
+********************************************************************************************/
+
+#pragma once
+
+#include "raylib.h"
+
+// A texture loaded from the best matching pre-scaled variant, `scale` maps
+// texture pixels to screen units so that width * scale == design size
+struct TextureVariant {
+    Texture2D texture = { 0 };
+    float scale = 1.0f;
+};
+
+// Picks resources/baked/<name>@<n>x.(dds|png) for the pixel scale of the screen layout, falls back
+// to resources/<name>.png when no baked variant exists
+TextureVariant texture_variant_load(const char* name, float design_size);
+void texture_variant_unload(TextureVariant* variant);
+
+// Generates mipmaps and enables trilinear filtering for textures that are drawn scaled down
+void texture_enable_mipmaps(Texture2D* texture);
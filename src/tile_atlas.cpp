@@ -0,0 +1,205 @@
+/*******************************************************************************************
+*
+*   WordGrid
+*   Simple Word Puzzle Game
+*   (C) Harald Scheirich 2024
+*   WordGrid is is licensed under an unmodified zlib/libpng license see LICENSE
+*
+********************************************************************************************/
+
+#include "tile_atlas.h"
+#include "texture_variant.h"
+
+#include <math.h>
+
+// Regions in the authored spritesheet, tiles are 256 pixels with a 2 pixel gap
+static const Rectangle _sheet_blank = { 774, 1032, 256, 256 };
+static const Rectangle _sheet_specials[TILE_ATLAS_SPECIAL_COUNT] = {
+    { 1032, 0, 256, 256 },
+    { 1032, 258, 256, 256 },
+    { 1032, 516, 256, 256 },
+};
+
+static const Color _glyph_color = WHITE;
+static const Color _glyph_shadow_color = Color{ 198, 160, 17, 255 };
+static const float _glyph_scale = 0.5f; // Font size relative to the tile size
+static const int _atlas_padding = 2;
+static const char* _cache_directory = "cache";
+
+void shelf_packer_init(ShelfPacker* packer, int width, int height, int padding)
+{
+    *packer = ShelfPacker{};
+    packer->width = width;
+    packer->height = height;
+    packer->padding = padding;
+    packer->x = padding;
+    packer->y = padding;
+}
+
+bool shelf_packer_add(ShelfPacker* packer, int width, int height, Rectangle* result)
+{
+    if (packer->x + width + packer->padding > packer->width) {
+        packer->y += packer->shelf_height + packer->padding;
+        packer->x = packer->padding;
+        packer->shelf_height = 0;
+    }
+    if (packer->x + width + packer->padding > packer->width ||
+        packer->y + height + packer->padding > packer->height) {
+        return false;
+    }
+
+    *result = Rectangle{ (float)packer->x, (float)packer->y, (float)width, (float)height };
+    packer->x += width + packer->padding;
+    if (height > packer->shelf_height) packer->shelf_height = height;
+    return true;
+}
+
+static int next_power_of_two(int value)
+{
+    int result = 1;
+    while (result < value) result <<= 1;
+    return result;
+}
+
+// The placement only depends on the number of tiles and their size, a cached image
+// can reuse the rectangles without rasterizing anything
+static void tile_atlas_layout(TileAtlas* atlas, const Alphabet* alphabet, int* width, int* height)
+{
+    int tile_count = alphabet->count + TILE_ATLAS_SPECIAL_COUNT;
+    int tiles_per_row = (int)ceilf(sqrtf((float)tile_count));
+    *width = next_power_of_two(tiles_per_row * (atlas->tile_size + _atlas_padding) + _atlas_padding);
+
+    ShelfPacker packer;
+    shelf_packer_init(&packer, *width, 1 << 16, _atlas_padding);
+    for (int i = 1; i <= alphabet->count; ++i) {
+        shelf_packer_add(&packer, atlas->tile_size, atlas->tile_size, &atlas->letters[i]);
+    }
+    for (int i = 0; i < TILE_ATLAS_SPECIAL_COUNT; ++i) {
+        shelf_packer_add(&packer, atlas->tile_size, atlas->tile_size, &atlas->specials[i]);
+    }
+    *height = next_power_of_two(packer.y + packer.shelf_height + _atlas_padding);
+}
+
+static unsigned int tile_atlas_cache_key(unsigned char* font_data, int font_size,
+    unsigned char* sheet_data, int sheet_size, const Alphabet* alphabet, int tile_size)
+{
+    unsigned int key[4] = {
+        ComputeCRC32(font_data, font_size),
+        ComputeCRC32(sheet_data, sheet_size),
+        ComputeCRC32((unsigned char*)alphabet->codepoints, sizeof(alphabet->codepoints)),
+        (unsigned int)tile_size
+    };
+    return ComputeCRC32((unsigned char*)key, sizeof(key));
+}
+
+static Image tile_atlas_rasterize(TileAtlas* atlas, const Alphabet* alphabet, int width, int height,
+    unsigned char* font_data, int font_data_size, unsigned char* sheet_data, int sheet_data_size)
+{
+    Image result = GenImageColor(width, height, BLANK);
+    float tile = (float)atlas->tile_size;
+    Rectangle tile_rect = { 0, 0, tile, tile };
+
+    Image sheet = LoadImageFromMemory(".png", sheet_data, sheet_data_size);
+    Image blank = ImageFromImage(sheet, _sheet_blank);
+    ImageResize(&blank, atlas->tile_size, atlas->tile_size);
+
+    for (int i = 0; i < TILE_ATLAS_SPECIAL_COUNT; ++i) {
+        Image special = ImageFromImage(sheet, _sheet_specials[i]);
+        ImageResize(&special, atlas->tile_size, atlas->tile_size);
+        ImageDraw(&result, special, tile_rect, atlas->specials[i], WHITE);
+        UnloadImage(special);
+    }
+    UnloadImage(sheet);
+
+    int glyph_size = (int)(tile * _glyph_scale);
+    Font font = LoadFontFromMemory(".ttf", font_data, font_data_size, glyph_size,
+        (int*)&alphabet->codepoints[1], alphabet->count);
+    float shadow = fmaxf(1.0f, tile / 128.0f);
+
+    for (int i = 1; i <= alphabet->count; ++i) {
+        Rectangle target = atlas->letters[i];
+        ImageDraw(&result, blank, tile_rect, target, WHITE);
+
+        int utf8_size = 0;
+        const char* text = CodepointToUTF8(alphabet->codepoints[i], &utf8_size);
+        char glyph[8] = { 0 };
+        for (int j = 0; j < utf8_size; ++j) glyph[j] = text[j];
+
+        Vector2 size = MeasureTextEx(font, glyph, (float)glyph_size, 0);
+        Vector2 pos = {
+            roundf(target.x + (tile - size.x) / 2.0f),
+            roundf(target.y + (tile - size.y) / 2.0f)
+        };
+        ImageDrawTextEx(&result, font, glyph, Vector2{ pos.x - shadow, pos.y - shadow },
+            (float)glyph_size, 0, _glyph_shadow_color);
+        ImageDrawTextEx(&result, font, glyph, pos, (float)glyph_size, 0, _glyph_color);
+    }
+
+    UnloadFont(font);
+    UnloadImage(blank);
+    return result;
+}
+
+bool tile_atlas_load(TileAtlas* atlas, const Alphabet* alphabet, const char* font_file,
+    const char* spritesheet_file, int tile_size)
+{
+    *atlas = TileAtlas{};
+    atlas->tile_size = tile_size;
+
+    int font_data_size = 0;
+    unsigned char* font_data = LoadFileData(font_file, &font_data_size);
+    int sheet_data_size = 0;
+    unsigned char* sheet_data = LoadFileData(spritesheet_file, &sheet_data_size);
+    if (font_data == nullptr || sheet_data == nullptr) {
+        TraceLog(LOG_ERROR, "Could not load tile sources %s, %s", font_file, spritesheet_file);
+        UnloadFileData(font_data);
+        UnloadFileData(sheet_data);
+        return false;
+    }
+
+    int width = 0;
+    int height = 0;
+    tile_atlas_layout(atlas, alphabet, &width, &height);
+
+    unsigned int key = tile_atlas_cache_key(font_data, font_data_size, sheet_data, sheet_data_size,
+        alphabet, tile_size);
+    char cache_file[256] = { 0 };
+    TextCopy(cache_file, TextFormat("%s/tiles_%08x.png", _cache_directory, key));
+
+    Image image = { 0 };
+    if (FileExists(cache_file)) {
+        image = LoadImage(cache_file);
+        if (image.width != width || image.height != height) {
+            TraceLog(LOG_WARNING, "Tile cache %s has unexpected size, rebuilding", cache_file);
+            UnloadImage(image);
+            image = Image{ 0 };
+        }
+    }
+
+    if (image.data == nullptr) {
+        double start = GetTime();
+        image = tile_atlas_rasterize(atlas, alphabet, width, height,
+            font_data, font_data_size, sheet_data, sheet_data_size);
+        TraceLog(LOG_INFO, "Rasterized %i letter tiles at %ipx in %.1fms", alphabet->count, tile_size,
+            (GetTime() - start) * 1000.0);
+
+        if (!DirectoryExists(_cache_directory)) MakeDirectory(_cache_directory);
+        if (!ExportImage(image, cache_file)) {
+            TraceLog(LOG_WARNING, "Could not write tile cache %s", cache_file);
+        }
+    }
+
+    UnloadFileData(font_data);
+    UnloadFileData(sheet_data);
+
+    atlas->texture = LoadTextureFromImage(image);
+    texture_enable_mipmaps(&atlas->texture);
+    UnloadImage(image);
+    return atlas->texture.id != 0;
+}
+
+void tile_atlas_unload(TileAtlas* atlas)
+{
+    UnloadTexture(atlas->texture);
+    *atlas = TileAtlas{};
+}
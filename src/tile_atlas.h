@@ -0,0 +1,44 @@
+/*******************************************************************************************
+*
+*   WordGrid
+*   Simple Word Puzzle Game
+*   (C) Harald Scheirich 2024
+*   WordGrid is is licensed under an unmodified zlib/libpng license see LICENSE
+*
+********************************************************************************************/
+
+#pragma once
+
+#include "raylib.h"
+#include "alphabet.h"
+
+static const int TILE_ATLAS_SPECIAL_COUNT = 3;
+
+// Letter tiles rendered from the font at startup, one tile per alphabet letter
+// followed by the special tiles copied from the spritesheet
+struct TileAtlas {
+    Texture2D texture = { 0 };
+    int tile_size = 0;
+    Rectangle letters[ALPHABET_MAX_LETTERS + 1] = { 0 }; // Indexed by alphabet index
+    Rectangle specials[TILE_ATLAS_SPECIAL_COUNT] = { 0 };
+};
+
+// Simple shelf packer, rectangles are placed left to right on the current shelf
+// a new shelf is opened when the current one is full
+struct ShelfPacker {
+    int width = 0;
+    int height = 0;
+    int padding = 0;
+    int x = 0;
+    int y = 0;
+    int shelf_height = 0;
+};
+
+void shelf_packer_init(ShelfPacker* packer, int width, int height, int padding);
+bool shelf_packer_add(ShelfPacker* packer, int width, int height, Rectangle* result);
+
+// Loads the atlas from the cache directory if present, otherwise it is rasterized from `font_file`
+// onto the blank tile from `spritesheet_file` and written to the cache
+bool tile_atlas_load(TileAtlas* atlas, const Alphabet* alphabet, const char* font_file,
+    const char* spritesheet_file, int tile_size);
+void tile_atlas_unload(TileAtlas* atlas);
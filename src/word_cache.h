@@ -0,0 +1,116 @@
+/*******************************************************************************************
+*
+*   WordGrid
+*   Simple Word Puzzle Game
+*   (C) Harald Scheirich 2024
+*   WordGrid is is licensed under an unmodified zlib/libpng license see LICENSE
+*
+*   Cache of dictionary lookups
+*
+*   Play checks the same rows and columns over and over, solvers and simulators even more.
+*   Words of up to five letters are packed into a 30 bit key, six bits per alphabet index,
+*   and the answer is kept in a 4-way set associative table in front of dictionary_exists().
+*   The cache remembers the id of the dictionary it was filled from and empties itself when
+*   it sees another one, so it works with any dictionary and across snapshot changes
+*
+*   A cache belongs to one thread, word_cache_local() is the one of the calling thread
+*
+********************************************************************************************/
+
+#pragma once
+
+#include "dictionary.h"
+
+#include <stdint.h>
+#include <string.h>
+
+static const int WORD_CACHE_LETTER_BITS = 6;           // Covers ALPHABET_MAX_LETTERS
+static const int WORD_CACHE_MAX_LETTERS = 5;
+static const int WORD_CACHE_WAYS = 4;
+static const int WORD_CACHE_SET_BITS = 10;              // 16 KB, raise it if the hit rate is low
+static const int WORD_CACHE_SETS = 1 << WORD_CACHE_SET_BITS;
+
+static const uint32_t WORD_CACHE_VALID = 0x80000000u;
+static const uint32_t WORD_CACHE_FOUND = 0x40000000u;
+static const uint32_t WORD_CACHE_KEY_MASK = 0x3FFFFFFFu;
+
+struct WordCacheStats {
+    int64_t hits = 0;
+    int64_t misses = 0;
+    int64_t skipped = 0;            // Words that can not be packed go straight to the dictionary
+};
+
+struct WordCache {
+    uint32_t entries[WORD_CACHE_SETS][WORD_CACHE_WAYS] = {};   // Most recent first
+    uint32_t dictionary_id = 0;
+    WordCacheStats stats;
+};
+
+inline void word_cache_clear(WordCache* cache)
+{
+    memset(cache->entries, 0, sizeof(cache->entries));
+    cache->dictionary_id = 0;
+}
+
+inline void word_cache_add_stats(WordCacheStats* total, const WordCacheStats* stats)
+{
+    total->hits += stats->hits;
+    total->misses += stats->misses;
+    total->skipped += stats->skipped;
+}
+
+inline double word_cache_hit_rate(const WordCacheStats* stats)
+{
+    int64_t lookups = stats->hits + stats->misses + stats->skipped;
+    return (lookups > 0) ? (double)stats->hits / (double)lookups : 0.0;
+}
+
+// Returns false for words that are too long or hold something else than alphabet indices
+inline bool word_cache_pack(const int* letters, int letter_count, uint32_t* key)
+{
+    uint32_t result = 0;
+    for (int i = 0; i < letter_count && letters[i] != 0; ++i) {
+        if (i == WORD_CACHE_MAX_LETTERS || letters[i] < 0 || letters[i] > ALPHABET_MAX_LETTERS) return false;
+        result |= (uint32_t)letters[i] << (i * WORD_CACHE_LETTER_BITS);
+    }
+    *key = result;
+    return true;
+}
+
+// Same contract as dictionary_exists()
+inline bool word_cache_exists(WordCache* cache, const Dictionary* dictionary, const int* letters, int letter_count)
+{
+    uint32_t key = 0;
+    if (!word_cache_pack(letters, letter_count, &key)) {
+        cache->stats.skipped++;
+        return dictionary_exists(dictionary, letters, letter_count);
+    }
+    if (cache->dictionary_id != dictionary->id) {
+        word_cache_clear(cache);
+        cache->dictionary_id = dictionary->id;
+    }
+
+    uint32_t* set = cache->entries[(key * 0x9E3779B1u) >> (32 - WORD_CACHE_SET_BITS)];
+    int way = 0;
+    while (way < WORD_CACHE_WAYS && (set[way] & (WORD_CACHE_VALID | WORD_CACHE_KEY_MASK)) != (WORD_CACHE_VALID | key)) way++;
+
+    uint32_t entry = 0;
+    if (way < WORD_CACHE_WAYS) {
+        cache->stats.hits++;
+        entry = set[way];
+    }
+    else {
+        cache->stats.misses++;
+        entry = WORD_CACHE_VALID | key | (dictionary_exists(dictionary, letters, letter_count) ? WORD_CACHE_FOUND : 0);
+        way = WORD_CACHE_WAYS - 1;      // The least recent one is evicted
+    }
+    memmove(set + 1, set, way * sizeof(uint32_t));
+    set[0] = entry;
+    return (entry & WORD_CACHE_FOUND) != 0;
+}
+
+inline WordCache* word_cache_local()
+{
+    static thread_local WordCache cache;
+    return &cache;
+}
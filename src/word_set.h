@@ -0,0 +1,199 @@
+/*******************************************************************************************
+*
+*   WordGrid
+*   Simple Word Puzzle Game
+*   (C) Harald Scheirich 2024
+*   WordGrid is is licensed under an unmodified zlib/libpng license see LICENSE
+*
+*   Set of the short words of a dictionary for testing many candidates at once
+*
+*   Solvers and heatmaps test hundreds of rows and columns per move. WordSet holds every
+*   word of up to five letters as a key of word_cache_pack() in buckets of eight slots,
+*   one 32 byte line each. word_set_contains() hashes a block of keys together, prefetches
+*   their buckets and compares each key against a whole bucket with one vector compare.
+*   AVX2, SSE2 and WASM SIMD are picked at compile time, everything else uses the scalar
+*   loop. The table is at most half full so a probe nearly always ends in its first bucket
+*
+********************************************************************************************/
+
+#pragma once
+
+#include "raylib.h"
+#include "dictionary.h"
+#include "word_cache.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#if defined(__AVX2__)
+    #include <immintrin.h>
+    #define WORD_SET_AVX2
+#elif defined(__SSE2__) || defined(_M_X64)
+    #include <emmintrin.h>
+    #define WORD_SET_SSE2
+#elif defined(__wasm_simd128__)
+    #include <wasm_simd128.h>
+    #define WORD_SET_WASM
+#endif
+
+static const int WORD_SET_BUCKET_SLOTS = 8;
+static const int WORD_SET_BLOCK = 8;                // Keys that are hashed and prefetched together
+
+struct WordSet {
+    uint32_t* slots = nullptr;      // 32 byte aligned, 0 for free slots
+    void* memory = nullptr;
+    uint32_t bucket_mask = 0;
+    int word_count = 0;
+    uint32_t dictionary_id = 0;     // Of the dictionary it was built from
+};
+
+inline uint32_t word_set_hash(uint32_t key)
+{
+    return (key * 0x9E3779B1u) ^ (key >> 15);
+}
+
+// Bitmasks of the slots of a bucket that hold `key` and that are free, bit n for slot n
+inline void word_set_match(const uint32_t* bucket, uint32_t key, uint32_t* found, uint32_t* free)
+{
+#if defined(WORD_SET_AVX2)
+    __m256i slots = _mm256_load_si256((const __m256i*)bucket);
+    *found = (uint32_t)_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(slots, _mm256_set1_epi32((int)key))));
+    *free = (uint32_t)_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(slots, _mm256_setzero_si256())));
+#elif defined(WORD_SET_SSE2)
+    __m128i low = _mm_load_si128((const __m128i*)bucket);
+    __m128i high = _mm_load_si128((const __m128i*)bucket + 1);
+    __m128i keys = _mm_set1_epi32((int)key);
+    __m128i zero = _mm_setzero_si128();
+    // The compares narrow to bytes, one movemask covers both halves of the bucket
+    __m128i compare = _mm_packs_epi16(
+        _mm_packs_epi32(_mm_cmpeq_epi32(low, keys), _mm_cmpeq_epi32(high, keys)),
+        _mm_packs_epi32(_mm_cmpeq_epi32(low, zero), _mm_cmpeq_epi32(high, zero)));
+    uint32_t mask = (uint32_t)_mm_movemask_epi8(compare);
+    *found = mask & 0xFF;
+    *free = mask >> 8;
+#elif defined(WORD_SET_WASM)
+    v128_t low = wasm_v128_load(bucket);
+    v128_t high = wasm_v128_load(bucket + 4);
+    v128_t keys = wasm_i32x4_splat((int)key);
+    v128_t zero = wasm_i32x4_splat(0);
+    *found = wasm_i32x4_bitmask(wasm_i32x4_eq(low, keys)) | (wasm_i32x4_bitmask(wasm_i32x4_eq(high, keys)) << 4);
+    *free = wasm_i32x4_bitmask(wasm_i32x4_eq(low, zero)) | (wasm_i32x4_bitmask(wasm_i32x4_eq(high, zero)) << 4);
+#else
+    *found = 0;
+    *free = 0;
+    for (int i = 0; i < WORD_SET_BUCKET_SLOTS; ++i) {
+        *found |= (uint32_t)(bucket[i] == key) << i;
+        *free |= (uint32_t)(bucket[i] == 0) << i;
+    }
+#endif
+}
+
+inline bool word_set_probe(const WordSet* set, uint32_t key, uint32_t bucket)
+{
+    for (;; bucket = (bucket + 1) & set->bucket_mask) {
+        uint32_t found = 0;
+        uint32_t free = 0;
+        word_set_match(set->slots + bucket * WORD_SET_BUCKET_SLOTS, key, &found, &free);
+        // One well predicted branch, whether the key is a word is not branched on
+        if ((found | free) != 0) return found != 0;
+    }
+}
+
+inline void word_set_insert(WordSet* set, uint32_t key)
+{
+    for (uint32_t bucket = word_set_hash(key) & set->bucket_mask;; bucket = (bucket + 1) & set->bucket_mask) {
+        uint32_t* slots = set->slots + bucket * WORD_SET_BUCKET_SLOTS;
+        uint32_t found = 0;
+        uint32_t free = 0;
+        word_set_match(slots, key, &found, &free);
+        if (found != 0) return;     // Word lists may hold duplicates
+        if (free != 0) {
+            int slot = 0;
+            while ((free & (1u << slot)) == 0) slot++;
+            slots[slot] = key;
+            set->word_count++;
+            return;
+        }
+    }
+}
+
+inline void word_set_unload(WordSet* set)
+{
+    RL_FREE(set->memory);
+    *set = WordSet{};
+}
+
+inline void word_set_build(WordSet* set, const Dictionary* dictionary)
+{
+    word_set_unload(set);
+
+    uint32_t buckets = 1;
+    while (buckets * WORD_SET_BUCKET_SLOTS < (uint32_t)dictionary->word_count * 2) buckets *= 2;
+    size_t size = (size_t)buckets * WORD_SET_BUCKET_SLOTS * sizeof(uint32_t);
+    set->memory = RL_MALLOC(size + 32);
+    set->slots = (uint32_t*)(((uintptr_t)set->memory + 31) & ~(uintptr_t)31);
+    memset(set->slots, 0, size);
+    set->bucket_mask = buckets - 1;
+    set->dictionary_id = dictionary->id;
+
+    int letters[WORD_CACHE_MAX_LETTERS + 1];
+    for (int offset = 0; offset < dictionary->words_size;) {
+        int length = 0;
+        while (offset < dictionary->words_size && dictionary->words[offset] != 0) {
+            if (length <= WORD_CACHE_MAX_LETTERS) letters[length] = dictionary->words[offset];
+            length++;
+            offset++;
+        }
+        offset++;
+        uint32_t key = 0;
+        if (length > 0 && length <= WORD_CACHE_MAX_LETTERS) {
+            letters[length] = 0;
+            if (word_cache_pack(letters, length + 1, &key)) word_set_insert(set, key);
+        }
+    }
+}
+
+// Sets bit i of `found` for every key i that is a word, `found` needs (count + 63) / 64
+// entries. Keys are packed with word_cache_pack(), 0 is never a word. Returns the number
+// of words
+inline int word_set_contains(const WordSet* set, const uint32_t* keys, int count, uint64_t* found)
+{
+    memset(found, 0, ((count + 63) / 64) * sizeof(uint64_t));
+    int result = 0;
+    uint32_t buckets[WORD_SET_BLOCK];
+    for (int start = 0; start < count; start += WORD_SET_BLOCK) {
+        int block = (count - start < WORD_SET_BLOCK) ? count - start : WORD_SET_BLOCK;
+#if defined(WORD_SET_AVX2)
+        if (block == WORD_SET_BLOCK) {
+            __m256i k = _mm256_loadu_si256((const __m256i*)(keys + start));
+            __m256i hash = _mm256_xor_si256(_mm256_mullo_epi32(k, _mm256_set1_epi32((int)0x9E3779B1u)), _mm256_srli_epi32(k, 15));
+            _mm256_storeu_si256((__m256i*)buckets, _mm256_and_si256(hash, _mm256_set1_epi32((int)set->bucket_mask)));
+        }
+        else
+#elif defined(WORD_SET_WASM)
+        if (block == WORD_SET_BLOCK) {
+            for (int i = 0; i < WORD_SET_BLOCK; i += 4) {
+                v128_t k = wasm_v128_load(keys + start + i);
+                v128_t hash = wasm_v128_xor(wasm_i32x4_mul(k, wasm_i32x4_splat((int)0x9E3779B1u)), wasm_u32x4_shr(k, 15));
+                wasm_v128_store(buckets + i, wasm_v128_and(hash, wasm_i32x4_splat((int)set->bucket_mask)));
+            }
+        }
+        else
+#endif
+        {
+            for (int i = 0; i < block; ++i) buckets[i] = word_set_hash(keys[start + i]) & set->bucket_mask;
+        }
+
+        // All lines of the block are requested before the first compare waits on memory
+#if defined(__GNUC__) || defined(__clang__)
+        for (int i = 0; i < block; ++i) __builtin_prefetch(set->slots + buckets[i] * WORD_SET_BUCKET_SLOTS);
+#endif
+        for (int i = 0; i < block; ++i) {
+            int index = start + i;
+            uint64_t hit = (keys[index] != 0 && word_set_probe(set, keys[index], buckets[i])) ? 1 : 0;
+            found[index / 64] |= hit << (index % 64);
+            result += (int)hit;
+        }
+    }
+    return result;
+}
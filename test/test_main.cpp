@@ -1,13 +1,45 @@
 #include "unity.h"
 #include "raylib.h"
 #include "dictionary.h"
+#include "game.h"
+#include "game_history.h"
+#include "high_scores.h"
+#include "dictionary_snapshot.h"
+#include "dictionary_patch.h"
+#include "arena.h"
+#include "word_cache.h"
+#include "word_set.h"
+#include "anagram_index.h"
+#include "heatmap.h"
+#include "ai_search.h"
+#include "modes.h"
+#include "resource_pack.h"
+#include "save_game.h"
+#include "sound.h"
+
+#include <filesystem>
+
+// modes.cpp is part of the tests, the game screen and the audio it uses are not
+SdfFont g_font;
+SdfFont g_default_font;
+float g_default_font_size = FONT_SIZE_SMALL;
+void sound_play(SoundEffect) {}
+
+// Set by the save tests while they run in a scratch directory
+static std::filesystem::path _test_directory;
 
 void setUp(void) {
     // set stuff up here
 }
 
 void tearDown(void) {
-    // clean stuff up here
+    // A failed assertion skips the rest of a test, leave its scratch directory here
+    if (!_test_directory.empty()) {
+        std::filesystem::path scratch = std::filesystem::current_path();
+        std::filesystem::current_path(_test_directory);
+        std::filesystem::remove_all(scratch);
+        _test_directory.clear();
+    }
 }
 
 void test_dict_should_load(void) {
@@ -26,10 +58,559 @@ void test_dict_should_load_german(void) {
 
 void test_dict_find_english(void) {
     Dictionary dict = dictionary_load("resources/dict_test_plain.txt");
-    int exists[6] = { 'W', 'O', 'R', 'D', 0, 0};
+    int exists[6] = { 0 };
+    TEST_ASSERT_EQUAL(4, alphabet_encode(&dict.alphabet, "WORD", exists, 6));
     TEST_ASSERT_TRUE(dictionary_exists(&dict, exists, 6));
-    int notexist[6] = { 'X', 'M', 'R', 'D', 0, 0};
+    int notexist[6] = { 0 };
+    TEST_ASSERT_EQUAL(4, alphabet_encode(&dict.alphabet, "DROW", notexist, 6));
     TEST_ASSERT_FALSE(dictionary_exists(&dict, notexist, 6));
+    TEST_ASSERT_EQUAL(-1, alphabet_encode(&dict.alphabet, "XMRD", notexist, 6));
+    dictionary_unload(&dict);
+}
+
+void test_dict_alphabet_german(void) {
+    Dictionary dict = dictionary_load("resources/dict_test_german.txt");
+    // P R Ä M B Ü N S ß T E
+    TEST_ASSERT_EQUAL(11, dict.alphabet.count);
+    TEST_ASSERT_EQUAL(4, dict.alphabet.bits);
+    int index = alphabet_get_index(&dict.alphabet, 0xDF);
+    TEST_ASSERT_TRUE(index > 0 && index <= dict.alphabet.count);
+    TEST_ASSERT_EQUAL(0xDF, alphabet_get_codepoint(&dict.alphabet, index));
+    int word[6] = { 0 };
+    TEST_ASSERT_EQUAL(3, alphabet_encode(&dict.alphabet, "S\xC3\x9C\xC3\x9F", word, 6));
+    TEST_ASSERT_TRUE(dictionary_exists(&dict, word, 6));
+    dictionary_unload(&dict);
+}
+
+void test_dict_binary_matches_text(void) {
+    Dictionary text = dictionary_load("resources/dict_test_german.txt");
+    Dictionary binary = dictionary_load("resources/dict_test_german.wgd");
+    TEST_ASSERT_TRUE(binary.words != nullptr);
+    TEST_ASSERT_EQUAL(text.word_count, binary.word_count);
+    TEST_ASSERT_EQUAL(text.alphabet.count, binary.alphabet.count);
+    TEST_ASSERT_EQUAL(text.alphabet.bits, binary.alphabet.bits);
+    TEST_ASSERT_EQUAL_INT_ARRAY(text.alphabet.codepoints + 1, binary.alphabet.codepoints + 1, text.alphabet.count);
+    int word[6] = { 0 };
+    TEST_ASSERT_EQUAL(5, alphabet_encode(&binary.alphabet, "BR\xC3\x9CNN", word, 6));
+    TEST_ASSERT_TRUE(dictionary_exists(&binary, word, 6));
+    dictionary_unload(&text);
+    dictionary_unload(&binary);
+}
+
+// raylib exits on LOG_FATAL unless a callback takes the messages
+static void trace_log_silent(int, const char*, va_list) {}
+
+void test_dict_binary_rejects_corrupt(void) {
+    int size = 0;
+    unsigned char* data = LoadFileData("resources/dict_test_german.wgd", &size);
+    TEST_ASSERT_NOT_NULL(data);
+    const int letters = 11;
+    const int counts = 12 + 4 * letters;        // Word count and size of the coded words
+    const int coded = counts + 8;
+
+    // The first word shares a prefix, a letter is past the alphabet, the counts disagree,
+    // the second word shares more than the first one has
+    const int offsets[] = { coded, coded + 1, counts, coded + 7 };
+    const unsigned char values[] = { 1, letters + 1, 5, 9 };
+    SetTraceLogCallback(trace_log_silent);
+    for (int i = 0; i < 4; ++i) {
+        unsigned char saved = data[offsets[i]];
+        data[offsets[i]] = values[i];
+        TEST_ASSERT_TRUE(SaveFileData("corrupt.wgd", data, size));
+        Dictionary dict = dictionary_load_binary("corrupt.wgd");
+        TEST_ASSERT_NULL(dict.words);
+        data[offsets[i]] = saved;
+    }
+    SetTraceLogCallback(nullptr);
+    remove("corrupt.wgd");
+    UnloadFileData(data);
+}
+
+void test_game_history_undo_redo(void) {
+    Dictionary dict = dictionary_load("resources/dict_test_plain.txt");
+    int distribution[] = { 1, 1, 2, 1 };
+    dict.distribution = distribution;
+    dict.distribution_count = 4;
+    dict.distribution_sum = 2;
+
+    Game game;
+    game_init(&game, MODE_MOVEATTACK, 5, 5, 42, &dict);
+    GameHistory history;
+    game_history_init(&history, 2);
+
+    Game states[4] = { game };
+    for (int i = 1; i < 4; ++i) {
+        Game before = game;
+        TEST_ASSERT_TRUE(game_play(&game, &dict, 0, i, 0, nullptr));
+        game_history_record(&history, &before, &game);
+        states[i] = game;
+    }
+    TEST_ASSERT_EQUAL(3, game.move_count);
+
+    // Only the last two moves are kept
+    TEST_ASSERT_TRUE(game_history_undo(&history, &game));
+    TEST_ASSERT_TRUE(game_history_undo(&history, &game));
+    TEST_ASSERT_FALSE(game_history_undo(&history, &game));
+    TEST_ASSERT_EQUAL_MEMORY(&states[1], &game, sizeof(Game));
+
+    TEST_ASSERT_TRUE(game_history_redo(&history, &game));
+    TEST_ASSERT_TRUE(game_history_redo(&history, &game));
+    TEST_ASSERT_FALSE(game_history_redo(&history, &game));
+    TEST_ASSERT_EQUAL_MEMORY(&states[3], &game, sizeof(Game));
+
+    game_history_unload(&history);
+    dict.distribution = nullptr;
+    dictionary_unload(&dict);
+}
+
+void test_game_history_bonus_time(void) {
+    Dictionary dict = dictionary_load("resources/dict_test_plain.txt");
+    int distribution[] = { 1, 1, 2, 1 };
+    dict.distribution = distribution;
+    dict.distribution_count = 4;
+    dict.distribution_sum = 2;
+
+    Game game;
+    game_init(&game, MODE_TIMEATTACK, 4, 4, 42, &dict);
+    game.timeattack.time_remaining = 60.0f;
+    game.timeattack.next_increase = 0;
+    int row[5] = { 0 };
+    alphabet_encode(&dict.alphabet, "WORD", row, 5);
+    for (int x = 0; x < 3; ++x) game_set_letter(&game, x, 0, row[x]);
+    game.well[0] = row[3];
+    GameHistory history;
+    game_history_init(&history, 2);
+
+    // The word earns the bonus in the same update that the clock runs
+    Game before = game;
+    TEST_ASSERT_TRUE(game_play(&game, &dict, 0, 3, 0, nullptr));
+    TEST_ASSERT_EQUAL(1, game.word_count);
+    game.timeattack.time_remaining -= 0.5f;
+    TEST_ASSERT_TRUE(game_timeattack_bonus(&game, 10.0f, 5));
+    game_history_record(&history, &before, &game);
+    TEST_ASSERT_EQUAL_FLOAT(69.5f, game.timeattack.time_remaining);
+
+    // Undo takes the bonus back but not the time that passed
+    game.timeattack.time_remaining -= 1.0f;
+    TEST_ASSERT_TRUE(game_history_undo(&history, &game));
+    TEST_ASSERT_EQUAL_FLOAT(58.5f, game.timeattack.time_remaining);
+    TEST_ASSERT_EQUAL(0, game.word_count);
+    TEST_ASSERT_EQUAL(0, game.timeattack.next_increase);
+
+    TEST_ASSERT_TRUE(game_history_redo(&history, &game));
+    TEST_ASSERT_EQUAL_FLOAT(68.5f, game.timeattack.time_remaining);
+    TEST_ASSERT_EQUAL(5, game.timeattack.next_increase);
+
+    game_history_unload(&history);
+    dict.distribution = nullptr;
+    dictionary_unload(&dict);
+}
+
+void test_modes_resume_labels(void) {
+    // A new game of the default mode is set up, then a saved versus game replaces it
+    Game game;
+    game.mode = MODE_TIMEATTACK;
+    mode_timeattack_init(&game);
+    modes_init_labels();
+    game.mode = MODE_VERSUS;
+
+    for (int mode = MODE_TIMEATTACK; mode < MODE_COUNT; ++mode) {
+        int lines = 0;
+        for (const TextLabel* label = mode_label((GameMode)mode, 0); label != nullptr; label = mode_label((GameMode)mode, ++lines)) {
+            TEST_ASSERT_NOT_NULL(label->font);
+        }
+        TEST_ASSERT_GREATER_THAN(0, lines);
+    }
+    TEST_ASSERT_EQUAL_PTR(&g_default_font, mode_label(MODE_VERSUS, 3)->font);
+    TEST_ASSERT_NULL(mode_label(MODE_VERSUS, 4));
+}
+
+void test_resource_pack_bounds(void) {
+    // One stored entry, the data starts at the next multiple of PACK_ALIGNMENT after the name
+    unsigned char archive[64] = { 0 };
+    PackHeader header = { { 'W', 'G', 'P', 'K' }, PACK_VERSION, 1, sizeof(PackHeader) + sizeof(PackEntry) };
+    PackEntry entry = { 0, 5, 0, 48, 5, 5 };
+    memcpy(archive, &header, sizeof(header));
+    memcpy(archive + sizeof(header), &entry, sizeof(entry));
+    memcpy(archive + header.names_offset, "a.txt", 5);
+    memcpy(archive + entry.data_offset, "hello", 5);
+
+    TEST_ASSERT_TRUE(resource_pack_open_memory(archive, 53));
+    TEST_ASSERT_TRUE(resource_exists("a.txt"));
+    resource_pack_close();
+
+    // Cut off in the data of the entry
+    TEST_ASSERT_FALSE(resource_pack_open_memory(archive, 50));
+    TEST_ASSERT_FALSE(resource_exists("a.txt"));
+
+    // A name that runs past the end
+    entry.name_length = 200;
+    memcpy(archive + sizeof(header), &entry, sizeof(entry));
+    TEST_ASSERT_FALSE(resource_pack_open_memory(archive, 53));
+
+    // A stored entry that claims more than it stores
+    entry.name_length = 5;
+    entry.size = 4000;
+    memcpy(archive + sizeof(header), &entry, sizeof(entry));
+    TEST_ASSERT_FALSE(resource_pack_open_memory(archive, 53));
+}
+
+// The save lives in the working directory, the tests use one of their own like wordgrid_frame_bench,
+// tearDown() returns from it
+static void enter_scratch_directory(const char* name)
+{
+    std::filesystem::path scratch = std::filesystem::temp_directory_path() / name;
+    std::filesystem::remove_all(scratch);
+    std::filesystem::create_directory(scratch);
+    _test_directory = std::filesystem::current_path();
+    std::filesystem::current_path(scratch);
+}
+
+static Game save_test_game(unsigned int* alphabet_key)
+{
+    Dictionary dict = dictionary_load("resources/dict_test_plain.txt");
+    int distribution[] = { 1, 1, 2, 1 };
+    dict.distribution = distribution;
+    dict.distribution_count = 4;
+    dict.distribution_sum = 2;
+
+    Game game;
+    game_init(&game, MODE_MOVEATTACK, 5, 5, 42, &dict);
+    game_play(&game, &dict, 0, 1, 1, nullptr);
+    game.moveattack.available_moves = 50;
+    *alphabet_key = save_game_alphabet_key(&dict.alphabet);
+    dict.distribution = nullptr;
+    dictionary_unload(&dict);
+    return game;
+}
+
+void test_save_game_round_trip(void) {
+    unsigned int key = 0;
+    Game game = save_test_game(&key);
+    enter_scratch_directory("wordgrid_test_save");
+
+    TEST_ASSERT_FALSE(save_game_exists());
+    save_game_write(&game, key);
+    TEST_ASSERT_TRUE(save_game_exists());
+    TEST_ASSERT_FALSE(std::filesystem::exists("wordgrid.sav.tmp"));
+
+    Game loaded;
+    TEST_ASSERT_TRUE(save_game_read(&loaded, key));
+    // Up to the last member, the padding behind it is not part of the game
+    TEST_ASSERT_EQUAL_MEMORY(&game, &loaded, offsetof(Game, versus) + sizeof(ModeVersusState));
+
+    // The background write replaces the file once it is done
+    game.word_count = 7;
+    save_game_write_async(&game, key);
+    save_game_shutdown();
+    TEST_ASSERT_TRUE(save_game_read(&loaded, key));
+    TEST_ASSERT_EQUAL(7, loaded.word_count);
+
+    save_game_delete();
+    TEST_ASSERT_FALSE(save_game_exists());
+    TEST_ASSERT_FALSE(save_game_read(&loaded, key));
+}
+
+void test_save_game_rejects_mismatch(void) {
+    unsigned int key = 0;
+    Game game = save_test_game(&key);
+    enter_scratch_directory("wordgrid_test_save");
+    save_game_write(&game, key);
+
+    int size = 0;
+    unsigned char* data = LoadFileData("wordgrid.sav", &size);
+    TEST_ASSERT_EQUAL((int)(sizeof(SaveHeader) + sizeof(Game)), size);
+
+    // Another alphabet, a changed byte of the game, another version
+    Game loaded;
+    TEST_ASSERT_FALSE(save_game_read(&loaded, key + 1));
+
+    data[sizeof(SaveHeader) + offsetof(Game, word_count)] ^= 1;
+    TEST_ASSERT_TRUE(SaveFileData("wordgrid.sav", data, size));
+    TEST_ASSERT_FALSE(save_game_read(&loaded, key));
+    data[sizeof(SaveHeader) + offsetof(Game, word_count)] ^= 1;
+
+    SaveHeader header;
+    memcpy(&header, data, sizeof(header));
+    header.version = SAVE_VERSION + 1;
+    memcpy(data, &header, sizeof(header));
+    TEST_ASSERT_TRUE(SaveFileData("wordgrid.sav", data, size));
+    TEST_ASSERT_FALSE(save_game_read(&loaded, key));
+
+    // A file cut short
+    header.version = SAVE_VERSION;
+    memcpy(data, &header, sizeof(header));
+    TEST_ASSERT_TRUE(SaveFileData("wordgrid.sav", data, size - 4));
+    TEST_ASSERT_FALSE(save_game_read(&loaded, key));
+
+    TEST_ASSERT_TRUE(SaveFileData("wordgrid.sav", data, size));
+    TEST_ASSERT_TRUE(save_game_read(&loaded, key));
+    UnloadFileData(data);
+
+    save_game_delete();
+}
+
+void test_high_score_table(void) {
+    HighScoreTable table = { 0 };
+    for (int i = 0; i < 20; ++i) {
+        HighScoreRecord record = { 0 };
+        record.score = i % 10;
+        record.timestamp = i;
+        high_score_table_add(&table, &record);
+    }
+    TEST_ASSERT_EQUAL(20, table.game_count);
+    TEST_ASSERT_EQUAL(HIGH_SCORE_TOP_COUNT, table.top_count);
+    // Equal scores keep the earlier game first
+    TEST_ASSERT_EQUAL(9, table.top[0].score);
+    TEST_ASSERT_EQUAL(9, table.top[0].timestamp);
+    TEST_ASSERT_EQUAL(19, table.top[1].timestamp);
+    TEST_ASSERT_EQUAL(5, table.top[HIGH_SCORE_TOP_COUNT - 1].score);
+
+    // Ties count half
+    TEST_ASSERT_EQUAL_FLOAT(55.0f, high_score_table_percentile(&table, 5));
+    TEST_ASSERT_EQUAL_FLOAT(5.0f, high_score_table_percentile(&table, 0));
+    TEST_ASSERT_EQUAL_FLOAT(100.0f, high_score_table_percentile(&table, 10));
+}
+
+void test_dictionary_snapshot_publish(void) {
+    DictionaryStore store;
+    TEST_ASSERT_NULL(dictionary_store_acquire(&store));
+
+    Dictionary dict = dictionary_load("resources/dict_test_plain.txt");
+    DictionarySnapshot* first = dictionary_snapshot_create(&dict);
+    TEST_ASSERT_NULL(dict.words);
+    TEST_ASSERT_NOT_NULL(first->dictionary.index);
+    dictionary_store_publish(&store, first);
+
+    DictionarySnapshot* held = dictionary_store_acquire(&store);
+    TEST_ASSERT_EQUAL_PTR(first, held);
+    TEST_ASSERT_EQUAL(1, held->version);
+    TEST_ASSERT_EQUAL(2, held->references.load());
+
+    // The indexed lookup agrees with the linear search for every word and a miss
+    Dictionary linear = dictionary_load("resources/dict_test_plain.txt");
+    for (int offset = 0; offset < linear.words_size;) {
+        int word[16] = { 0 };
+        int length = 0;
+        while (linear.words[offset] != 0) word[length++] = linear.words[offset++];
+        offset++;
+        TEST_ASSERT_TRUE(dictionary_exists(&held->dictionary, word, 16));
+    }
+    int missing[6] = { 1, 1, 1, 1, 1, 0 };
+    TEST_ASSERT_EQUAL(dictionary_exists(&linear, missing, 6), dictionary_exists(&held->dictionary, missing, 6));
+    dictionary_unload(&linear);
+
+    // Holders keep the old snapshot after a new one was published
+    Dictionary next = dictionary_load("resources/dict_test_plain.txt");
+    dictionary_store_publish(&store, dictionary_snapshot_create(&next));
+    TEST_ASSERT_EQUAL(1, held->references.load());
+    DictionarySnapshot* current = dictionary_store_acquire(&store);
+    TEST_ASSERT_EQUAL(2, current->version);
+    dictionary_snapshot_release(current);
+    dictionary_snapshot_release(held);
+
+    dictionary_store_clear(&store);
+    TEST_ASSERT_NULL(dictionary_store_acquire(&store));
+}
+
+void test_dictionary_patch(void) {
+    const char* old_text = "WORD\nNOWORD\nTEST\nTEST";
+    const char* new_text = "WORD\nROW\nDOT\nTEST\nTEST";
+    Dictionary base = dictionary_load("resources/dict_test_plain.txt");
+    dictionary_build_index(&base);
+
+    Dictionary patched;
+    TEST_ASSERT_TRUE(dictionary_patch(&base, old_text, new_text, &patched));
+    TEST_ASSERT_EQUAL(5, patched.word_count);
+    TEST_ASSERT_NOT_NULL(patched.index);
+
+    int word[7] = { 0 };
+    alphabet_encode(&patched.alphabet, "ROW", word, 7);
+    TEST_ASSERT_TRUE(dictionary_exists(&patched, word, 7));
+    alphabet_encode(&patched.alphabet, "NOWORD", word, 7);
+    TEST_ASSERT_FALSE(dictionary_exists(&patched, word, 7));
+    alphabet_encode(&patched.alphabet, "TEST", word, 7);
+    TEST_ASSERT_TRUE(dictionary_exists(&patched, word, 7));
+
+    // Letters outside of the alphabet need a full load
+    Dictionary rejected;
+    TEST_ASSERT_FALSE(dictionary_patch(&base, old_text, "WORD\nZOO", &rejected));
+
+    dictionary_unload(&patched);
+    dictionary_unload(&base);
+}
+
+void test_arena_pool(void) {
+    Arena arena;
+    arena_init(&arena, 256, "test");
+    int* numbers = arena_push<int>(&arena, 8);
+    TEST_ASSERT_NOT_NULL(numbers);
+    TEST_ASSERT_EQUAL(0, (uintptr_t)numbers % alignof(int));
+
+    size_t mark = arena_mark(&arena);
+    TEST_ASSERT_EQUAL_STRING("12 words", arena_format(&arena, "%d words", 12));
+    arena_rewind(&arena, mark);
+    TEST_ASSERT_EQUAL(mark, arena.used);
+
+    // Running out returns nullptr instead of growing
+    TEST_ASSERT_NULL(arena_alloc(&arena, 1024));
+    TEST_ASSERT_EQUAL_STRING("", arena_format(&arena, "%0512d", 1));
+
+    Pool pool;
+    arena_reset(&arena);
+    pool_init(&pool, &arena, 40);
+    void* first = pool_alloc(&pool);
+    void* second = pool_alloc(&pool);
+    TEST_ASSERT_NOT_NULL(second);
+    pool_free(&pool, first);
+    TEST_ASSERT_EQUAL_PTR(first, pool_alloc(&pool));
+    TEST_ASSERT_EQUAL(2, pool.live);
+
+    arena_unload(&arena);
+}
+
+void test_word_cache(void) {
+    Dictionary dict = dictionary_load("resources/dict_test_plain.txt");
+    WordCache* cache = new WordCache();
+    int word[6] = { 0 };
+    alphabet_encode(&dict.alphabet, "TEST", word, 6);
+    TEST_ASSERT_TRUE(word_cache_exists(cache, &dict, word, 6));
+    TEST_ASSERT_TRUE(word_cache_exists(cache, &dict, word, 6));
+    TEST_ASSERT_EQUAL(1, cache->stats.hits);
+    TEST_ASSERT_EQUAL(1, cache->stats.misses);
+
+    alphabet_encode(&dict.alphabet, "TWO", word, 6);
+    TEST_ASSERT_FALSE(word_cache_exists(cache, &dict, word, 6));
+    TEST_ASSERT_FALSE(word_cache_exists(cache, &dict, word, 6));
+
+    // Another dictionary empties the cache
+    Dictionary other = dictionary_load("resources/dict_test_plain.txt");
+    TEST_ASSERT_FALSE(word_cache_exists(cache, &other, word, 6));
+    TEST_ASSERT_EQUAL(3, cache->stats.misses);
+
+    delete cache;
+    dictionary_unload(&other);
+    dictionary_unload(&dict);
+}
+
+void test_word_set_contains(void) {
+    Dictionary dict = dictionary_load("resources/dict_test_plain.txt");
+    WordSet set;
+    word_set_build(&set, &dict);
+    TEST_ASSERT_EQUAL(2, set.word_count);    // NOWORD is too long, TEST is listed twice
+
+    const char* candidates[] = { "WORD", "TEST", "TWO", "ROW", "WORD", "DOT", "TEST", "TEST", "OW", "T" };
+    uint32_t keys[10] = { 0 };
+    int word[7] = { 0 };
+    for (int i = 0; i < 10; ++i) {
+        alphabet_encode(&dict.alphabet, candidates[i], word, 7);
+        TEST_ASSERT_TRUE(word_cache_pack(word, 7, &keys[i]));
+    }
+    uint64_t found = 0;
+    TEST_ASSERT_EQUAL(5, word_set_contains(&set, keys, 10, &found));
+    TEST_ASSERT_EQUAL_HEX64(0xD3, found);
+
+    word_set_unload(&set);
+    dictionary_unload(&dict);
+}
+
+void test_anagram_fill_line(void) {
+    Dictionary dict = dictionary_load("resources/dict_test_plain.txt");
+    AnagramIndex index;
+    anagram_index_build(&index, &dict);
+    TEST_ASSERT_EQUAL(2, index.word_count);
+
+    int letters[7] = { 0 };
+    const uint32_t* words = nullptr;
+    alphabet_encode(&dict.alphabet, "DROW", letters, 7);
+    TEST_ASSERT_EQUAL(1, anagram_find(&index, letters, 4, &words));
+
+    int well[5] = { 0 };
+    alphabet_encode(&dict.alphabet, "OTSE", well, 5);
+    well[4] = ALPHABET_MAX_LETTERS + 1;     // Specials are not letters
+
+    int line[5] = { 0 };
+    alphabet_encode(&dict.alphabet, "WORD", line, 5);
+    line[1] = 0;
+    uint32_t used = 0;
+    TEST_ASSERT_EQUAL(1, anagram_fill_line(&index, line, 4, well, 5, &used));
+    TEST_ASSERT_EQUAL_HEX32(0x1, used);
+
+    alphabet_encode(&dict.alphabet, "TEST", line, 5);
+    line[1] = 0;
+    line[2] = 0;
+    TEST_ASSERT_EQUAL(1, anagram_fill_line(&index, line, 4, well, 5, &used));
+    TEST_ASSERT_EQUAL_HEX32(0xC, used);
+
+    // The letters fit but not in place
+    alphabet_encode(&dict.alphabet, "DROW", line, 5);
+    line[1] = 0;
+    TEST_ASSERT_EQUAL(0, anagram_fill_line(&index, line, 4, well, 5, &used));
+
+    anagram_index_unload(&index);
+    dictionary_unload(&dict);
+}
+
+void test_pattern_count(void) {
+    Dictionary dict = dictionary_load("resources/dict_test_plain.txt");
+    PatternIndex index;
+    pattern_index_build(&index, &dict);
+
+    int word[5] = { 0 };
+    alphabet_encode(&dict.alphabet, "WORD", word, 5);
+    int line[4] = { word[0], 0, 0, word[3] };
+    TEST_ASSERT_EQUAL(1, pattern_count(&index, line, 4, ~0ull));
+    line[0] = 0;
+    line[3] = 0;
+    uint64_t allowed = (1ull << word[0]) | (1ull << word[1]) | (1ull << word[2]) | (1ull << word[3]);
+    TEST_ASSERT_EQUAL(1, pattern_count(&index, line, 4, allowed));
+    TEST_ASSERT_EQUAL(0, pattern_count(&index, line, 4, allowed & ~(1ull << word[2])));
+    TEST_ASSERT_EQUAL(0, pattern_count(&index, line, 6, ~0ull));
+
+    pattern_index_unload(&index);
+    dictionary_unload(&dict);
+}
+
+void test_ai_search(void) {
+    Dictionary dict = dictionary_load("resources/dict_test_plain.txt");
+    int distribution[] = { 1, 1, 2, 1 };
+    dict.distribution = distribution;
+    dict.distribution_count = 4;
+    dict.distribution_sum = 2;
+
+    Game game;
+    game_init(&game, MODE_VERSUS, 4, 4, 42, &dict);
+    int row[5] = { 0 };
+    alphabet_encode(&dict.alphabet, "WOR", row, 5);
+    for (int x = 0; x < 3; ++x) game_set_letter(&game, x, 0, row[x]);
+    int well[GAME_WELL_SIZE + 1] = { 0 };
+    alphabet_encode(&dict.alphabet, "NEDST", well, GAME_WELL_SIZE + 1);
+    memcpy(game.well, well, sizeof(game.well));
+
+    AiSearch search;
+    ai_search_init(&search, 1024);
+    search.dictionary = &dict;
+    AiResult result;
+    TEST_ASSERT_TRUE(ai_search(&search, &game, 1, 10.0, &result));
+    TEST_ASSERT_EQUAL(1, result.depth);
+    TEST_ASSERT_EQUAL(1, result.value);
+    TEST_ASSERT_EQUAL(2, result.well_index);
+    TEST_ASSERT_EQUAL(3, result.x);
+    TEST_ASSERT_EQUAL(0, result.y);
+
+    // Looking one move further the computer does not leave a word for the other side
+    game_set_letter(&game, 2, 0, GAME_EMPTY);
+    alphabet_encode(&dict.alphabet, "RDNET", well, GAME_WELL_SIZE + 1);
+    memcpy(game.well, well, sizeof(game.well));
+    ai_search_clear(&search);
+    result = AiResult{};
+    TEST_ASSERT_TRUE(ai_search(&search, &game, 2, 10.0, &result));
+    TEST_ASSERT_EQUAL(2, result.depth);
+    TEST_ASSERT_EQUAL(0, result.value);
+    TEST_ASSERT_FALSE(result.y == 0 && (result.x == 2 || result.x == 3));
+
+    ai_search_unload(&search);
+    dict.distribution = nullptr;
     dictionary_unload(&dict);
 }
 
@@ -39,5 +620,23 @@ int main(void) {
     RUN_TEST(test_dict_should_load);
     RUN_TEST(test_dict_should_load_german);
     RUN_TEST(test_dict_find_english);
+    RUN_TEST(test_dict_alphabet_german);
+    RUN_TEST(test_dict_binary_matches_text);
+    RUN_TEST(test_dict_binary_rejects_corrupt);
+    RUN_TEST(test_game_history_undo_redo);
+    RUN_TEST(test_game_history_bonus_time);
+    RUN_TEST(test_modes_resume_labels);
+    RUN_TEST(test_resource_pack_bounds);
+    RUN_TEST(test_save_game_round_trip);
+    RUN_TEST(test_save_game_rejects_mismatch);
+    RUN_TEST(test_high_score_table);
+    RUN_TEST(test_dictionary_snapshot_publish);
+    RUN_TEST(test_dictionary_patch);
+    RUN_TEST(test_arena_pool);
+    RUN_TEST(test_word_cache);
+    RUN_TEST(test_word_set_contains);
+    RUN_TEST(test_anagram_fill_line);
+    RUN_TEST(test_pattern_count);
+    RUN_TEST(test_ai_search);
     return UNITY_END();
 }
\ No newline at end of file
@@ -0,0 +1,246 @@
+/*******************************************************************************************
+*
+*   WordGrid
+*   Simple Word Puzzle Game
+*   (C) Harald Scheirich 2024
+*   WordGrid is is licensed under an unmodified zlib/libpng license see LICENSE
+*
+*   Asset baker, writes pre-scaled variants of the board textures
+*   usage: asset_baker <resources directory> <output directory>
+*
+*   For every texture and scale factor two files are written
+*   <name>@<scale>x.dds  DXT5 compressed with a full mipmap chain
+*   <name>@<scale>x.png  uncompressed fallback, mipmaps are generated on load
+*
+********************************************************************************************/
+
+#include "raylib.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+
+struct BakeEntry {
+    const char* name;   // File name without extension in the resources directory
+    float design_size;  // Size on screen at a window scale of 1
+};
+
+static const BakeEntry _entries[] = {
+    { "tile_space", 69.0f },
+};
+
+static const int _scales[] = { 1, 2 };
+
+//----------------------------------------------------------------------------------
+// DXT5 (BC3) Encoding
+//----------------------------------------------------------------------------------
+static uint16_t pack_565(const unsigned char* c)
+{
+    return (uint16_t)(((c[0] >> 3) << 11) | ((c[1] >> 2) << 5) | (c[2] >> 3));
+}
+
+static void unpack_565(uint16_t v, int* c)
+{
+    c[0] = ((v >> 11) & 31) * 255 / 31;
+    c[1] = ((v >> 5) & 63) * 255 / 63;
+    c[2] = (v & 31) * 255 / 31;
+}
+
+// Bounding box encoder, good enough for flat colored tiles
+static void encode_block(const unsigned char block[16][4], unsigned char* out)
+{
+    // Alpha, 8 interpolated values between max and min
+    int alpha_min = 255;
+    int alpha_max = 0;
+    for (int i = 0; i < 16; ++i) {
+        if (block[i][3] < alpha_min) alpha_min = block[i][3];
+        if (block[i][3] > alpha_max) alpha_max = block[i][3];
+    }
+    int alphas[8] = { alpha_max, alpha_min };
+    for (int i = 1; i < 7; ++i) alphas[i + 1] = ((7 - i) * alpha_max + i * alpha_min) / 7;
+
+    uint64_t alpha_bits = 0;
+    for (int i = 0; i < 16; ++i) {
+        int best = 0;
+        int best_error = 1 << 30;
+        for (int j = 0; j < 8; ++j) {
+            int error = block[i][3] - alphas[j];
+            error *= error;
+            if (error < best_error) { best_error = error; best = j; }
+        }
+        alpha_bits |= (uint64_t)best << (3 * i);
+    }
+    out[0] = (unsigned char)alpha_max;
+    out[1] = (unsigned char)alpha_min;
+    for (int i = 0; i < 6; ++i) out[2 + i] = (unsigned char)(alpha_bits >> (8 * i));
+
+    // Color, endpoints from the bounding box of the visible pixels
+    unsigned char lo[3] = { 255, 255, 255 };
+    unsigned char hi[3] = { 0, 0, 0 };
+    for (int i = 0; i < 16; ++i) {
+        if (block[i][3] == 0) continue;
+        for (int c = 0; c < 3; ++c) {
+            if (block[i][c] < lo[c]) lo[c] = block[i][c];
+            if (block[i][c] > hi[c]) hi[c] = block[i][c];
+        }
+    }
+    if (lo[0] > hi[0]) { memset(lo, 0, 3); memset(hi, 0, 3); }
+
+    uint16_t c0 = pack_565(hi);
+    uint16_t c1 = pack_565(lo);
+    int palette[4][3];
+    unpack_565(c0, palette[0]);
+    unpack_565(c1, palette[1]);
+    for (int c = 0; c < 3; ++c) {
+        palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+        palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+    }
+
+    uint32_t color_bits = 0;
+    for (int i = 0; i < 16; ++i) {
+        int best = 0;
+        int best_error = 1 << 30;
+        for (int j = 0; j < 4; ++j) {
+            int error = 0;
+            for (int c = 0; c < 3; ++c) {
+                int d = block[i][c] - palette[j][c];
+                error += d * d;
+            }
+            if (error < best_error) { best_error = error; best = j; }
+        }
+        color_bits |= (uint32_t)best << (2 * i);
+    }
+    out[8] = (unsigned char)(c0 & 0xff);
+    out[9] = (unsigned char)(c0 >> 8);
+    out[10] = (unsigned char)(c1 & 0xff);
+    out[11] = (unsigned char)(c1 >> 8);
+    for (int i = 0; i < 4; ++i) out[12 + i] = (unsigned char)(color_bits >> (8 * i));
+}
+
+static int dxt5_level_size(int width, int height)
+{
+    return ((width + 3) / 4) * ((height + 3) / 4) * 16;
+}
+
+// Expects an R8G8B8A8 image, returns the number of bytes written to `out`
+static int encode_level(Image image, unsigned char* out)
+{
+    const unsigned char* pixels = (const unsigned char*)image.data;
+    int written = 0;
+    for (int by = 0; by < image.height; by += 4) {
+        for (int bx = 0; bx < image.width; bx += 4) {
+            unsigned char block[16][4];
+            for (int i = 0; i < 16; ++i) {
+                int x = bx + i % 4;
+                int y = by + i / 4;
+                if (x >= image.width) x = image.width - 1;
+                if (y >= image.height) y = image.height - 1;
+                memcpy(block[i], &pixels[(y * image.width + x) * 4], 4);
+            }
+            encode_block(block, out + written);
+            written += 16;
+        }
+    }
+    return written;
+}
+
+//----------------------------------------------------------------------------------
+// DDS Output
+//----------------------------------------------------------------------------------
+static void write_u32(FILE* file, uint32_t value)
+{
+    unsigned char bytes[4] = {
+        (unsigned char)value, (unsigned char)(value >> 8), (unsigned char)(value >> 16), (unsigned char)(value >> 24)
+    };
+    fwrite(bytes, 1, 4, file);
+}
+
+static bool export_dds(Image image, const char* filename)
+{
+    int mipmaps = 1;
+    for (int size = (image.width > image.height) ? image.width : image.height; size > 1; size /= 2) mipmaps++;
+
+    FILE* file = fopen(filename, "wb");
+    if (file == nullptr) return false;
+
+    const uint32_t DDSD_CAPS = 0x1, DDSD_HEIGHT = 0x2, DDSD_WIDTH = 0x4, DDSD_PIXELFORMAT = 0x1000;
+    const uint32_t DDSD_MIPMAPCOUNT = 0x20000, DDSD_LINEARSIZE = 0x80000;
+    const uint32_t DDPF_FOURCC = 0x4;
+    const uint32_t DDSCAPS_COMPLEX = 0x8, DDSCAPS_TEXTURE = 0x1000, DDSCAPS_MIPMAP = 0x400000;
+
+    fwrite("DDS ", 1, 4, file);
+    write_u32(file, 124);
+    write_u32(file, DDSD_CAPS | DDSD_HEIGHT | DDSD_WIDTH | DDSD_PIXELFORMAT | DDSD_MIPMAPCOUNT | DDSD_LINEARSIZE);
+    write_u32(file, image.height);
+    write_u32(file, image.width);
+    write_u32(file, dxt5_level_size(image.width, image.height));
+    write_u32(file, 0); // depth
+    write_u32(file, mipmaps);
+    for (int i = 0; i < 11; ++i) write_u32(file, 0);
+    // Pixel format
+    write_u32(file, 32);
+    write_u32(file, DDPF_FOURCC);
+    fwrite("DXT5", 1, 4, file);
+    for (int i = 0; i < 5; ++i) write_u32(file, 0);
+    write_u32(file, DDSCAPS_COMPLEX | DDSCAPS_TEXTURE | DDSCAPS_MIPMAP);
+    for (int i = 0; i < 4; ++i) write_u32(file, 0);
+
+    unsigned char* buffer = (unsigned char*)MemAlloc(dxt5_level_size(image.width, image.height));
+    Image level = ImageCopy(image);
+    for (int i = 0; i < mipmaps; ++i) {
+        int size = encode_level(level, buffer);
+        fwrite(buffer, 1, size, file);
+        int width = (level.width > 1) ? level.width / 2 : 1;
+        int height = (level.height > 1) ? level.height / 2 : 1;
+        ImageResize(&level, width, height);
+    }
+    UnloadImage(level);
+    MemFree(buffer);
+    fclose(file);
+    return true;
+}
+
+//----------------------------------------------------------------------------------
+// Main entry point
+//----------------------------------------------------------------------------------
+int main(int argc, char** argv)
+{
+    if (argc < 3) {
+        printf("usage: %s <resources directory> <output directory>\n", argv[0]);
+        return 1;
+    }
+    const char* source_dir = argv[1];
+    const char* target_dir = argv[2];
+
+    SetTraceLogLevel(LOG_WARNING);
+    if (!DirectoryExists(target_dir)) MakeDirectory(target_dir);
+
+    int result = 0;
+    for (const BakeEntry& entry : _entries) {
+        Image source = LoadImage(TextFormat("%s/%s.png", source_dir, entry.name));
+        if (source.data == nullptr) {
+            printf("Could not load %s/%s.png\n", source_dir, entry.name);
+            result = 1;
+            continue;
+        }
+        ImageFormat(&source, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+
+        for (int scale : _scales) {
+            // Compressed formats want a multiple of 4, the loader scales by the actual size
+            int size = ((int)(entry.design_size * scale) + 3) / 4 * 4;
+            Image variant = ImageCopy(source);
+            ImageResize(&variant, size, size);
+
+            char filename[512];
+            snprintf(filename, sizeof(filename), "%s/%s@%dx.png", target_dir, entry.name, scale);
+            if (!ExportImage(variant, filename)) result = 1;
+            snprintf(filename, sizeof(filename), "%s/%s@%dx.dds", target_dir, entry.name, scale);
+            if (!export_dds(variant, filename)) result = 1;
+
+            printf("Baked %s@%dx %dx%d\n", entry.name, scale, size, size);
+            UnloadImage(variant);
+        }
+        UnloadImage(source);
+    }
+    return result;
+}
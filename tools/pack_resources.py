@@ -0,0 +1,165 @@
+#!/usr/bin/env python3
+#*******************************************************************************************
+#
+#   WordGrid
+#   Simple Word Puzzle Game
+#   (C) Harald Scheirich 2024
+#   WordGrid is is licensed under an unmodified zlib/libpng license see LICENSE
+#
+#   Writes the resource archive read by src/resource_pack.cpp
+#   usage: pack_resources.py -o resources.wgpak [--exclude pattern] [--binary-dictionary]
+#                            resources=src/resources [prefix=dir ...]
+#
+#   With --binary-dictionary every words.txt is stored as words.wgd, the format read by
+#   dictionary_load_binary() in src/dictionary.h
+#       char magic[4]           "WGDI"
+#       uint32 version          1
+#       uint32 letter_count     size of the alphabet
+#       uint32 codepoints[]     sorted, letter index i + 1 is codepoints[i]
+#       uint32 word_count
+#       uint32 data_size
+#       uint8 data[]            front coded words, sorted, each one is stored as the number of
+#                               letters shared with the previous word, the remaining letter
+#                               indices and a 0
+#
+#*******************************************************************************************
+
+import argparse
+import fnmatch
+import os
+import struct
+import sys
+import zlib
+
+PACK_MAGIC = b"WGPK"
+PACK_VERSION = 1
+PACK_ALIGNMENT = 16
+PACK_FLAG_DEFLATE = 0x1
+
+HEADER = struct.Struct("<4sIII")
+ENTRY = struct.Struct("<IIIIII")
+
+DICTIONARY_MAGIC = b"WGDI"
+DICTIONARY_VERSION = 1
+
+# Only keep the compressed data when it saves at least this much
+MIN_SAVING = 0.9
+
+
+def align(value):
+    return (value + PACK_ALIGNMENT - 1) // PACK_ALIGNMENT * PACK_ALIGNMENT
+
+
+def deflate(data):
+    compressor = zlib.compressobj(9, zlib.DEFLATED, -15)
+    return compressor.compress(data) + compressor.flush()
+
+
+def binary_dictionary(data):
+    words = sorted(w for w in data.decode("utf-8").splitlines() if w)
+    alphabet = sorted(set("".join(words)))
+    if len(alphabet) > 63:
+        sys.exit("Alphabet has more than 63 letters")
+    index = {c: i + 1 for i, c in enumerate(alphabet)}
+    letters = bytearray()
+    previous = ""
+    for word in words:
+        shared = 0
+        while shared < min(len(word), len(previous), 255) and word[shared] == previous[shared]:
+            shared += 1
+        letters.append(shared)
+        letters.extend(index[c] for c in word[shared:])
+        letters.append(0)
+        previous = word
+    result = DICTIONARY_MAGIC + struct.pack("<II", DICTIONARY_VERSION, len(alphabet))
+    result += struct.pack(f"<{len(alphabet)}I", *(ord(c) for c in alphabet))
+    result += struct.pack("<II", len(words), len(letters))
+    return result + bytes(letters)
+
+
+def collect(sources, excludes):
+    files = {}
+    for source in sources:
+        prefix, _, directory = source.partition("=")
+        if not directory:
+            sys.exit(f"Invalid source '{source}', expected prefix=directory")
+        for root, _, names in os.walk(directory):
+            for name in names:
+                if any(fnmatch.fnmatch(name, pattern) for pattern in excludes):
+                    continue
+                path = os.path.join(root, name)
+                relative = os.path.relpath(path, directory).replace(os.sep, "/")
+                files[f"{prefix}/{relative}"] = path
+    return files
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Pack game resources into one archive")
+    parser.add_argument("-o", "--output", required=True)
+    parser.add_argument("--exclude", action="append", default=[], help="file name pattern to leave out")
+    parser.add_argument("--binary-dictionary", action="store_true", help="store words.txt as words.wgd")
+    parser.add_argument("sources", nargs="+", help="prefix=directory, files are stored as prefix/relative/path")
+    args = parser.parse_args()
+
+    files = collect(args.sources, args.exclude)
+    converted = {}
+    if args.binary_dictionary:
+        for name in [n for n in files if n.endswith("/words.txt")]:
+            converted[name[:-len(".txt")] + ".wgd"] = files.pop(name)
+        files.update(converted)
+    names = sorted(files.keys(), key=lambda n: n.encode("utf-8"))
+
+    entries = []
+    blobs = []
+    for name in names:
+        with open(files[name], "rb") as f:
+            data = f.read()
+        if name in converted:
+            data = binary_dictionary(data)
+        flags = 0
+        stored = data
+        packed = deflate(data)
+        if len(packed) < len(data) * MIN_SAVING:
+            flags = PACK_FLAG_DEFLATE
+            stored = packed
+        entries.append((name.encode("utf-8"), flags, len(stored), len(data)))
+        blobs.append(stored)
+
+    names_offset = HEADER.size + ENTRY.size * len(entries)
+    name_table = b"".join(e[0] for e in entries)
+    data_offset = align(names_offset + len(name_table))
+
+    header = HEADER.pack(PACK_MAGIC, PACK_VERSION, len(entries), names_offset)
+    table = b""
+    name_offset = 0
+    offset = data_offset
+    offsets = []
+    for name, flags, stored_size, size in entries:
+        table += ENTRY.pack(name_offset, len(name), flags, offset, stored_size, size)
+        offsets.append(offset)
+        name_offset += len(name)
+        offset = align(offset + stored_size)
+
+    with open(args.output, "wb") as out:
+        out.write(header)
+        out.write(table)
+        out.write(name_table)
+        for blob, offset in zip(blobs, offsets):
+            out.write(b"\0" * (offset - out.tell()))
+            out.write(blob)
+        file_size = out.tell()
+
+    total_size = 0
+    total_stored = 0
+    print(f"{'asset':<48} {'size':>10} {'stored':>10}")
+    for name, flags, stored_size, size in entries:
+        mark = " deflate" if flags & PACK_FLAG_DEFLATE else ""
+        print(f"{name.decode('utf-8'):<48} {size:>10} {stored_size:>10}{mark}")
+        total_size += size
+        total_stored += stored_size
+    print(f"{'total (' + str(len(entries)) + ' entries)':<48} {total_size:>10} {total_stored:>10}")
+    print(f"Wrote {args.output} ({file_size} bytes)")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,42 @@
+#!/usr/bin/env python3
+#*******************************************************************************************
+#
+#   WordGrid
+#   Simple Word Puzzle Game
+#   (C) Harald Scheirich 2024
+#   WordGrid is is licensed under an unmodified zlib/libpng license see LICENSE
+#
+#   Prints the size of every file the web build serves, raw and as sent with gzip
+#   usage: payload_report.py <web build directory>
+#
+#*******************************************************************************************
+
+import gzip
+import os
+import sys
+
+SERVED = (".html", ".js", ".wasm", ".data", ".wgpak")
+
+
+def main():
+    if len(sys.argv) != 2:
+        sys.exit(f"usage: {sys.argv[0]} <web build directory>")
+    directory = sys.argv[1]
+
+    total_size = 0
+    total_gzip = 0
+    print(f"{'payload':<32} {'size':>10} {'gzip':>10}")
+    for name in sorted(os.listdir(directory)):
+        if not name.endswith(SERVED):
+            continue
+        with open(os.path.join(directory, name), "rb") as f:
+            data = f.read()
+        compressed = len(gzip.compress(data, 9))
+        print(f"{name:<32} {len(data):>10} {compressed:>10}")
+        total_size += len(data)
+        total_gzip += compressed
+    print(f"{'total':<32} {total_size:>10} {total_gzip:>10}")
+
+
+if __name__ == "__main__":
+    main()